@@ -0,0 +1,136 @@
+/**
+ * @file bench_util.cpp
+ * @brief Allocation counting replacement operator new/delete and latency histogram for
+ *        benchmarks.
+ * @author xiaokui.hu
+ * @date 2025-06-02
+ * @version 1.0.0
+ */
+
+#include "bench_util.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+thread_local std::uint64_t t_allocations = 0;
+std::atomic<std::uint64_t> g_allocations{0};
+
+void* CountedAlloc(std::size_t size) {
+  ++t_allocations;
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  void* ptr = std::malloc(size == 0 ? 1 : size);
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void* CountedAlignedAlloc(std::size_t size, std::align_val_t align) {
+  ++t_allocations;
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  std::size_t alignment = static_cast<std::size_t>(align);
+  std::size_t rounded = (size + alignment - 1) / alignment * alignment;
+  void* ptr = std::aligned_alloc(alignment, rounded == 0 ? alignment : rounded);
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+}  // namespace
+
+namespace smf {
+namespace bench {
+
+std::uint64_t ThreadAllocations() { return t_allocations; }
+
+std::uint64_t TotalAllocations() { return g_allocations.load(std::memory_order_relaxed); }
+
+int LatencyHistogram::BucketIndex(std::uint64_t value) {
+  // 小于 kSubBuckets 的值各占一个桶；其余按最高位分段，取最高位之后的 kSubBucketBits 位作为段内下标
+  if (value < static_cast<std::uint64_t>(kSubBuckets)) {
+    return static_cast<int>(value);
+  }
+  int msb = 63 - __builtin_clzll(value);
+  int shift = msb - kSubBucketBits;
+  int sub = static_cast<int>((value >> shift) & (kSubBuckets - 1));
+  return (shift + 1) * kSubBuckets + sub;
+}
+
+std::uint64_t LatencyHistogram::BucketUpperBound(int index) {
+  if (index < kSubBuckets) {
+    return static_cast<std::uint64_t>(index);
+  }
+  int shift = index / kSubBuckets - 1;
+  std::uint64_t sub = static_cast<std::uint64_t>(index % kSubBuckets);
+  return ((kSubBuckets + sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::Record(std::int64_t nanos) {
+  if (nanos < 0) {
+    nanos = 0;
+  }
+  ++buckets_[BucketIndex(static_cast<std::uint64_t>(nanos))];
+  min_ = count_ ? std::min(min_, nanos) : nanos;
+  max_ = std::max(max_, nanos);
+  sum_ += nanos;
+  ++count_;
+}
+
+void LatencyHistogram::Reset() { *this = LatencyHistogram(); }
+
+double LatencyHistogram::Mean() const {
+  return count_ ? static_cast<double>(sum_ / count_) : 0.0;
+}
+
+std::int64_t LatencyHistogram::Percentile(double percentile) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  auto rank = static_cast<std::uint64_t>(percentile / 100.0 * static_cast<double>(count_));
+  rank = std::min<std::uint64_t>(std::max<std::uint64_t>(rank, 1), count_);
+  std::uint64_t seen = 0;
+  for (int i = 0; i < static_cast<int>(buckets_.size()); ++i) {
+    seen += buckets_[i];
+    if (seen >= rank) {
+      // 桶上界可能超过实际最大值，以最大值为准
+      return std::min<std::int64_t>(static_cast<std::int64_t>(BucketUpperBound(i)), max_);
+    }
+  }
+  return max_;
+}
+
+void PrintLatency(const std::string& name, const LatencyHistogram& histogram) {
+  std::printf("%-48s %12llu ops %9.0f ns mean  p50 %-8lld p90 %-8lld p99 %-8lld p99.9 %-8lld "
+              "max %lld ns\n",
+              name.c_str(), static_cast<unsigned long long>(histogram.Count()),
+              histogram.Mean(), static_cast<long long>(histogram.Percentile(50)),
+              static_cast<long long>(histogram.Percentile(90)),
+              static_cast<long long>(histogram.Percentile(99)),
+              static_cast<long long>(histogram.Percentile(99.9)),
+              static_cast<long long>(histogram.Max()));
+}
+
+}  // namespace bench
+}  // namespace smf
+
+void* operator new(std::size_t size) { return CountedAlloc(size); }
+void* operator new[](std::size_t size) { return CountedAlloc(size); }
+void* operator new(std::size_t size, std::align_val_t align) {
+  return CountedAlignedAlloc(size, align);
+}
+void* operator new[](std::size_t size, std::align_val_t align) {
+  return CountedAlignedAlloc(size, align);
+}
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
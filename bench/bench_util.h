@@ -0,0 +1,99 @@
+/**
+ * @file bench_util.h
+ * @brief Shared helpers for the state machine benchmarks.
+ * @details Provides per-thread and process-wide heap allocation counters (backed by the
+ *          replacement operator new in bench_util.cpp), a fixed-size latency histogram and a
+ *          few timing and reporting helpers. Every benchmark executable links bench_util.cpp,
+ *          see bench/CMakeLists.txt.
+ * @author xiaokui.hu
+ * @date 2025-06-02
+ * @version 1.0.0
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace smf {
+namespace bench {
+
+// 当前线程累计的堆分配次数
+std::uint64_t ThreadAllocations();
+
+// 进程累计的堆分配次数
+std::uint64_t TotalAllocations();
+
+// 统计作用域内当前线程的分配次数
+class AllocationScope {
+ public:
+  AllocationScope() : start_(ThreadAllocations()) {}
+  std::uint64_t Count() const { return ThreadAllocations() - start_; }
+
+ private:
+  std::uint64_t start_;
+};
+
+// 单调时钟纳秒
+inline std::int64_t NowNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// 输出一行结果：名称、每次操作耗时、每次操作分配次数
+inline void PrintResult(const std::string& name, std::uint64_t ops, std::int64_t nanos,
+                        std::uint64_t allocations) {
+  double ns_per_op = ops ? static_cast<double>(nanos) / static_cast<double>(ops) : 0.0;
+  double allocs_per_op =
+      ops ? static_cast<double>(allocations) / static_cast<double>(ops) : 0.0;
+  std::printf("%-48s %12llu ops %12.1f ns/op %10.3f allocs/op\n", name.c_str(),
+              static_cast<unsigned long long>(ops), ns_per_op, allocs_per_op);
+}
+
+// 延迟直方图：按 2 的幂分段，每段再等分为 kSubBuckets 个桶（相对误差不超过 1/kSubBuckets）。
+// 桶数组固定大小，Record 不分配内存，可在被测循环中调用
+class LatencyHistogram {
+ public:
+  static constexpr int kSubBucketBits = 3;
+  static constexpr int kSubBuckets = 1 << kSubBucketBits;
+
+  void Record(std::int64_t nanos);
+  void Reset();
+
+  std::uint64_t Count() const { return count_; }
+  std::int64_t Min() const { return count_ ? min_ : 0; }
+  std::int64_t Max() const { return max_; }
+  double Mean() const;
+  // 第 percentile（0~100）百分位所在桶的上界，即不超过该值的样本占比至少为 percentile
+  std::int64_t Percentile(double percentile) const;
+
+ private:
+  static int BucketIndex(std::uint64_t value);
+  static std::uint64_t BucketUpperBound(int index);
+
+  std::array<std::uint64_t, 64 * kSubBuckets> buckets_{};
+  std::uint64_t count_{0};
+  std::int64_t min_{0};
+  std::int64_t max_{0};
+  long double sum_{0};
+};
+
+// 输出一行延迟分布：样本数、平均值与 p50/p90/p99/p99.9/max（纳秒）
+void PrintLatency(const std::string& name, const LatencyHistogram& histogram);
+
+// 输出一行吞吐：每秒处理的操作数与每次操作分配次数
+inline void PrintThroughput(const std::string& name, std::uint64_t ops, std::int64_t nanos,
+                            std::uint64_t allocations) {
+  double per_second = nanos > 0 ? static_cast<double>(ops) * 1e9 / static_cast<double>(nanos) : 0;
+  double allocs_per_op =
+      ops ? static_cast<double>(allocations) / static_cast<double>(ops) : 0.0;
+  std::printf("%-48s %12llu ops %12.0f ops/s %10.3f allocs/op\n", name.c_str(),
+              static_cast<unsigned long long>(ops), per_second, allocs_per_op);
+}
+
+}  // namespace bench
+}  // namespace smf
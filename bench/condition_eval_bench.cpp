@@ -0,0 +1,140 @@
+/**
+ * @file condition_eval_bench.cpp
+ * @brief Benchmark for condition evaluation triggered by SetConditionValue.
+ * @details Every condition update makes the event handler evaluate the event definitions that
+ *          reference it (see EventHandler::TriggerEvent). This benchmark registers a callback
+ *          that evaluates all definitions on a standalone ConditionManager and measures, on the
+ *          condition thread, the heap allocations and time spent per update.
+ *          The "snapshot copy" row reproduces the previous implementation, which copied the
+ *          whole value table once per definition, as a reference point.
+ * @author xiaokui.hu
+ * @date 2025-06-02
+ * @version 1.0.0
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "bench_util.h"
+#include "components/condition_manager.h"
+#include "logger.h"
+#include "symbol_table.h"
+#include "timing_wheel.h"
+
+using namespace smf;
+
+namespace {
+
+constexpr int kConditionCount = 64;
+constexpr int kDefinitionCount = 32;
+constexpr int kConditionsPerDefinition = 4;
+constexpr int kUpdates = 20000;
+
+struct Definition {
+  std::vector<ConditionSharedPtr> conditions;
+  std::vector<ConditionExprSharedPtr> exprs;
+};
+
+struct Fixture {
+  SymbolTable symbols;
+  TimingWheel timers;
+  ConditionManager manager{&symbols, &timers};
+  std::vector<ConditionId> ids;
+  std::vector<Definition> definitions;
+
+  Fixture() {
+    std::vector<ConditionSharedPtr> conditions;
+    for (int i = 0; i < kConditionCount; ++i) {
+      auto cond = std::make_shared<Condition>();
+      cond->name = "cond_" + std::to_string(i);
+      cond->range_values = {{1, 1}};
+      cond->id = symbols.InternCondition(cond->name);
+      manager.AddCondition(cond);
+      conditions.push_back(cond);
+      ids.push_back(cond->id);
+    }
+    // 一半定义使用条件列表，一半使用条件表达式
+    for (int d = 0; d < kDefinitionCount; ++d) {
+      Definition def;
+      auto expr = std::make_shared<ConditionExpr>();
+      for (int k = 0; k < kConditionsPerDefinition; ++k) {
+        const auto& cond = conditions[(d * kConditionsPerDefinition + k) % kConditionCount];
+        if (d % 2 == 0) {
+          def.conditions.push_back(cond);
+        } else {
+          expr->conditions.push_back({cond->name, k == 1, cond->id});
+          if (k > 0) {
+            expr->operators.push_back(k == 2 ? "OR" : "AND");
+          }
+        }
+      }
+      if (d % 2 != 0) {
+        def.exprs.push_back(expr);
+      }
+      definitions.push_back(std::move(def));
+    }
+    symbols.Freeze();
+  }
+};
+
+// 运行一轮：每次条件更新在条件线程上对所有定义求值，并统计该线程的分配与耗时
+void Run(const std::string& name, bool snapshot_copy) {
+  Fixture fixture;
+  std::atomic<int> processed{0};
+  std::atomic<std::uint64_t> allocations{0};
+  std::atomic<std::int64_t> nanos{0};
+  std::vector<ConditionInfo> infos;
+  infos.reserve(kConditionsPerDefinition);
+  // 旧实现中被整体复制的按名称索引的值表
+  std::unordered_map<std::string, ConditionValue> legacy_values;
+  for (int i = 0; i < kConditionCount; ++i) {
+    legacy_values["cond_" + std::to_string(i)] = ConditionValue{};
+  }
+
+  fixture.manager.RegisterConditionChangeCallback([&](ConditionId, int, int, bool) {
+    bench::AllocationScope scope;
+    std::int64_t start = bench::NowNanos();
+    for (const auto& def : fixture.definitions) {
+      if (snapshot_copy) {
+        auto copy = legacy_values;
+        (void)copy;
+      }
+      if (!def.exprs.empty()) {
+        fixture.manager.CheckConditionExprs(def.exprs, infos);
+      } else {
+        fixture.manager.CheckConditions(def.conditions, "AND", infos);
+      }
+    }
+    nanos.fetch_add(bench::NowNanos() - start, std::memory_order_relaxed);
+    allocations.fetch_add(scope.Count(), std::memory_order_relaxed);
+    processed.fetch_add(1, std::memory_order_release);
+  });
+  fixture.manager.Start();
+
+  for (int i = 0; i < kUpdates; ++i) {
+    ConditionId id = fixture.ids[i % kConditionCount];
+    fixture.manager.SetConditionValue(id, (i / kConditionCount) % 2 == 0 ? 1 : 0);
+    // 等待条件线程处理完本次更新，避免批量合并影响每次更新的统计
+    while (processed.load(std::memory_order_acquire) <= i) {
+      std::this_thread::yield();
+    }
+  }
+  fixture.manager.Stop();
+
+  bench::PrintResult(name, kUpdates, nanos.load(), allocations.load());
+}
+
+}  // namespace
+
+int main() {
+  SMF_LOGGER_INIT(LogLevel::WARN);
+  std::printf("condition evaluation per SetConditionValue: %d conditions, %d definitions\n",
+              kConditionCount, kDefinitionCount);
+  Run("snapshot copy per definition (previous)", true);
+  Run("seqlock value table", false);
+  return 0;
+}
@@ -0,0 +1,119 @@
+/**
+ * @file condition_expr_bench.cpp
+ * @brief Benchmark for condition expression evaluation.
+ * @details Evaluates the same set of condition expressions on a standalone ConditionManager
+ *          twice: once through the interpreter, which compares operator strings and looks up
+ *          each condition's definition, and once through the program produced by
+ *          CompileConditionExpr, which works on operator enums, resolved condition IDs and
+ *          sorted, merged ranges. Both paths must agree on every result.
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @version 1.0.0
+ */
+
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "components/condition_manager.h"
+#include "logger.h"
+#include "symbol_table.h"
+#include "timing_wheel.h"
+
+using namespace smf;
+
+namespace {
+
+constexpr int kConditionCount = 64;
+constexpr int kRangesPerCondition = 8;
+constexpr int kExprCount = 64;
+constexpr int kTermsPerExpr = 5;
+constexpr int kRounds = 2000;
+
+struct Fixture {
+  SymbolTable symbols;
+  TimingWheel timers;
+  ConditionManager manager{&symbols, &timers, /*inline_execution=*/true};
+  std::vector<ConditionId> ids;
+  std::vector<std::vector<ConditionExprSharedPtr>> interpreted;
+  std::vector<std::vector<ConditionExprSharedPtr>> compiled;
+
+  Fixture() {
+    std::mt19937 rng(42);
+    for (int i = 0; i < kConditionCount; ++i) {
+      auto cond = std::make_shared<Condition>();
+      cond->name = "cond_" + std::to_string(i);
+      // 配置中的范围无序，部分重叠
+      for (int r = 0; r < kRangesPerCondition; ++r) {
+        int low = static_cast<int>(rng() % 1000);
+        cond->range_values.emplace_back(low, low + static_cast<int>(rng() % 40));
+      }
+      cond->id = symbols.InternCondition(cond->name);
+      manager.AddCondition(cond);
+      ids.push_back(cond->id);
+    }
+    for (int e = 0; e < kExprCount; ++e) {
+      ConditionExpr expr;
+      for (int t = 0; t < kTermsPerExpr; ++t) {
+        ConditionId id = ids[rng() % kConditionCount];
+        expr.conditions.push_back({symbols.GetConditionName(id), rng() % 4 == 0, id});
+        if (t > 0) {
+          expr.operators.push_back(rng() % 3 == 0 ? "OR" : "AND");
+        }
+      }
+      interpreted.push_back({std::make_shared<ConditionExpr>(expr)});
+      manager.CompileConditionExpr(expr);
+      compiled.push_back({std::make_shared<ConditionExpr>(expr)});
+    }
+    symbols.Freeze();
+    manager.Start();
+  }
+
+  ~Fixture() { manager.Stop(); }
+};
+
+// 每轮随机更新全部条件值，再对全部表达式求值；返回满足的表达式数
+std::uint64_t Run(Fixture& fixture, const std::string& name, bool use_compiled) {
+  std::mt19937 rng(7);
+  std::vector<ConditionInfo> infos;
+  infos.reserve(kTermsPerExpr);
+  const auto& exprs = use_compiled ? fixture.compiled : fixture.interpreted;
+  std::uint64_t satisfied = 0;
+  std::int64_t nanos = 0;
+  std::uint64_t allocations = 0;
+  for (int round = 0; round < kRounds; ++round) {
+    for (ConditionId id : fixture.ids) {
+      fixture.manager.SetConditionValue(id, static_cast<int>(rng() % 1000));
+    }
+    bench::AllocationScope scope;
+    std::int64_t start = bench::NowNanos();
+    for (const auto& expr : exprs) {
+      satisfied += fixture.manager.CheckConditionExprs(expr, infos) ? 1 : 0;
+    }
+    nanos += bench::NowNanos() - start;
+    allocations += scope.Count();
+  }
+  bench::PrintResult(name, static_cast<std::uint64_t>(kRounds) * kExprCount, nanos, allocations);
+  return satisfied;
+}
+
+}  // namespace
+
+int main() {
+  SMF_LOGGER_INIT(LogLevel::WARN);
+  std::printf("condition expression evaluation: %d expressions of %d terms, %d ranges each\n",
+              kExprCount, kTermsPerExpr, kRangesPerCondition);
+  Fixture fixture;
+  std::uint64_t interpreted = Run(fixture, "interpreter (previous)", false);
+  std::uint64_t compiled = Run(fixture, "compiled program", true);
+  if (interpreted != compiled) {
+    std::printf("MISMATCH: interpreter satisfied %llu, compiled satisfied %llu\n",
+                static_cast<unsigned long long>(interpreted),
+                static_cast<unsigned long long>(compiled));
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,151 @@
+/**
+ * @file condition_value_table_bench.cpp
+ * @brief Benchmark for condition value table reads.
+ * @details Compares the previous table layout, where each condition owned a 64-byte slot
+ *          holding its sequence number, value and both timestamps, with the column layout of
+ *          ConditionValueTable. Each operation reads the conditions referenced by one
+ *          five-term expression with random condition IDs: value-only reads model terms
+ *          without a duration, snapshot reads model duration terms. Both layouts must return
+ *          the same sums.
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @version 1.0.0
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "components/condition_value_table.h"
+#include "logger.h"
+
+using namespace smf;
+
+namespace {
+
+constexpr int kTermsPerExpr = 5;
+constexpr int kExprs = 4096;
+constexpr int kRepeats = 200;
+
+using Clock = std::chrono::steady_clock;
+
+// 之前的布局：每个条件一个缓存行，序号、值与两个时间戳放在一起
+class SlotTable {
+ public:
+  explicit SlotTable(size_t count) : slots_(new Slot[count]) {}
+
+  void Write(ConditionId id, const ConditionValue& v) {
+    Slot& slot = slots_[id];
+    std::uint32_t s = slot.seq.load(std::memory_order_relaxed);
+    slot.seq.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.value.store(v.value, std::memory_order_relaxed);
+    slot.last_update.store(v.lastUpdateTime.time_since_epoch().count(), std::memory_order_relaxed);
+    slot.last_changed.store(v.lastChangedTime.time_since_epoch().count(),
+                            std::memory_order_relaxed);
+    slot.seq.store(s + 2, std::memory_order_release);
+  }
+
+  int ReadValue(ConditionId id) const { return slots_[id].value.load(std::memory_order_acquire); }
+
+  void Read(ConditionId id, ConditionValue& out) const {
+    const Slot& slot = slots_[id];
+    std::uint32_t before;
+    std::uint32_t after;
+    do {
+      before = slot.seq.load(std::memory_order_acquire);
+      out.value = slot.value.load(std::memory_order_relaxed);
+      out.lastUpdateTime =
+          Clock::time_point(Clock::duration(slot.last_update.load(std::memory_order_relaxed)));
+      out.lastChangedTime =
+          Clock::time_point(Clock::duration(slot.last_changed.load(std::memory_order_relaxed)));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      after = slot.seq.load(std::memory_order_relaxed);
+    } while ((before & 1u) != 0 || before != after);
+  }
+
+ private:
+  struct alignas(64) Slot {
+    std::atomic<std::uint32_t> seq{0};
+    std::atomic<int> value{0};
+    std::atomic<Clock::rep> last_update{0};
+    std::atomic<Clock::rep> last_changed{0};
+  };
+
+  std::unique_ptr<Slot[]> slots_;
+};
+
+template <typename Fn>
+long long Measure(const std::string& name, const std::vector<ConditionId>& ids, Fn&& read) {
+  long long sum = 0;
+  bench::AllocationScope scope;
+  std::int64_t start = bench::NowNanos();
+  for (int r = 0; r < kRepeats; ++r) {
+    for (size_t i = 0; i < ids.size(); i += kTermsPerExpr) {
+      for (int t = 0; t < kTermsPerExpr; ++t) {
+        sum += read(ids[i + t]);
+      }
+    }
+  }
+  std::int64_t nanos = bench::NowNanos() - start;
+  bench::PrintResult(name, static_cast<std::uint64_t>(kRepeats) * kExprs, nanos, scope.Count());
+  return sum;
+}
+
+bool Run(int condition_count) {
+  const auto now = Clock::now();
+  SlotTable slots(condition_count);
+  ConditionValueTable columns;
+  columns.Reserve(condition_count, now);
+  for (int i = 0; i < condition_count; ++i) {
+    ConditionValue value{i % 97, now, now - std::chrono::milliseconds(i)};
+    slots.Write(static_cast<ConditionId>(i), value);
+    columns.Write(static_cast<ConditionId>(i), value);
+  }
+  std::mt19937 rng(static_cast<unsigned>(condition_count));
+  std::vector<ConditionId> ids;
+  for (int i = 0; i < kExprs * kTermsPerExpr; ++i) {
+    ids.push_back(static_cast<ConditionId>(rng() % static_cast<unsigned>(condition_count)));
+  }
+  const std::string suffix = ", " + std::to_string(condition_count) + " conditions";
+
+  bool same = Measure("value, per-condition slot (previous)" + suffix, ids,
+                      [&](ConditionId id) { return slots.ReadValue(id); }) ==
+              Measure("value, columns" + suffix, ids,
+                      [&](ConditionId id) { return columns.ReadValue(id); });
+  same &= Measure("snapshot, per-condition slot (previous)" + suffix, ids,
+                  [&](ConditionId id) {
+                    ConditionValue value;
+                    slots.Read(id, value);
+                    return (value.lastChangedTime.time_since_epoch().count() & 0xFF) +
+                           value.value;
+                  }) == Measure("snapshot, columns" + suffix, ids, [&](ConditionId id) {
+    int value = 0;
+    Clock::time_point changed;
+    columns.ReadChanged(id, value, changed);
+    return (changed.time_since_epoch().count() & 0xFF) + value;
+  });
+  return same;
+}
+
+}  // namespace
+
+int main() {
+  SMF_LOGGER_INIT(LogLevel::WARN);
+  std::printf("condition value reads per %d-term expression, random condition IDs\n",
+              kTermsPerExpr);
+  bool same = true;
+  for (int count : {64, 1024, 16384, 262144}) {
+    same &= Run(count);
+  }
+  if (!same) {
+    std::printf("MISMATCH: layouts returned different sums\n");
+    return 1;
+  }
+  return 0;
+}
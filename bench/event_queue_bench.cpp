@@ -0,0 +1,127 @@
+/**
+ * @file event_queue_bench.cpp
+ * @brief Producer scaling benchmark for the event queue implementations.
+ * @details For 1 to 32 producer threads, pushes a fixed total number of events into each
+ *          IEventQueue implementation while one consumer thread drains it, and reports the
+ *          wall-clock time per event and the aggregate throughput. The consumer drains the
+ *          queue with PopAll(). A second table repeats the run with producers emitting bursts
+ *          of kBurstSize events, once with one Push() per event and once with PushBatch().
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @version 1.0.0
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_util.h"
+#include "components/event_queue.h"
+#include "logger.h"
+
+using namespace smf;
+
+namespace {
+
+constexpr int kTotalEvents = 1 << 21;
+constexpr size_t kRingCapacity = 4096;
+constexpr int kBurstSize = 128;
+
+// burst 为 0 时逐个 Push，否则每 burst 个事件调用一次 PushBatch
+std::int64_t RunOnce(IEventQueue& queue, int producers, int burst = 0) {
+  queue.Open();
+  const int per_producer = kTotalEvents / producers;
+  const int total = per_producer * producers;
+  std::atomic<int> ready{0};
+  std::atomic_bool go{false};
+
+  std::thread consumer([&queue, total] {
+    std::vector<EventPtr> events;
+    for (int received = 0; received < total;) {
+      queue.PopAll(events);
+      received += static_cast<int>(events.size());
+      events.clear();
+    }
+  });
+
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p] {
+      // 每个生产者使用自己的事件对象，避免共享同一个引用计数
+      EventPtr event = std::make_shared<Event>("bench_event_" + std::to_string(p));
+      std::vector<EventPtr> batch(burst > 0 ? burst : 1, event);
+      ready.fetch_add(1);
+      while (!go.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+      }
+      if (burst > 0) {
+        for (int i = 0; i < per_producer; i += burst) {
+          queue.PushBatch(batch.data(), std::min(burst, per_producer - i));
+        }
+      } else {
+        for (int i = 0; i < per_producer; ++i) {
+          queue.Push(event);
+        }
+      }
+    });
+  }
+  while (ready.load() < producers) {
+    std::this_thread::yield();
+  }
+
+  std::int64_t start = bench::NowNanos();
+  go.store(true, std::memory_order_release);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  consumer.join();
+  std::int64_t nanos = bench::NowNanos() - start;
+  queue.Close();
+  return nanos;
+}
+
+}  // namespace
+
+int main() {
+  SMF_LOGGER_INIT(LogLevel::WARN);
+  std::printf("event queue producer scaling: %d events per run, ring capacity %zu\n",
+              kTotalEvents, kRingCapacity);
+  std::printf("%-10s %18s %18s %18s %18s\n", "producers", "mutex ns/event", "mutex Mev/s",
+              "lock-free ns/event", "lock-free Mev/s");
+  for (int producers : {1, 2, 4, 8, 16, 32}) {
+    const int total = kTotalEvents / producers * producers;
+    MutexEventQueue mutex_queue;
+    MpscRingEventQueue ring_queue(kRingCapacity);
+    double mutex_ns = static_cast<double>(RunOnce(mutex_queue, producers)) / total;
+    double ring_ns = static_cast<double>(RunOnce(ring_queue, producers)) / total;
+    std::printf("%-10d %18.1f %18.2f %18.1f %18.2f\n", producers, mutex_ns, 1000.0 / mutex_ns,
+                ring_ns, 1000.0 / ring_ns);
+  }
+
+  std::printf("\nbursts of %d events, ns/event: Push() per event vs PushBatch() per burst\n",
+              kBurstSize);
+  std::printf("%-10s %14s %14s %14s %14s\n", "producers", "mutex push", "mutex batch",
+              "lock-free push", "lock-free batch");
+  for (int producers : {1, 4, 16}) {
+    const int total = kTotalEvents / producers * producers;
+    double ns[4];
+    int column = 0;
+    for (bool lock_free : {false, true}) {
+      for (int burst : {0, kBurstSize}) {
+        std::unique_ptr<IEventQueue> queue;
+        if (lock_free) {
+          queue = std::make_unique<MpscRingEventQueue>(kRingCapacity);
+        } else {
+          queue = std::make_unique<MutexEventQueue>();
+        }
+        ns[column++] = static_cast<double>(RunOnce(*queue, producers, burst)) / total;
+      }
+    }
+    std::printf("%-10d %14.1f %14.1f %14.1f %14.1f\n", producers, ns[0], ns[1], ns[2], ns[3]);
+  }
+  return 0;
+}
@@ -0,0 +1,159 @@
+/**
+ * @file event_trigger_bench.cpp
+ * @brief Benchmark for event definition re-evaluation on condition updates.
+ * @details Wires the components of an inline state machine together and measures the cost of
+ *          one SetConditionValue, which synchronously re-evaluates the event definitions that
+ *          depend on the updated condition and dispatches the resulting internal event.
+ *          Each definition references three of 256 sensor conditions plus a gate condition that
+ *          stays unset, so no event fires and only evaluation is measured. The "full scan" rows
+ *          make every definition depend on the updated sensor, which is the amount of work the
+ *          previous implementation did for every update. The frame rows update 50 sensors
+ *          either one by one or with a single SetConditionValues call.
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @version 1.0.0
+ */
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench_util.h"
+#include "components/condition_manager.h"
+#include "components/event_handler.h"
+#include "components/state_manager.h"
+#include "components/transition_manager.h"
+#include "logger.h"
+#include "symbol_table.h"
+#include "timing_wheel.h"
+
+using namespace smf;
+
+namespace {
+
+constexpr int kSensorCount = 256;
+constexpr int kSensorsPerDefinition = 3;
+constexpr int kUpdates = 20000;
+constexpr int kFrameSize = 50;
+constexpr int kFrames = 2000;
+
+ConditionSharedPtr MakeCondition(SymbolTable& symbols, const std::string& name) {
+  auto cond = std::make_shared<Condition>();
+  cond->name = name;
+  cond->range_values = {{1, 1}};
+  cond->id = symbols.InternCondition(name);
+  return cond;
+}
+
+struct Fixture {
+  SymbolTable symbols;
+  TimingWheel timers;
+  TransitionManager transitions{&timers};
+  StateManager states{&symbols, &timers};
+  ConditionManager conditions{&symbols, &timers, /*inline_execution=*/true};
+  EventHandler events{&symbols,       &states, &conditions, &transitions,
+                      std::make_shared<StateEventHandler>(), nullptr, /*inline_execution=*/true};
+  std::vector<ConditionId> sensors;
+
+  // full_scan 为 true 时每个定义都引用 0 号传感器
+  Fixture(int definition_count, bool full_scan) {
+    StateInfo idle;
+    idle.name = "idle";
+    idle.id = symbols.InternState(idle.name);
+    states.AddStateInfo(idle);
+
+    for (int i = 0; i < kSensorCount; ++i) {
+      auto cond = MakeCondition(symbols, "sensor_" + std::to_string(i));
+      conditions.AddCondition(cond);
+      sensors.push_back(cond->id);
+    }
+    auto gate = MakeCondition(symbols, "gate");
+    conditions.AddCondition(gate);
+
+    for (int d = 0; d < definition_count; ++d) {
+      EventDefinition def;
+      def.name = "event_" + std::to_string(d);
+      def.trigger_mode = "edge";
+      def.conditionsOperator = "AND";
+      def.id = symbols.InternEvent(def.name);
+      def.reset_id = symbols.InternEvent(def.name + "_RESET");
+      def.flag_id = symbols.InternCondition(def.name);
+      for (int k = 0; k < kSensorsPerDefinition; ++k) {
+        int sensor = full_scan && k == 0 ? 0 : (d * kSensorsPerDefinition + k) % kSensorCount;
+        auto cond = MakeCondition(symbols, "sensor_" + std::to_string(sensor));
+        def.conditions.push_back(cond);
+      }
+      def.conditions.push_back(gate);
+      events.AddEventDefinition(def);
+    }
+    symbols.Freeze();
+
+    transitions.Start();
+    states.Start();
+    conditions.Start();
+    events.Start();
+    states.SetState(idle.id);
+  }
+
+  ~Fixture() {
+    events.Stop();
+    conditions.Stop();
+    states.Stop();
+    transitions.Stop();
+  }
+};
+
+void Run(const std::string& name, int definition_count, bool full_scan) {
+  Fixture fixture(definition_count, full_scan);
+  bench::AllocationScope scope;
+  std::int64_t start = bench::NowNanos();
+  for (int i = 0; i < kUpdates; ++i) {
+    ConditionId id = full_scan ? fixture.sensors[0] : fixture.sensors[i % kSensorCount];
+    fixture.conditions.SetConditionValue(id, i % 2 == 0 ? 1 : 0);
+  }
+  std::int64_t nanos = bench::NowNanos() - start;
+  bench::PrintResult(name, kUpdates, nanos, scope.Count());
+}
+
+// 一帧更新 kFrameSize 个传感器：逐个 SetConditionValue 与一次 SetConditionValues 对比
+void RunFrame(const std::string& name, int definition_count, bool bulk) {
+  Fixture fixture(definition_count, false);
+  std::vector<std::pair<ConditionId, int>> frame;
+  frame.reserve(kFrameSize);
+  bench::AllocationScope scope;
+  std::int64_t start = bench::NowNanos();
+  for (int f = 0; f < kFrames; ++f) {
+    frame.clear();
+    for (int k = 0; k < kFrameSize; ++k) {
+      frame.emplace_back(fixture.sensors[(f * kFrameSize + k) % kSensorCount], f % 2);
+    }
+    if (bulk) {
+      fixture.conditions.SetConditionValues(frame);
+    } else {
+      for (const auto& entry : frame) {
+        fixture.conditions.SetConditionValue(entry.first, entry.second);
+      }
+    }
+  }
+  std::int64_t nanos = bench::NowNanos() - start;
+  bench::PrintResult(name, kFrames, nanos, scope.Count());
+}
+
+}  // namespace
+
+int main() {
+  SMF_LOGGER_INIT(LogLevel::WARN);
+  std::printf("event definition re-evaluation per SetConditionValue: %d sensors, inline mode\n",
+              kSensorCount);
+  for (int count : {50, 400}) {
+    const std::string suffix = std::to_string(count) + " definitions";
+    Run("full scan, " + suffix + " (previous)", count, true);
+    Run("dependency index, " + suffix, count, false);
+  }
+  std::printf("one frame of %d condition updates (ops are frames)\n", kFrameSize);
+  RunFrame("single updates, 400 definitions (previous)", 400, false);
+  RunFrame("SetConditionValues, 400 definitions", 400, true);
+  return 0;
+}
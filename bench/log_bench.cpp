@@ -0,0 +1,157 @@
+/**
+ * @file log_bench.cpp
+ * @brief Benchmark for the cost of log statements filtered out by the log level.
+ * @details Runs with the log level set to WARN and reports:
+ *          1) a DEBUG statement whose message is built before the logger checks the level
+ *             (what every SMF_LOG* call did before the macros checked the level first) and the
+ *             same statement through SMF_LOGD;
+ *          2) the cost of processing one event that takes a transition and one condition update
+ *             that re-evaluates its event definition, on an inline state machine loaded from the
+ *             small synthetic configuration (see synthetic_config.h). Both paths contain DEBUG
+ *             and INFO statements that are filtered out at this level.
+ *          Configure with -DSMF_MIN_LOG_LEVEL=WARN to see the cost with those statements compiled
+ *          out.
+ *          3) the same two paths with the log level set to INFO, so that every transition writes a
+ *             log line, in binary mode and in text mode (console output discarded).
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @version 1.0.0
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "logger.h"
+#include "state_machine.h"
+#include "state_machine_factory.h"
+#include "synthetic_config.h"
+
+using namespace smf;
+
+namespace {
+
+constexpr int kStatements = 1000000;
+constexpr int kEvents = 200000;
+constexpr int kUpdates = 200000;
+constexpr size_t kBinaryRingSize = 32 * 1024 * 1024;
+
+// 丢弃全部输出，用于屏蔽文本模式的控制台输出
+class NullBuffer : public std::streambuf {
+ protected:
+  int overflow(int c) override { return c; }
+  std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+};
+
+// 与 EventHandler::TriggerEvent 中的调试日志相同的消息（条件名超过短字符串缓冲长度）
+const std::string kConditionName = "temperature_sensor_main";
+
+void BenchFilteredStatement() {
+  std::uint64_t allocations = bench::TotalAllocations();
+  std::int64_t start = bench::NowNanos();
+  for (int i = 0; i < kStatements; ++i) {
+    Logger::GetInstance().Log(LogLevel::DEBUG, __FILE__, __LINE__,
+                              "TriggerEvent: " + kConditionName + " " + std::to_string(i) + " " +
+                                  std::to_string(i & 1));
+  }
+  bench::PrintResult("filtered DEBUG, message built first", kStatements,
+                     bench::NowNanos() - start, bench::TotalAllocations() - allocations);
+
+  allocations = bench::TotalAllocations();
+  start = bench::NowNanos();
+  for (int i = 0; i < kStatements; ++i) {
+    SMF_LOGD("TriggerEvent: " + kConditionName + " " + std::to_string(i) + " " +
+             std::to_string(i & 1));
+  }
+  bench::PrintResult("filtered DEBUG, SMF_LOGD", kStatements, bench::NowNanos() - start,
+                     bench::TotalAllocations() - allocations);
+}
+
+bool BenchProcessEvent(const bench::SyntheticSpec& spec, const std::string& dir,
+                       const std::string& label) {
+  StateMachineOptions options;
+  options.execution = ExecutionMode::INLINE;
+  auto sm = StateMachineFactory::CreateStateMachine("log_bench", options);
+  if (!sm->Init(dir) || !sm->Start()) {
+    std::printf("failed to load %s\n", dir.c_str());
+    return false;
+  }
+  std::vector<EventPtr> events;
+  for (int e = 0; e < spec.events; ++e) {
+    events.push_back(std::make_shared<Event>(bench::AdvanceEventName(spec, e)));
+  }
+
+  // 每个推进事件都使状态机沿环前进一步；先绕环一周预热
+  int position = 0;
+  auto advance = [&](int count) {
+    for (int i = 0; i < count; ++i) {
+      sm->HandleEvent(events[position % spec.events]);
+      position = (position + 1) % spec.states;
+    }
+  };
+  advance(spec.states);
+  std::uint64_t allocations = bench::TotalAllocations();
+  std::int64_t start = bench::NowNanos();
+  advance(kEvents);
+  bench::PrintResult("ProcessEvent, transition taken" + label, kEvents, bench::NowNanos() - start,
+                     bench::TotalAllocations() - allocations);
+
+  // 条件在 0 与 1 之间切换：每次更新重新检查其边沿事件定义并生成事件
+  const std::string condition = "cond_0";
+  for (int i = 0; i < 100; ++i) {
+    sm->SetConditionValue(condition, i & 1);
+  }
+  allocations = bench::TotalAllocations();
+  start = bench::NowNanos();
+  for (int i = 0; i < kUpdates; ++i) {
+    sm->SetConditionValue(condition, i & 1);
+  }
+  bench::PrintResult("SetConditionValue, definition re-evaluated" + label, kUpdates,
+                     bench::NowNanos() - start, bench::TotalAllocations() - allocations);
+  sm->Stop();
+  return true;
+}
+
+}  // namespace
+
+int main() {
+  SMF_LOGGER_INIT(LogLevel::WARN);
+  std::printf("log level WARN, SMF_MIN_LOG_LEVEL %d\n", SMF_MIN_LOG_LEVEL);
+  BenchFilteredStatement();
+
+  const bench::SyntheticSpec spec{"small", 16, 16, 32, 2, 2};
+  const std::string dir = bench::WriteSyntheticConfig(spec);
+  if (dir.empty()) {
+    std::printf("failed to write the synthetic configuration\n");
+    return 1;
+  }
+  bool ok = BenchProcessEvent(spec, dir, "");
+
+  // INFO 级别下每次转移都输出一行日志：文本模式与二进制模式对比
+  const std::string log_file = dir + "/log_bench.log";
+  SMF_LOGGER_INIT(LogLevel::INFO);
+  SMF_LOGGER_SET_FILE(log_file);
+  std::printf("log level INFO, text and binary mode\n");
+  // 先测二进制模式：文本模式积压的待写日志会占用后台线程
+  Logger::GetInstance().SetBinaryRingSize(kBinaryRingSize);
+  SMF_LOGGER_SET_MODE(LogMode::BINARY);
+  ok = ok && BenchProcessEvent(spec, dir, " (binary)");
+  Logger::GetInstance().Flush();
+  std::printf("binary records dropped: %llu\n",
+              static_cast<unsigned long long>(Logger::GetInstance().GetDroppedRecords()));
+  SMF_LOGGER_SET_MODE(LogMode::TEXT);
+  NullBuffer null_buffer;
+  std::streambuf* console = std::cerr.rdbuf(&null_buffer);
+  ok = ok && BenchProcessEvent(spec, dir, " (text)");
+  std::cerr.rdbuf(console);
+  SMF_LOGGER_SET_FILE("");
+  Logger::GetInstance().Shutdown();
+
+  bench::RemoveSyntheticConfig(dir);
+  return ok ? 0 : 1;
+}
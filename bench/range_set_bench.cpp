@@ -0,0 +1,166 @@
+/**
+ * @file range_set_bench.cpp
+ * @brief Benchmark for range-membership checks of multi-range conditions.
+ * @details Compares the previous pair-by-pair comparison over range_values with the sorted range
+ *          set kernels (scalar, vector, binary search and the dispatching Contains) for range
+ *          sets of 1 to 512 ranges, then compares testing one value against many conditions
+ *          one by one with a single RangeSetBatch pass. Every path must agree on the number of
+ *          hits.
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @version 1.0.0
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench_util.h"
+#include "logger.h"
+#include "range_set.h"
+
+using namespace smf;
+
+namespace {
+
+constexpr int kProbes = 4096;
+constexpr int kRepeats = 200;
+constexpr int kBatchSets = 32;
+constexpr int kBatchRangesPerSet = 4;
+
+using Ranges = std::vector<std::pair<int, int>>;
+
+// 与 Condition::IsValueInRange 之前的实现相同：逐个比较 range_values
+bool PairLoop(const Ranges& ranges, int value) {
+  for (const auto& range : ranges) {
+    if (value >= range.first && value <= range.second) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// 生成互不重叠的无序范围，约一半的探测值命中
+Ranges MakeRanges(std::mt19937& rng, int count) {
+  Ranges ranges;
+  for (int i = 0; i < count; ++i) {
+    ranges.emplace_back(i * 100, i * 100 + 49);
+  }
+  std::shuffle(ranges.begin(), ranges.end(), rng);
+  return ranges;
+}
+
+template <typename Fn>
+std::uint64_t Measure(const std::string& name, const std::vector<int>& probes, Fn&& fn) {
+  std::uint64_t hits = 0;
+  bench::AllocationScope scope;
+  std::int64_t start = bench::NowNanos();
+  for (int r = 0; r < kRepeats; ++r) {
+    for (int value : probes) {
+      hits += fn(value) ? 1 : 0;
+    }
+  }
+  std::int64_t nanos = bench::NowNanos() - start;
+  bench::PrintResult(name, static_cast<std::uint64_t>(kRepeats) * probes.size(), nanos,
+                     scope.Count());
+  return hits;
+}
+
+bool RunSize(int count) {
+  std::mt19937 rng(static_cast<unsigned>(count));
+  Ranges ranges = MakeRanges(rng, count);
+  RangeSet set(ranges);
+  std::vector<int> probes;
+  for (int i = 0; i < kProbes; ++i) {
+    probes.push_back(static_cast<int>(rng() % (static_cast<unsigned>(count) * 100)));
+  }
+  const int* mins = set.Mins().data();
+  const int* maxs = set.Maxs().data();
+  const std::size_t n = set.Size();
+  const std::string suffix = ", " + std::to_string(count) + " ranges";
+
+  std::uint64_t expected = Measure("pair loop (previous)" + suffix, probes,
+                                   [&](int v) { return PairLoop(ranges, v); });
+  bool same = true;
+  same &= Measure("sorted scalar" + suffix, probes, [&](int v) {
+            return RangeSet::ContainsScalar(mins, maxs, n, v);
+          }) == expected;
+  same &= Measure(std::string("sorted ") + RangeSet::SimdKernelName() + suffix, probes, [&](int v) {
+            return RangeSet::ContainsSimd(mins, maxs, n, v);
+          }) == expected;
+  same &= Measure("binary search" + suffix, probes, [&](int v) {
+            return RangeSet::ContainsBinarySearch(mins, maxs, n, v);
+          }) == expected;
+  same &= Measure("RangeSet::Contains" + suffix, probes,
+                  [&](int v) { return set.Contains(v); }) == expected;
+  return same;
+}
+
+bool RunBatch() {
+  std::mt19937 rng(99);
+  std::vector<Ranges> ranges;
+  std::vector<RangeSet> sets;
+  RangeSetBatch batch;
+  for (int s = 0; s < kBatchSets; ++s) {
+    Ranges r;
+    for (int i = 0; i < kBatchRangesPerSet; ++i) {
+      int low = static_cast<int>(rng() % 1000);
+      r.emplace_back(low, low + static_cast<int>(rng() % 60));
+    }
+    ranges.push_back(r);
+    sets.emplace_back(r);
+    batch.Add(sets.back());
+  }
+  std::vector<int> probes;
+  for (int i = 0; i < kProbes; ++i) {
+    probes.push_back(static_cast<int>(rng() % 1000));
+  }
+  std::vector<std::uint8_t> out(batch.Size());
+  const std::string suffix = ", " + std::to_string(kBatchSets) + " conditions";
+
+  std::uint64_t expected = Measure("pair loop per condition (previous)" + suffix, probes, [&](int v) {
+    int hits = 0;
+    for (const auto& r : ranges) {
+      hits += PairLoop(r, v) ? 1 : 0;
+    }
+    return hits % 2 == 1;
+  });
+  bool same = Measure("RangeSet::Contains per condition" + suffix, probes, [&](int v) {
+                int hits = 0;
+                for (const auto& set : sets) {
+                  hits += set.Contains(v) ? 1 : 0;
+                }
+                return hits % 2 == 1;
+              }) == expected;
+  same &= Measure("RangeSetBatch" + suffix, probes, [&](int v) {
+            batch.Contains(v, out.data());
+            int hits = 0;
+            for (std::uint8_t hit : out) {
+              hits += hit;
+            }
+            return hits % 2 == 1;
+          }) == expected;
+  return same;
+}
+
+}  // namespace
+
+int main() {
+  SMF_LOGGER_INIT(LogLevel::WARN);
+  std::printf("range membership per value, vector kernel: %s\n", RangeSet::SimdKernelName());
+  bool same = true;
+  for (int count : {1, 4, 8, 16, 32, 48, 64, 128, 512}) {
+    same &= RunSize(count);
+  }
+  std::printf("one value against many conditions: %d conditions of %d ranges\n", kBatchSets,
+              kBatchRangesPerSet);
+  same &= RunBatch();
+  if (!same) {
+    std::printf("MISMATCH: kernels disagree on the number of hits\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,118 @@
+/**
+ * @file synthetic_config.cpp
+ * @brief Generator of synthetic state machine configurations for benchmarks.
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @version 1.0.0
+ */
+
+#include "synthetic_config.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#include "nlohmann-json/json.hpp"
+
+namespace smf {
+namespace bench {
+
+namespace {
+
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+std::string StateName(int index) { return "state_" + std::to_string(index); }
+
+std::string ConditionName(int index) { return "cond_" + std::to_string(index); }
+
+bool WriteJson(const fs::path& path, const json& content) {
+  std::ofstream out(path);
+  out << content.dump(2);
+  return static_cast<bool>(out);
+}
+
+// depth 项以 AND 连接的表达式。条件默认值 0 不在 [1, 1] 内：satisfied 为 true 时每项取反，
+// 表达式恒满足；否则各项不取反，表达式恒不满足
+json MakeExpr(const SyntheticSpec& spec, int depth, bool satisfied, std::mt19937& rng) {
+  json expr = json::array();
+  for (int t = 0; t < depth; ++t) {
+    if (t > 0) {
+      expr.push_back("AND");
+    }
+    std::string name = ConditionName(static_cast<int>(rng() % spec.conditions));
+    expr.push_back(satisfied ? "!" + name : name);
+  }
+  return expr;
+}
+
+}  // namespace
+
+std::string AdvanceEventName(const SyntheticSpec& spec, int index) {
+  return "event_" + std::to_string(index % spec.events);
+}
+
+std::string WriteSyntheticConfig(const SyntheticSpec& spec) {
+  std::mt19937 rng(20261016);
+  std::error_code ec;
+  fs::path dir = fs::temp_directory_path(ec) /
+                 ("smf_bench_" + spec.name + "_" + std::to_string(std::random_device{}()));
+  if (ec || !fs::create_directories(dir / "event_generate_config", ec) ||
+      !fs::create_directories(dir / "trans_config", ec)) {
+    return "";
+  }
+
+  json states = json::array();
+  for (int g = 0; g * kStatesPerGroup < spec.states; ++g) {
+    states.push_back({{"name", "group_" + std::to_string(g)}});
+  }
+  for (int i = 0; i < spec.states; ++i) {
+    states.push_back(
+        {{"name", StateName(i)}, {"parent", "group_" + std::to_string(i / kStatesPerGroup)}});
+  }
+  bool ok = WriteJson(dir / "state_config.json",
+                      {{"states", states}, {"initial_state", StateName(0)}});
+
+  auto definition = [](const std::string& event, const std::string& condition) {
+    return json{{"name", event},
+                {"trigger_mode", "edge"},
+                {"conditions", json::array({{{"name", condition}, {"range", {1, 1}}}})}};
+  };
+  for (int j = 0; j < spec.conditions && ok; ++j) {
+    ok = WriteJson(dir / "event_generate_config" / ("cond_event_" + std::to_string(j) + ".json"),
+                   definition("cond_event_" + std::to_string(j), ConditionName(j)));
+  }
+  ok = ok && WriteJson(dir / "event_generate_config" / "probe_event.json",
+                       definition("probe_event", "probe"));
+
+  for (int i = 0; i < spec.states && ok; ++i) {
+    for (int r = 0; r < spec.rules_per_state && ok; ++r) {
+      const bool advance = r == 0;
+      int to = advance ? (i + 1) % spec.states : static_cast<int>(rng() % spec.states);
+      json rule = {{"from", StateName(i)}, {"to", StateName(to)},
+                   {"event", AdvanceEventName(spec, i)}};
+      // 守卫规则至少有一项，保证不会被触发
+      int depth = advance ? spec.expr_depth : std::max(spec.expr_depth, 1);
+      if (depth > 0) {
+        rule["conditions_expr"] = json::array({MakeExpr(spec, depth, advance, rng)});
+      }
+      ok = WriteJson(dir / "trans_config" /
+                         (StateName(i) + "_rule_" + std::to_string(r) + ".json"),
+                     rule);
+    }
+  }
+  if (!ok) {
+    RemoveSyntheticConfig(dir.string());
+    return "";
+  }
+  return dir.string();
+}
+
+void RemoveSyntheticConfig(const std::string& dir) {
+  std::error_code ec;
+  fs::remove_all(dir, ec);
+}
+
+}  // namespace bench
+}  // namespace smf
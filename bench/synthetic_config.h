@@ -0,0 +1,48 @@
+/**
+ * @file synthetic_config.h
+ * @brief Generator of synthetic state machine configurations for benchmarks.
+ * @details Writes a configuration directory in the layout read by ConfigLoader
+ *          (state_config.json, event_generate_config/, trans_config/) whose size is controlled
+ *          by a SyntheticSpec: number of states, events, conditions, rules per state and the
+ *          number of terms in each transition's condition expression.
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @version 1.0.0
+ */
+
+#pragma once
+
+#include <string>
+
+namespace smf {
+namespace bench {
+
+// 合成配置的规模
+// - states 个叶子状态 state_<i>，每 kStatesPerGroup 个挂在同一个父状态 group_<k> 下，组成环
+// - 状态 i 的全部规则都监听事件 event_<i % events>：第一条推进到下一个状态，表达式恒满足；
+//   其余为守卫规则，表达式恒不满足，分发时需要逐条求值
+// - conditions 个条件 cond_<j>（范围 [1, 1]，默认值 0），各自对应一个边沿事件定义
+//   cond_event_<j>；另有探针条件 probe 与事件定义 probe_event，用于测量条件到回调的延迟
+// - 每条规则的条件表达式有 expr_depth 项（0 表示无条件）
+struct SyntheticSpec {
+  std::string name;
+  int states{16};
+  int events{16};
+  int conditions{32};
+  int expr_depth{2};
+  int rules_per_state{2};
+};
+
+constexpr int kStatesPerGroup = 8;
+
+// 状态 index 的推进事件名称
+std::string AdvanceEventName(const SyntheticSpec& spec, int index);
+
+// 在系统临时目录下生成配置并返回目录路径；失败时返回空字符串
+std::string WriteSyntheticConfig(const SyntheticSpec& spec);
+
+// 删除 WriteSyntheticConfig 生成的目录
+void RemoveSyntheticConfig(const std::string& dir);
+
+}  // namespace bench
+}  // namespace smf
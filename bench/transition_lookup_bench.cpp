@@ -0,0 +1,88 @@
+/**
+ * @file transition_lookup_bench.cpp
+ * @brief Benchmark for transition lookup in hash-map and compiled (CSR) modes.
+ * @details Builds a TransitionManager with a few hundred states and events, then looks up
+ *          random (state, event) pairs. The hash-map mode copies matching rules into a reused
+ *          vector under a shared lock; the compiled mode returns a span into the dense table.
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @version 1.0.0
+ */
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "components/transition_manager.h"
+#include "logger.h"
+
+using namespace smf;
+
+namespace {
+
+constexpr int kStateCount = 400;
+constexpr int kEventCount = 300;
+constexpr int kRulesPerState = 8;
+constexpr int kLookups = 2000000;
+
+void Populate(TransitionManager& manager) {
+  std::mt19937 rng(42);
+  for (int s = 0; s < kStateCount; ++s) {
+    for (int r = 0; r < kRulesPerState; ++r) {
+      auto rule = std::make_shared<TransitionRule>();
+      rule->from = "s" + std::to_string(s);
+      rule->to = "s" + std::to_string(rng() % kStateCount);
+      rule->from_id = static_cast<StateId>(s);
+      rule->to_id = static_cast<StateId>(rng() % kStateCount);
+      EventId event = static_cast<EventId>(rng() % kEventCount);
+      rule->events = {"e" + std::to_string(event)};
+      rule->event_ids = {event};
+      manager.AddTransition(rule);
+    }
+  }
+}
+
+void Run(const std::string& name, bool compiled) {
+  TransitionManager manager(nullptr, compiled);
+  Populate(manager);
+  manager.Start();
+
+  std::mt19937 rng(7);
+  std::vector<std::pair<StateId, EventId>> keys(4096);
+  for (auto& key : keys) {
+    key = {static_cast<StateId>(rng() % kStateCount), static_cast<EventId>(rng() % kEventCount)};
+  }
+
+  std::vector<TransitionRuleSharedPtr> rules;
+  rules.reserve(kRulesPerState);
+  std::uint64_t hits = 0;
+  bench::AllocationScope scope;
+  std::int64_t start = bench::NowNanos();
+  for (int i = 0; i < kLookups; ++i) {
+    const auto& key = keys[i & 4095];
+    if (compiled) {
+      hits += manager.FindCompiledTransitions(key.first, key.second).size();
+    } else {
+      rules.clear();
+      manager.FindTransition(key.first, key.second, rules);
+      hits += rules.size();
+    }
+  }
+  std::int64_t nanos = bench::NowNanos() - start;
+  bench::PrintResult(name + " (hits " + std::to_string(hits) + ")", kLookups, nanos,
+                     scope.Count());
+  manager.Stop();
+}
+
+}  // namespace
+
+int main() {
+  SMF_LOGGER_INIT(LogLevel::WARN);
+  std::printf("transition lookup: %d states, %d events, %d rules\n", kStateCount, kEventCount,
+              kStateCount * kRulesPerState);
+  Run("unordered_multimap + shared_mutex", false);
+  Run("compiled CSR table", true);
+  return 0;
+}
@@ -0,0 +1,100 @@
+/**
+ * @file transition_path_bench.cpp
+ * @brief Benchmark for computing the exit/enter states of a transition.
+ * @details Builds a StateManager with a tree of nested states and repeatedly asks for the
+ *          exit and enter sequences of random (from, to) pairs, either copied into the caller's
+ *          vectors (GetStateHierarchy, which is what every transition did before the cache) or
+ *          as a reference to the cached sequences (GetTransitionPath).
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @version 1.0.0
+ */
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench_util.h"
+#include "components/state_manager.h"
+#include "logger.h"
+#include "symbol_table.h"
+#include "timing_wheel.h"
+
+using namespace smf;
+
+namespace {
+
+constexpr int kBranches = 8;
+constexpr int kDepth = 4;
+constexpr int kPairs = 64;
+constexpr int kLookups = 1000000;
+
+struct Fixture {
+  SymbolTable symbols;
+  TimingWheel timers;
+  StateManager states{&symbols, &timers};
+  std::vector<StateId> leaves;
+
+  // kBranches 条分支，每条分支嵌套 kDepth 层；状态名超过短字符串缓冲长度
+  Fixture() {
+    for (int b = 0; b < kBranches; ++b) {
+      StateId parent = INVALID_SYMBOL_ID;
+      std::string parent_name;
+      for (int d = 0; d < kDepth; ++d) {
+        StateInfo info;
+        info.name = "branch_" + std::to_string(b) + "_level_" + std::to_string(d);
+        info.parent = parent_name;
+        info.parent_id = parent;
+        info.id = symbols.InternState(info.name);
+        states.AddStateInfo(info);
+        parent = info.id;
+        parent_name = info.name;
+      }
+      leaves.push_back(parent);
+    }
+    symbols.Freeze();
+    states.Start();
+  }
+
+  ~Fixture() { states.Stop(); }
+};
+
+void Run(const std::string& name, bool cached) {
+  Fixture fixture;
+  std::mt19937 rng(7);
+  std::vector<std::pair<StateId, StateId>> pairs(kPairs);
+  for (auto& pair : pairs) {
+    pair = {fixture.leaves[rng() % kBranches], fixture.leaves[rng() % kBranches]};
+  }
+  std::vector<State> exit_states;
+  std::vector<State> enter_states;
+  std::uint64_t total = 0;
+  bench::AllocationScope scope;
+  std::int64_t start = bench::NowNanos();
+  for (int i = 0; i < kLookups; ++i) {
+    const auto& pair = pairs[i % kPairs];
+    if (cached) {
+      const TransitionPath& path = fixture.states.GetTransitionPath(pair.first, pair.second);
+      total += path.exit_states.size() + path.enter_states.size();
+    } else {
+      fixture.states.GetStateHierarchy(pair.first, pair.second, exit_states, enter_states);
+      total += exit_states.size() + enter_states.size();
+    }
+  }
+  std::int64_t nanos = bench::NowNanos() - start;
+  bench::PrintResult(name + " (states " + std::to_string(total) + ")", kLookups, nanos,
+                     scope.Count());
+}
+
+}  // namespace
+
+int main() {
+  SMF_LOGGER_INIT(LogLevel::WARN);
+  std::printf("transition exit/enter states: %d branches of depth %d, %d pairs\n", kBranches,
+              kDepth, kPairs);
+  Run("GetStateHierarchy copy-out (previous)", false);
+  Run("cached path reference", true);
+  return 0;
+}
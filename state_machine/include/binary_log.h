@@ -0,0 +1,191 @@
+/**
+ * @file binary_log.h
+ * @brief Binary log record format, per-thread record ring and offline decoder
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @details This file contains the on-disk format of the binary log mode of Logger, the
+ *          single-producer single-consumer byte ring each logging thread writes its records
+ *          into, and the decoder that renders a binary log file as text. A record is a fixed
+ *          header (timestamp, level, call-site ID, thread index) followed by the raw message
+ *          bytes or the encoded arguments of an SMF_LOG record; call sites (with their format
+ *          strings) are described once per file by call-site records, so producers never format
+ *          timestamps, file names or arguments.
+ * @version 1.0.0
+ **/
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2025 xiaokui.hu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <sys/uio.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iosfwd>
+#include <memory>
+
+namespace smf {
+
+// 二进制日志文件格式（本机字节序）：
+//   文件头  kBinaryLogMagic(8 字节) + 版本号(uint32)
+//   记录    BinaryLogRecordHeader + payload，size 为包含记录头在内的总长度
+//   - CALL_SITE 记录：site_id 为调用点 ID，payload 为行号(uint32) + 文件名，
+//     SMF_LOG 的调用点另有 '\0' + 格式串
+//   - MESSAGE 记录：payload 为日志消息
+//   - MESSAGE_ARGS 记录：payload 为按 log_record.h 编码的参数，由调用点的格式串格式化
+// 同一文件中调用点记录总在引用它的消息记录之前；文件头可以再次出现（追加写入），
+// 之后的调用点 ID 重新编号
+constexpr char kBinaryLogMagic[8] = {'S', 'M', 'F', 'B', 'L', 'O', 'G', '1'};
+constexpr std::uint32_t kBinaryLogVersion = 2;
+constexpr std::size_t kBinaryLogFileHeaderSize = sizeof(kBinaryLogMagic) + sizeof(std::uint32_t);
+
+enum class BinaryLogRecordType : std::uint16_t { CALL_SITE = 1, MESSAGE = 2, MESSAGE_ARGS = 3 };
+
+struct BinaryLogRecordHeader {
+  std::uint32_t size;          // 记录总长度（含记录头）
+  std::uint16_t type;          // BinaryLogRecordType
+  std::uint8_t level;          // LogLevel
+  std::uint8_t reserved;
+  std::uint32_t site_id;       // 调用点 ID
+  std::uint32_t thread_index;  // 写入线程的序号（按首次写日志的顺序分配）
+  std::int64_t timestamp_ns;   // system_clock 纪元以来的纳秒数
+};
+static_assert(sizeof(BinaryLogRecordHeader) == 24, "binary log record header must be packed");
+
+// 单生产者单消费者字节环形缓冲区，每个写日志的线程一个。
+// - 生产者（所属线程）写入完整记录后才发布 head_，消费者看到的可读区域总由完整记录组成
+// - 空间不足时丢弃记录并计数，写日志的线程从不阻塞
+// - 消费者（Logger 的后台线程或 Flush 调用者，由 Logger 互斥）直接以 iovec 引用可读区域写盘
+class BinaryLogRing final {
+ public:
+  // capacity 向上取整为 2 的幂
+  BinaryLogRing(std::size_t capacity, std::uint32_t thread_index)
+      : capacity_(RoundUpPowerOfTwo(capacity)),
+        mask_(capacity_ - 1),
+        buffer_(new char[capacity_]),
+        thread_index_(thread_index) {}
+
+  BinaryLogRing(const BinaryLogRing&) = delete;
+  BinaryLogRing& operator=(const BinaryLogRing&) = delete;
+
+  std::uint32_t GetThreadIndex() const { return thread_index_; }
+  std::size_t GetCapacity() const { return capacity_; }
+
+  // 单条消息的最大长度，超出部分被截断，保证任何记录都能放入空的缓冲区
+  std::size_t GetMaxPayload() const { return capacity_ / 2 - sizeof(BinaryLogRecordHeader); }
+
+  // 生产者：写入一条记录，空间不足时返回 false 并计入丢弃数
+  bool TryWrite(BinaryLogRecordHeader header, const char* payload, std::size_t payload_size) {
+    if (payload_size > GetMaxPayload()) {
+      payload_size = GetMaxPayload();
+    }
+    header.size = static_cast<std::uint32_t>(sizeof(header) + payload_size);
+    const std::uint64_t head = head_.load(std::memory_order_relaxed);
+    if (capacity_ - (head - cached_tail_) < header.size) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+      if (capacity_ - (head - cached_tail_) < header.size) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+    }
+    Copy(head, &header, sizeof(header));
+    Copy(head + sizeof(header), payload, payload_size);
+    head_.store(head + header.size, std::memory_order_release);
+    return true;
+  }
+
+  // 生产者：记录一次未写入的丢弃
+  void Drop() { dropped_.fetch_add(1, std::memory_order_relaxed); }
+
+  // 消费者：取得当前可读区域（回绕时分为两段），返回填入 iov 的段数，*end 为可读区域的结束位置
+  int Peek(struct iovec iov[2], std::uint64_t* end) const {
+    const std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+    const std::uint64_t head = head_.load(std::memory_order_acquire);
+    *end = head;
+    if (head == tail) {
+      return 0;
+    }
+    const std::size_t begin = static_cast<std::size_t>(tail & mask_);
+    const std::size_t length = static_cast<std::size_t>(head - tail);
+    const std::size_t first = length < capacity_ - begin ? length : capacity_ - begin;
+    iov[0].iov_base = buffer_.get() + begin;
+    iov[0].iov_len = first;
+    if (first == length) {
+      return 1;
+    }
+    iov[1].iov_base = buffer_.get();
+    iov[1].iov_len = length - first;
+    return 2;
+  }
+
+  // 消费者：释放 Peek 返回的区域
+  void Consume(std::uint64_t end) { tail_.store(end, std::memory_order_release); }
+
+  bool IsEmpty() const {
+    return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_relaxed);
+  }
+
+  // 所属线程退出时关闭；关闭且读空的缓冲区由消费者移除
+  void Close() { closed_.store(true, std::memory_order_release); }
+  bool IsClosed() const { return closed_.load(std::memory_order_acquire); }
+
+  std::uint64_t GetDropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+ private:
+  static std::size_t RoundUpPowerOfTwo(std::size_t value) {
+    std::size_t result = 1024;
+    while (result < value) {
+      result <<= 1;
+    }
+    return result;
+  }
+
+  void Copy(std::uint64_t position, const void* data, std::size_t size) {
+    const std::size_t begin = static_cast<std::size_t>(position & mask_);
+    const std::size_t first = size < capacity_ - begin ? size : capacity_ - begin;
+    std::memcpy(buffer_.get() + begin, data, first);
+    std::memcpy(buffer_.get(), static_cast<const char*>(data) + first, size - first);
+  }
+
+  const std::size_t capacity_;
+  const std::size_t mask_;
+  std::unique_ptr<char[]> buffer_;
+  const std::uint32_t thread_index_;
+  std::atomic<bool> closed_{false};
+  std::atomic<std::uint64_t> dropped_{0};
+  // 生产者独占
+  alignas(64) std::atomic<std::uint64_t> head_{0};
+  std::uint64_t cached_tail_ = 0;
+  // 消费者独占
+  alignas(64) std::atomic<std::uint64_t> tail_{0};
+};
+
+// 将二进制日志文件渲染为与文本模式相同格式的文本（不含颜色码），json 为 true 时输出 JSON 行。
+// 遇到无法识别的数据时停止并返回 false；文件结尾处不完整的记录被忽略
+bool DecodeBinaryLog(std::istream& in, std::ostream& out, bool json = false);
+
+}  // namespace smf
@@ -39,13 +39,18 @@
 
 #pragma once
 
+#include <algorithm>
 #include <chrono>
+#include <cstdint>
+#include <limits>
 #include <map>
 #include <memory>
 #include <ostream>
 #include <string>
 #include <vector>
 
+#include "range_set.h"
+
 namespace smf {
 
 // 前向声明
@@ -59,11 +64,24 @@ inline constexpr const char* STATE_TIMEOUT_EVENT = "__STATE_TIMEOUT_EVENT__";
 // 定义状态的类型
 using State = std::string;
 
+// 符号 ID：状态、事件、条件名称在配置加载时被驻留为稠密整数 ID（见 SymbolTable）
+using SymbolId = std::uint32_t;
+using StateId = SymbolId;
+using EventId = SymbolId;
+using ConditionId = SymbolId;
+inline constexpr SymbolId INVALID_SYMBOL_ID = std::numeric_limits<SymbolId>::max();
+
+// 内部事件的固定 ID
+inline constexpr EventId INTERNAL_EVENT_ID = 0;
+inline constexpr EventId STATE_TIMEOUT_EVENT_ID = 1;
+
 // 条件类型
 struct Condition {
   std::string name;                               // 条件名称
   std::vector<std::pair<int, int>> range_values;  // 条件范围数组 [[min1, max1], [min2, max2], ...]
   int duration{0};  // 条件持续时间(毫秒),默认0表示立即生效
+  ConditionId id{INVALID_SYMBOL_ID};              // 条件 ID，由 ConfigLoader 分配
+  RangeSet range_set;  // range_values 排序合并后的结果，由 CompileRanges 生成
 
   bool operator==(const Condition& other) const noexcept {
     return name == other.name && range_values == other.range_values && duration == other.duration;
@@ -71,8 +89,14 @@ struct Condition {
 
   bool operator!=(const Condition& other) const noexcept { return !(*this == other); }
 
-  // 检查值是否在任何范围内
+  // 根据 range_values 生成 range_set；修改 range_values 后需重新调用
+  void CompileRanges() { range_set.Assign(range_values); }
+
+  // 检查值是否在任何范围内（未调用 CompileRanges 时逐个比较 range_values）
   bool IsValueInRange(int value) const noexcept {
+    if (!range_set.Empty()) {
+      return range_set.Contains(value);
+    }
     for (const auto& range : range_values) {
       if (value >= range.first && value <= range.second) {
         return true;
@@ -88,6 +112,7 @@ using ConditionSharedPtr = std::shared_ptr<Condition>;
 struct ConditionRef {
   std::string name;      // 条件名称
   bool negated{false};   // 是否取反（!A 表示 A 条件不满足）
+  ConditionId id{INVALID_SYMBOL_ID};  // 条件 ID，由 ConfigLoader 解析
 
   bool operator==(const ConditionRef& other) const noexcept {
     return name == other.name && negated == other.negated;
@@ -96,6 +121,40 @@ struct ConditionRef {
   bool operator!=(const ConditionRef& other) const noexcept { return !(*this == other); }
 };
 
+// 条件表达式中的逻辑运算符
+enum class LogicOp : std::uint8_t { AND, OR };
+
+// 编译后的条件表达式求值程序（由 ConditionManager::CompileConditionExpr 生成）
+// - 运算符为枚举，条件引用解析为条件 ID，范围与持续时间取自该条件的定义
+// - 每个条件的范围按下界排序并合并重叠区间，平铺存放在 ranges 中
+// - 求值时从左到右依次计算，不做字符串比较，也不查找条件定义
+struct ConditionProgram {
+  struct Term {
+    const std::string* name{nullptr};  // 条件名称（指向符号表，生命周期与状态机相同）
+    ConditionId id{INVALID_SYMBOL_ID};
+    int duration{0};                   // 持续时间(毫秒)，0 表示立即生效
+    std::uint32_t range_begin{0};      // 在 range_mins/range_maxs 中的起始下标
+    std::uint32_t range_end{0};        // 在 range_mins/range_maxs 中的结束下标（不含）
+    LogicOp op{LogicOp::AND};          // 与前面结果的组合方式（第一项忽略）
+    bool negated{false};
+  };
+
+  std::vector<Term> terms;
+  // 各项的范围按项顺序首尾相接，每项内部有序且互不重叠（见 RangeSet）
+  std::vector<int> range_mins;
+  std::vector<int> range_maxs;
+  bool needs_clock{false};  // 是否有持续时间条件，没有时求值不读取时钟
+
+  bool Empty() const noexcept { return terms.empty(); }
+
+  // 值是否落在 term 的某个范围内
+  bool InRange(const Term& term, int value) const noexcept {
+    return RangeSet::ContainsSorted(range_mins.data() + term.range_begin,
+                                    range_maxs.data() + term.range_begin,
+                                    term.range_end - term.range_begin, value);
+  }
+};
+
 // 条件表达式结构体，表示一个条件组合
 // 例如: "A AND B OR C" 表示为:
 //   conditions = [A, B, C]
@@ -104,6 +163,7 @@ struct ConditionRef {
 struct ConditionExpr {
   std::vector<ConditionRef> conditions;    // 条件引用列表
   std::vector<std::string> operators;      // 操作符列表 (AND/OR)，数量 = conditions.size() - 1
+  ConditionProgram program;                // 编译后的求值程序，为空时按上面两个列表解释执行
 
   bool IsValid() const noexcept {
     if (conditions.empty()) return false;
@@ -119,8 +179,35 @@ struct ConditionExpr {
 
 using ConditionExprSharedPtr = std::shared_ptr<ConditionExpr>;
 
+// 收集条件列表与条件表达式引用的条件 ID（升序去重），用于建立条件到依赖方的索引。
+// 存在未解析的条件 ID 时返回 false，此时调用方应视为依赖所有条件
+inline bool CollectConditionIds(const std::vector<ConditionSharedPtr>& conditions,
+                                const std::vector<ConditionExprSharedPtr>& condition_exprs,
+                                std::vector<ConditionId>& out) {
+  out.clear();
+  for (const auto& condition : conditions) {
+    if (!condition || condition->id == INVALID_SYMBOL_ID) {
+      return false;
+    }
+    out.push_back(condition->id);
+  }
+  for (const auto& expr : condition_exprs) {
+    if (!expr) {
+      return false;
+    }
+    for (const auto& ref : expr->conditions) {
+      if (ref.id == INVALID_SYMBOL_ID) {
+        return false;
+      }
+      out.push_back(ref.id);
+    }
+  }
+  std::sort(out.begin(), out.end());
+  out.erase(std::unique(out.begin(), out.end()), out.end());
+  return true;
+}
+
 struct ConditionValue {
-  std::string name;                                       // 条件名称
   int value;                                              // 条件值
   std::chrono::steady_clock::time_point lastUpdateTime;   // 最后一次更新时间
   std::chrono::steady_clock::time_point lastChangedTime;  // 上次变化时间
@@ -148,6 +235,9 @@ struct TransitionRule {
   std::string conditionsOperator;                      // 条件运算符 ("AND" 或 "OR")（简单模式）
   std::vector<ConditionExprSharedPtr> condition_exprs; // 复杂条件表达式列表，满足任意一个即可
   int timeout{0};  // 状态转移超时时间(毫秒)，默认0表示不超时
+  StateId from_id{INVALID_SYMBOL_ID};                  // 起始状态 ID
+  StateId to_id{INVALID_SYMBOL_ID};                    // 目标状态 ID
+  std::vector<EventId> event_ids;                      // 事件 ID 列表，与 events 一一对应
 
   // 检查是否有条件（简单模式或复杂表达式模式）
   bool HasConditions() const noexcept { 
@@ -168,12 +258,31 @@ struct TransitionRule {
 
 using TransitionRuleSharedPtr = std::shared_ptr<TransitionRule>;
 
+// 转移规则的只读视图，指向转移管理器内部的连续存储，不持有所有权
+struct TransitionRuleSpan {
+  const TransitionRuleSharedPtr* first{nullptr};
+  const TransitionRuleSharedPtr* last{nullptr};
+
+  const TransitionRuleSharedPtr* begin() const noexcept { return first; }
+  const TransitionRuleSharedPtr* end() const noexcept { return last; }
+  bool empty() const noexcept { return first == last; }
+  size_t size() const noexcept { return static_cast<size_t>(last - first); }
+};
+
+// 一次状态转移需要退出与进入的状态：exit_states 由内向外，enter_states 由外向内
+struct TransitionPath {
+  std::vector<State> exit_states;
+  std::vector<State> enter_states;
+};
+
 // 状态信息
 struct StateInfo {
   State name;                   // 状态名称
   State parent;                 // 父状态名称（可为空）
   std::vector<State> children;  // 子状态列表
   int timeout{0};               // 状态超时时间(毫秒)，默认0表示不超时
+  StateId id{INVALID_SYMBOL_ID};         // 状态 ID
+  StateId parent_id{INVALID_SYMBOL_ID};  // 父状态 ID（无父状态时为 INVALID_SYMBOL_ID）
 
   bool HasParent() const noexcept { return !parent.empty(); }
   bool HasChildren() const noexcept { return !children.empty(); }
@@ -182,7 +291,7 @@ struct StateInfo {
 
 // 状态超时信息
 struct StateTimeoutInfo {
-  State state;
+  StateId state{INVALID_SYMBOL_ID};
   int timeout;
   std::chrono::steady_clock::time_point enterTime;
   std::chrono::steady_clock::time_point expiryTime;
@@ -190,14 +299,37 @@ struct StateTimeoutInfo {
 
 // 在类定义之前添加条件更新事件结构体
 struct ConditionUpdateEvent {
-  std::string name;
+  ConditionId id;
   int value;
   std::chrono::steady_clock::time_point updateTime;
+  // 同一次批量更新（帧）中的更新条数，记录在帧内第一条上，其余为 0；单条更新为 1
+  std::uint32_t frameSize;
+};
+
+// 条件更新处理后通知给事件处理器的变化
+struct ConditionChange {
+  ConditionId id;
+  int value;
+  int duration;   // 持续时间(毫秒)，立即生效的更新为 0
+  bool inRange;   // 值是否在条件范围内
+};
+
+// 条件变化生成的 INTERNAL_EVENT 统计（自状态机创建起累计）
+struct InternalEventStats {
+  std::uint64_t posted{0};     // 实际投递的内部事件数
+  std::uint64_t coalesced{0};  // 合并到尚未处理的内部事件中的条件变化数
+  std::uint64_t skipped{0};    // 当前状态没有条件转移与挂起转移而省略的内部事件数
+};
+
+// 挂起转移统计（自状态机创建起累计）
+struct PendingTransitionStats {
+  std::uint64_t created{0};  // 新建的挂起转移数（重复挂起不计）
+  std::uint64_t expired{0};  // 超时未满足条件而被清理的挂起转移数
 };
 
 // 在ConditionUpdateEvent结构体后添加定时条件结构体
 struct DurationCondition {
-  std::string name;
+  ConditionId id;
   int value;     // 添加值字段，用于跟踪触发条件时的值
   int duration;  // 记录持续时间，单位为毫秒，用于定时器是否满足
   std::chrono::steady_clock::time_point expiryTime;
@@ -210,6 +342,9 @@ struct EventDefinition {
   std::vector<ConditionSharedPtr> conditions;          // 触发事件的条件列表（简单模式）
   std::string conditionsOperator;                      // 条件运算符 ("AND" 或 "OR")（简单模式）
   std::vector<ConditionExprSharedPtr> condition_exprs; // 复杂条件表达式列表，满足任意一个即可
+  EventId id{INVALID_SYMBOL_ID};          // 事件 ID
+  EventId reset_id{INVALID_SYMBOL_ID};    // "<name>_RESET" 事件 ID
+  ConditionId flag_id{INVALID_SYMBOL_ID}; // 与事件同名的触发标记条件 ID
   
   // 检查是否使用复杂条件表达式模式
   bool HasConditionExprs() const noexcept { return !condition_exprs.empty(); }
@@ -218,13 +353,15 @@ struct EventDefinition {
 // 添加待触发状态转移结构体
 struct PendingTransition {
   TransitionRuleSharedPtr rule;                      // 转移规则
-  std::vector<std::string> triggerEvents;            // 触发事件
+  std::vector<EventId> triggerEvents;                // 触发事件 ID
   std::chrono::steady_clock::time_point createTime;  // 创建时间
   std::chrono::steady_clock::time_point expiryTime;  // 超时时间
   std::vector<ConditionInfo> unsatisfiedConditions;  // 未满足的条件信息
   bool onTransitionInvoked{false};                   // OnTransition 回调是否已在挂起阶段触发过
   EventPtr originalEvent;  // 触发挂起时的用户事件（resume 时回调统一使用该事件，
                            // 避免回调中出现内部事件造成困惑）
+  std::uint64_t expiryTimer{0};  // 到期清理定时器（TimingWheel::TimerId），0 表示未登记
+  std::vector<ConditionId> conditionIds{};  // 规则引用的条件 ID（升序），为空时任何条件变化都重新检查
 };
 
 }  // namespace smf
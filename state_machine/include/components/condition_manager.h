@@ -39,19 +39,25 @@
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
-#include <functional>
+#include <cstdint>
 #include <mutex>
-#include <queue>
 #include <thread>
-#include <unordered_map>
+#include <vector>
 
+#include "condition_value_table.h"
 #include "i_condition_manager.h"
+#include "range_set.h"
+#include "symbol_table.h"
+#include "timing_wheel.h"
 
 namespace smf {
 
 class ConditionManager : public IConditionManager {
  public:
-  ConditionManager();
+  // 持续时间条件的定时器登记在 timer_wheel 上（由状态机持有，生命周期长于本组件）。
+  // inline_execution 为 true 时不创建条件线程：条件更新在 SetConditionValue 的调用线程上同步处理
+  ConditionManager(const SymbolTable* symbol_table, TimingWheel* timer_wheel,
+                   bool inline_execution = false);
   ~ConditionManager();
 
   // IComponent interface
@@ -61,56 +67,92 @@ class ConditionManager : public IConditionManager {
 
   // IConditionManager interface
   void SetConditionValue(const std::string& name, int value) override;
+  void SetConditionValue(ConditionId id, int value) override;
+  void SetConditionValues(const std::vector<std::pair<std::string, int>>& values) override;
+  void SetConditionValues(const std::vector<std::pair<ConditionId, int>>& values) override;
   bool CheckConditions(const std::vector<ConditionSharedPtr>& conditions, const std::string& op,
                        std::vector<ConditionInfo>& condition_infos) override;
   bool CheckConditionExprs(const std::vector<ConditionExprSharedPtr>& condition_exprs,
                            std::vector<ConditionInfo>& condition_infos) override;
+  bool CompileConditionExpr(ConditionExpr& expr) const override;
   void AddCondition(const ConditionSharedPtr& condition) override;
   bool HasCondition(const std::string& name) const override;
   void GetConditionValue(const std::string& name, int& value) const override;
+  int GetConditionValue(ConditionId id) const override;
   void RegisterConditionChangeCallback(ConditionChangeCallback callback) override;
+  void RegisterConditionFrameCallback(ConditionFrameCallback callback) override;
+  std::uint64_t GetConditionUpdateCount() const override;
 
  private:
   void ConditionLoop();
-  void TimerLoop();
   void ProcessConditionUpdates();
-  void NotifyConditionChange(const std::string& name, int value, int duration, bool meetsCondition);
-  
-  // 检查单个条件表达式
+  // 同步执行模式：处理队列中全部条件更新，直到队列为空；重入调用直接返回，由外层继续处理
+  void DrainConditionUpdates();
+  // 条件值变化时撤销该条件尚未到期的持续时间定时器，并在新值落入持续时间条件范围时重新登记
+  // （timer.duration 为 0 表示只撤销）
+  void RearmDurationTimer(const DurationCondition& timer);
+  // 持续时间定时器到期回调（在时间轮推进的线程上执行）
+  void OnDurationTimer(const DurationCondition& timer);
+  // 定时器到期后检查条件是否仍保持该值，满足则通知条件变化
+  void HandleExpiredTimer(const DurationCondition& timer);
+  void NotifyConditionChange(ConditionId id, int value, int duration, bool meetsCondition);
+  void NotifyConditionFrame(const std::vector<ConditionChange>& changes);
+  // 写入一条条件更新（调用方持有 condition_values_mutex_）。条件不存在时返回 false；
+  // 值变化时 rearm 置为 true，timer.duration 为 0 表示只需撤销旧定时器并立即通知变化
+  bool ApplyConditionUpdate(const ConditionUpdateEvent& update, DurationCondition& timer,
+                            bool& rearm, bool& in_range);
+
+  // 检查单个条件表达式，满足时匹配的条件信息追加到 condition_infos
   bool CheckSingleConditionExpr(const ConditionExprSharedPtr& expr,
-                                const std::unordered_map<std::string, ConditionValue>& values_copy,
-                                std::vector<ConditionInfo>& condition_infos);
-  
-  // 检查单个条件引用是否满足
-  bool CheckConditionRef(const ConditionRef& ref,
-                         const std::unordered_map<std::string, ConditionValue>& values_copy,
-                         ConditionInfo& info);
+                                std::vector<ConditionInfo>& condition_infos) const;
+
+  // 执行编译后的条件表达式，满足时匹配的条件信息追加到 condition_infos
+  bool RunConditionProgram(const ConditionProgram& program,
+                           std::vector<ConditionInfo>& condition_infos) const;
+
+  // 检查单个条件引用是否满足（未取反且满足时追加条件信息）
+  bool CheckConditionRef(const ConditionRef& ref, std::chrono::steady_clock::time_point now,
+                         std::vector<ConditionInfo>& condition_infos) const;
 
  private:
   std::atomic_bool running_{false};
+  const SymbolTable* symbol_table_;
+  TimingWheel* timer_wheel_;
+  const bool inline_execution_;
+  // 同步执行模式下是否正在处理条件更新（调用方已串行化，无需原子操作）
+  bool draining_{false};
 
-  // 条件相关
-  std::vector<ConditionSharedPtr> all_conditions_;
-  std::unordered_map<std::string, ConditionValue> condition_values_;
+  // 条件相关，均按条件 ID 索引
+  // 同名条件可在多个事件/转移中以不同范围定义，按定义顺序保存，启动后只读
+  std::vector<std::vector<ConditionSharedPtr>> condition_defs_;
+  // 与 condition_defs_ 一一对应的范围批量判断，range_hits_ 为其输出缓冲，
+  // 均由 condition_values_mutex_ 保护
+  std::vector<RangeSetBatch> range_batches_;
+  std::vector<std::uint8_t> range_hits_;
+  // 条件值表，读取无锁；写入由 condition_values_mutex_ 串行化
+  ConditionValueTable condition_values_;
   mutable std::mutex condition_values_mutex_;
 
-  // 条件更新队列
-  std::queue<ConditionUpdateEvent> condition_update_queue_;
+  // 条件更新队列；处理时与 processing_updates_ 整体交换，两者的容量在交换间保留，稳定后入队不再分配
+  std::vector<ConditionUpdateEvent> condition_update_queue_;
+  std::vector<ConditionUpdateEvent> processing_updates_;
   std::mutex condition_update_mutex_;
   std::condition_variable condition_update_cv_;
   std::thread condition_thread_;
 
-  std::priority_queue<DurationCondition, std::vector<DurationCondition>,
-                      std::function<bool(const DurationCondition&, const DurationCondition&)>>
-      timer_queue_{[](const DurationCondition& lhs, const DurationCondition& rhs) {
-        return lhs.expiryTime > rhs.expiryTime;
-      }};
+  // 每个条件至多一个待触发的持续时间定时器，按条件 ID 索引；值变化时旧定时器直接撤销
+  std::vector<TimingWheel::TimerId> duration_timers_;
   std::mutex timer_mutex_;
-  std::condition_variable timer_cv_;
-  std::thread timer_thread_;
+
+  // 处理一帧更新时复用的缓冲，只在处理条件更新的线程上访问
+  std::vector<DurationCondition> frame_timers_;
+  std::vector<ConditionChange> frame_changes_;
+  // 已应用的条件更新数（只在处理条件更新的线程上写入）
+  std::atomic<std::uint64_t> condition_updates_{0};
 
   // 条件变化回调
   ConditionChangeCallback condition_change_callback_;
+  ConditionFrameCallback condition_frame_callback_;
   std::mutex callback_mutex_;
 };
 
@@ -0,0 +1,198 @@
+/**
+ * @file condition_value_table.h
+ * @brief Lock-free readable condition value table
+ * @date 2025-06-02
+ * @details This file contains the definition of the ConditionValueTable class, which stores
+ *          the current value of every condition in fixed-size columns indexed by condition id:
+ *          values, change times, update times and sequence numbers each live in their own
+ *          cache-line-aligned array. Each slot is protected by a sequence lock: writers are
+ *          serialized by the caller, readers never block and only touch the slots they reference.
+ * @author xiaokui.hu
+ * @version 1.0
+ */
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2025 xiaokui.hu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "common_define.h"
+
+namespace smf {
+
+// 条件值表：按条件 ID 索引的列式存储（SoA），每个槽位使用顺序锁（seqlock）保护
+// - 按访问方式分为三列，每列按缓存行分组：
+//   值列一行容纳 16 个值，只读取值的求值路径（无持续时间的条件）在相邻 ID 间共享缓存行；
+//   快照列把序号、值的副本与变化时间放在 16 字节内，持续时间判断只访问一个缓存行（一行 4 个）；
+//   更新时间不在求值路径上，单独成列
+// - 写入方（条件线程）由调用方串行化，写入时序号先变为奇数，写完再变为偶数
+// - 读取方无锁，读取前后序号一致且为偶数即得到一致的快照，否则重试
+// - 槽位数量只能在启动前调整，运行期间表大小固定，读取不会分配内存
+class ConditionValueTable final {
+ public:
+  ConditionValueTable() = default;
+  ConditionValueTable(const ConditionValueTable&) = delete;
+  ConditionValueTable& operator=(const ConditionValueTable&) = delete;
+
+  // 扩容到至少 count 个槽位，新槽位值为 0（仅在启动前调用，不可与读取并发）
+  void Reserve(size_t count, std::chrono::steady_clock::time_point now) {
+    if (count <= size_) {
+      return;
+    }
+    ConditionValueTable grown;
+    grown.values_.Resize(count);
+    grown.stamps_.Resize(count);
+    grown.last_update_.Resize(count);
+    grown.size_ = count;
+    for (size_t i = 0; i < count; ++i) {
+      ConditionValue value{0, now, now};
+      if (i < size_) {
+        Read(static_cast<ConditionId>(i), value);
+      }
+      grown.Write(static_cast<ConditionId>(i), value);
+    }
+    values_ = std::move(grown.values_);
+    stamps_ = std::move(grown.stamps_);
+    last_update_ = std::move(grown.last_update_);
+    size_ = count;
+  }
+
+  size_t Size() const { return size_; }
+
+  bool Contains(ConditionId id) const { return id < size_; }
+
+  // 无锁读取条件值快照，id 越界时返回 false
+  bool Read(ConditionId id, ConditionValue& out) const {
+    if (id >= size_) {
+      return false;
+    }
+    const Stamp& stamp = stamps_[id];
+    std::uint32_t before;
+    std::uint32_t after;
+    do {
+      before = stamp.seq.load(std::memory_order_acquire);
+      out.value = stamp.value.load(std::memory_order_relaxed);
+      out.lastUpdateTime =
+          Clock::time_point(Clock::duration(last_update_[id].load(std::memory_order_relaxed)));
+      out.lastChangedTime =
+          Clock::time_point(Clock::duration(stamp.last_changed.load(std::memory_order_relaxed)));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      after = stamp.seq.load(std::memory_order_relaxed);
+    } while ((before & 1u) != 0 || before != after);
+    return true;
+  }
+
+  // 读取条件值与上次变化时间的一致快照，不访问更新时间列（持续时间判断使用）
+  bool ReadChanged(ConditionId id, int& value,
+                   std::chrono::steady_clock::time_point& changed) const {
+    if (id >= size_) {
+      return false;
+    }
+    const Stamp& stamp = stamps_[id];
+    std::uint32_t before;
+    std::uint32_t after;
+    do {
+      before = stamp.seq.load(std::memory_order_acquire);
+      value = stamp.value.load(std::memory_order_relaxed);
+      changed =
+          Clock::time_point(Clock::duration(stamp.last_changed.load(std::memory_order_relaxed)));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      after = stamp.seq.load(std::memory_order_relaxed);
+    } while ((before & 1u) != 0 || before != after);
+    return true;
+  }
+
+  // 仅读取条件值（单次原子读取，不需要快照一致性，只访问值列），id 越界时返回 false
+  bool Read(ConditionId id, int& value) const {
+    if (id >= size_) {
+      return false;
+    }
+    value = values_[id].load(std::memory_order_acquire);
+    return true;
+  }
+
+  // 仅读取条件值，id 越界时返回 0
+  int ReadValue(ConditionId id) const {
+    return id < size_ ? values_[id].load(std::memory_order_acquire) : 0;
+  }
+
+  // 写入条件值（调用方需保证同一时刻只有一个写入者）
+  void Write(ConditionId id, const ConditionValue& value) {
+    if (id >= size_) {
+      return;
+    }
+    Stamp& stamp = stamps_[id];
+    std::uint32_t s = stamp.seq.load(std::memory_order_relaxed);
+    stamp.seq.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    stamp.value.store(value.value, std::memory_order_relaxed);
+    last_update_[id].store(value.lastUpdateTime.time_since_epoch().count(),
+                           std::memory_order_relaxed);
+    stamp.last_changed.store(value.lastChangedTime.time_since_epoch().count(),
+                             std::memory_order_relaxed);
+    stamp.seq.store(s + 2, std::memory_order_release);
+    values_[id].store(value.value, std::memory_order_release);
+  }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  // 按缓存行分组的定长列：每个 Line 对齐到 64 字节，第 i 个元素位于第 i / kPerLine 行
+  template <typename T>
+  class Column {
+   public:
+    void Resize(size_t count) { lines_.reset(new Line[(count + kPerLine - 1) / kPerLine]()); }
+
+    T& operator[](size_t i) { return lines_[i / kPerLine].items[i % kPerLine]; }
+    const T& operator[](size_t i) const { return lines_[i / kPerLine].items[i % kPerLine]; }
+
+   private:
+    static constexpr size_t kPerLine = 64 / sizeof(T);
+    struct alignas(64) Line {
+      T items[kPerLine];
+    };
+
+    std::unique_ptr<Line[]> lines_;
+  };
+
+  // 顺序锁保护的快照：序号、值与变化时间
+  struct Stamp {
+    std::atomic<std::uint32_t> seq;
+    std::atomic<int> value;
+    std::atomic<Clock::rep> last_changed;
+  };
+
+  Column<std::atomic<int>> values_;  // 求值路径最常访问的列，与 Stamp::value 保持一致
+  Column<Stamp> stamps_;
+  Column<std::atomic<Clock::rep>> last_update_;
+  size_t size_{0};
+};
+
+}  // namespace smf
@@ -48,6 +48,7 @@
 #include "common_define.h"
 #include "i_config_loader.h"
 #include "nlohmann-json/json.hpp"
+#include "symbol_table.h"
 namespace smf {
 
 using json = nlohmann::json;
@@ -60,8 +61,11 @@ class ITransitionManager;
 
 class ConfigLoader : public IConfigLoader {
  public:
-  ConfigLoader(IStateManager* state_manager, IConditionManager* condition_manager,
-               ITransitionManager* transition_manager, IEventHandler* event_handler);
+  // load_threads 为读取并校验事件、转移配置文件的线程数，0 时使用
+  // std::thread::hardware_concurrency()，1 时在调用线程上逐个处理
+  ConfigLoader(SymbolTable* symbol_table, IStateManager* state_manager,
+               IConditionManager* condition_manager, ITransitionManager* transition_manager,
+               IEventHandler* event_handler, size_t load_threads = 0);
   ~ConfigLoader() override;
 
   // IComponent interface
@@ -94,9 +98,21 @@ class ConfigLoader : public IConfigLoader {
   bool IsValidCondition(const Condition& condition) const;
 
   // 文件操作方法
-  bool LoadJsonFile(const std::string& filePath, json& jsonData);
+  bool LoadJsonFile(const std::string& filePath, json& jsonData) const;
   std::vector<std::string> GetJsonFilesInDirectory(const std::string& dirPath);
 
+  // 已读取并校验的配置文件
+  struct LoadedConfigFile {
+    json config;
+    bool valid{false};
+  };
+  using ConfigValidator = bool (ConfigLoader::*)(const json&) const;
+
+  // 并行读取并校验 files（只读取文件、不访问各管理器与符号表），结果与 files 顺序一致；
+  // 之后由调用线程按该顺序解析并注册，注册顺序与逐个加载时相同
+  std::vector<LoadedConfigFile> LoadConfigFiles(const std::vector<std::string>& files,
+                                                ConfigValidator validate) const;
+
   // 条件解析辅助方法
   bool ParseConditionFromJson(const json& condJson, ConditionSharedPtr& outCondition,
                               const std::string& contextInfo);
@@ -113,14 +129,21 @@ class ConfigLoader : public IConfigLoader {
   // 验证条件表达式
   bool ValidateConditionExpr(const json& exprJson) const;
 
+  // 校验表达式引用的条件均已定义，解析条件 ID 并编译为求值程序
+  bool CompileConditionExprs(std::vector<ConditionExprSharedPtr>& exprs,
+                             const std::string& contextInfo);
+
  private:
+  // 符号表：加载配置时驻留所有状态、事件、条件名称
+  SymbolTable* symbol_table_;
   // 组件引用
   IStateManager* state_manager_;
   IConditionManager* condition_manager_;
   ITransitionManager* transition_manager_;
   IEventHandler* event_handler_;
-  // 状态名称
-  std::set<std::string> state_names_;
+
+  // 读取并校验配置文件的线程数（0 表示按硬件并发数）
+  size_t load_threads_;
 
   // 运行状态
   std::atomic_bool running_{false};
@@ -35,24 +35,33 @@
 
 #pragma once
 
-#include <condition_variable>
+#include <atomic>
+#include <memory>
 #include <mutex>
-#include <queue>
 #include <set>
 #include <thread>
 
+#include "event_pool.h"
+#include "event_queue.h"
 #include "i_condition_manager.h"
 #include "i_event_handler.h"
 #include "i_state_manager.h"
 #include "i_transition_manager.h"
 #include "state_event_handler.h"
+#include "symbol_table.h"
 
 namespace smf {
 
 class EventHandler : public IEventHandler {
  public:
-  EventHandler(IStateManager* state_manager, IConditionManager* condition_manager,
-               ITransitionManager* transition_manager, std::shared_ptr<StateEventHandler> state_event_handler);
+  // inline_execution 为 true 时不创建事件线程、不使用 event_queue：事件在 HandleEvent 的
+  // 调用线程上同步处理，处理过程中再投递的事件在当前事件处理完后按顺序处理。
+  // latency_metrics 为 true 时记录排队延迟与回调耗时直方图
+  EventHandler(const SymbolTable* symbol_table, IStateManager* state_manager,
+               IConditionManager* condition_manager, ITransitionManager* transition_manager,
+               std::shared_ptr<StateEventHandler> state_event_handler,
+               std::unique_ptr<IEventQueue> event_queue = nullptr, bool inline_execution = false,
+               bool latency_metrics = false);
   ~EventHandler();
 
   // IComponent interface
@@ -62,20 +71,44 @@ class EventHandler : public IEventHandler {
 
   // IEventHandler interface
   void HandleEvent(const EventPtr& event) override;
+  void HandleEvents(const EventPtr* events, size_t count) override;
   bool AddEventDefinition(const EventDefinition& event_definition) override;
+  InternalEventStats GetInternalEventStats() const override;
+  void GetMetrics(StateMachineMetrics& metrics) const override;
 
  private:
   void EventLoop();
+  // 同步执行模式：依次处理 inline_events_ 中的事件直到为空；重入调用直接返回
+  void DispatchInlineEvents();
+  // 投递事件但不结束内部事件合并（HandleEvent 与内部事件共用），入队失败时返回 false
+  bool Enqueue(const EventPtr& event);
+  // 记录 count 个事件入队：入队计数、队列深度高水位与（开启延迟统计时的）投递时刻
+  void RecordEnqueue(const EventPtr* events, size_t count, size_t depth);
+  // 开启延迟统计且设置了回调时返回回调耗时直方图，否则返回 nullptr（LatencyScope 不读时钟）
+  LatencyHistogram* CallbackHistogram(bool has_callback) {
+    return latency_metrics_ && has_callback ? &callback_duration_ : nullptr;
+  }
+  // 是否没有已投递但尚未处理完的事件
+  bool IsIdle() const;
+  // 投递条件变化生成的 INTERNAL_EVENT：没有待处理事件且当前状态既没有条件转移也没有挂起转移时
+  // 省略；已投递的 INTERNAL_EVENT 尚未处理且其后没有其他事件时，把条件追加到该事件中
+  void PostInternalEvent(std::vector<ConditionInfo>& condition_infos);
   void ProcessEvent(const EventPtr& event);
-  void TriggerEvent(const std::string& condition_name, int value, int duration,
-                    bool value_in_range);
-  void TriggerStateTimeoutEvent(const State& state, int timeout);
+  // 解析事件 ID：内部生成的事件直接使用携带的 ID，用户事件按名称查找
+  EventId ResolveEventId(const EventPtr& event) const;
+  void TriggerEvent(ConditionId condition_id, int value, int duration, bool value_in_range);
+  // 批量更新（一帧）的变化：依赖任一变化条件的事件定义各重新检查一次，只生成一个 INTERNAL_EVENT
+  void TriggerEvents(const std::vector<ConditionChange>& changes);
+  // 重新检查一个事件定义的条件，按触发模式生成事件或复位事件
+  void EvaluateEventDefinition(const EventDefinition& event_definition,
+                               std::vector<ConditionInfo>& condition_infos);
+  void TriggerStateTimeoutEvent(StateId state, int timeout);
   void PrintSatisfiedConditions(const std::vector<ConditionInfo>& condition_infos) const;
 
   // 辅助方法
   // skip_on_transition 为 true 时跳过 OnTransition 回调（用于消费挂起转移，
   // OnTransition 已在挂起创建阶段提前触发过）
-  void ExecuteTransition(const State& current_state, const TransitionRuleSharedPtr& rule,
+  void ExecuteTransition(StateId current_state, const TransitionRuleSharedPtr& rule,
                          const EventPtr& event,
                          const std::vector<ConditionInfo>& condition_infos = {},
                          bool skip_on_transition = false);
@@ -87,14 +120,61 @@ class EventHandler : public IEventHandler {
 
  private:
   std::atomic_bool running_{false};
-  std::queue<EventPtr> event_queue_;
-  std::mutex event_mutex_;
-  std::condition_variable event_cv_;
+  // 事件队列：为空时默认使用 MutexEventQueue
+  std::unique_ptr<IEventQueue> event_queue_;
   std::thread event_thread_;
 
+  // 同步执行模式：待处理事件与正在处理的批次（调用方已串行化，无需加锁）
+  const bool inline_execution_;
+  bool dispatching_{false};
+  std::vector<EventPtr> inline_events_;
+  std::vector<EventPtr> inline_batch_;
+  // 线程模式下已入队但尚未处理完的事件数
+  std::atomic<size_t> events_in_flight_{0};
+
+  // 内部事件合并：queued_internal_ 为已投递、尚未开始处理的 INTERNAL_EVENT（受 internal_mutex_
+  // 保护）；internal_at_tail_ 表示其后没有再投递其他事件，此时条件变化可以追加到其中而不改变
+  // 与其他事件的先后顺序
+  std::mutex internal_mutex_;
+  EventPtr queued_internal_;
+  std::atomic_bool internal_at_tail_{false};
+  std::atomic<std::uint64_t> internal_posted_{0};
+  std::atomic<std::uint64_t> internal_coalesced_{0};
+  std::atomic<std::uint64_t> internal_skipped_{0};
+
+  // 状态机内部生成的事件（事件定义、_RESET、INTERNAL_EVENT、状态超时）从池中按事件 ID 复用
+  EventPool event_pool_;
+  // TriggerEvent/TriggerEvents 复用的匹配条件缓冲：条件回调在 ConditionManager 的回调锁内串行执行
+  std::vector<ConditionInfo> trigger_infos_;
+  // ProcessEvent 复用的候选规则与匹配条件缓冲（事件处理不会重入）
+  std::vector<TransitionRuleSharedPtr> transition_rules_;
+  std::vector<ConditionInfo> rule_infos_;
+
+  // 运行指标：入队计数与队列深度高水位由多个生产者更新；其余只在处理事件的线程
+  // （或串行化的调用方）上写入
+  const bool latency_metrics_;
+  std::atomic<std::uint64_t> events_enqueued_{0};
+  std::atomic<std::uint64_t> events_processed_{0};
+  std::atomic<std::uint64_t> events_dropped_{0};
+  std::atomic<std::uint64_t> queue_depth_high_water_{0};
+  std::atomic<std::uint64_t> transitions_{0};
+  LatencyHistogram queue_latency_;
+  LatencyHistogram callback_duration_;
+
   std::vector<EventDefinition> event_definitions_;
+  // 条件到事件定义的倒排索引：下标为 ConditionId，值为引用该条件的 event_definitions_ 下标（升序）。
+  // 条件变化时只重新检查依赖它的事件定义
+  std::vector<std::vector<std::uint32_t>> definitions_by_condition_;
+  // 无法建立索引（无条件或条件 ID 未解析）的事件定义，任何条件变化都重新检查
+  std::vector<std::uint32_t> unindexed_definitions_;
+  // TriggerEvents 收集待检查定义时复用的缓冲（只在条件回调线程上访问）
+  std::vector<std::uint32_t> frame_definitions_;
+  std::vector<std::uint8_t> frame_marks_;
+  // ProcessEvent 中 INTERNAL_EVENT 携带的变化条件 ID（升序去重），查找挂起转移后即不再使用
+  std::vector<ConditionId> changed_conditions_;
 
   // 依赖的其他组件
+  const SymbolTable* symbol_table_;
   IStateManager* state_manager_;
   IConditionManager* condition_manager_;
   ITransitionManager* transition_manager_;
@@ -0,0 +1,127 @@
+/**
+ * @file event_queue.h
+ * @brief Event queue implementations
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @details This file contains the two event queue implementations selectable through
+ *          StateMachineOptions::event_queue:
+ *          - MutexEventQueue: unbounded queue guarded by a mutex, the original behavior. The
+ *            consumer swaps out the whole pending buffer at once.
+ *          - MpscRingEventQueue: bounded lock-free multi-producer/single-consumer ring. The
+ *            consumer parks on a condition variable only after the ring stays empty, and
+ *            producers pay for a wakeup only while the consumer is parked.
+ * @version 1.0.0
+ **/
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2025 xiaokui.hu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "i_event_queue.h"
+#include "state_machine_options.h"
+
+namespace smf {
+
+// 互斥锁 + 条件变量实现的无界队列
+// 消费者取事件时与待处理缓冲区整体交换（双缓冲），两边的容量都被复用
+class MutexEventQueue final : public IEventQueue {
+ public:
+  bool Push(const EventPtr& event) override;
+  size_t PushBatch(const EventPtr* events, size_t count) override;
+  bool PopAll(std::vector<EventPtr>& events) override;
+  void Open() override;
+  void Close() override;
+  std::uint64_t GetDroppedCount() const override { return 0; }
+
+ private:
+  std::vector<EventPtr> pending_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool closed_{false};
+};
+
+// 有界无锁多生产者单消费者环形队列（基于每个槽位的序号）
+// - 生产者通过 CAS 抢占写位置，写入后发布槽位序号；消费者只有一个，无需 CAS
+// - 消费者连续自旋仍为空时才进入休眠，生产者仅在消费者休眠时加锁唤醒
+// - 队列满时生产者让出 CPU 等待（背压）；若生产者就是消费线程本身（例如在回调中
+//   投递事件），等待会造成死锁，此时丢弃事件并计数
+class MpscRingEventQueue final : public IEventQueue {
+ public:
+  // capacity 会向上取整为 2 的幂
+  explicit MpscRingEventQueue(size_t capacity);
+  ~MpscRingEventQueue() override;
+
+  bool Push(const EventPtr& event) override;
+  size_t PushBatch(const EventPtr* events, size_t count) override;
+  bool PopAll(std::vector<EventPtr>& events) override;
+  void Open() override;
+  void Close() override;
+  std::uint64_t GetDroppedCount() const override {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+  size_t Capacity() const { return mask_ + 1; }
+
+ private:
+  struct alignas(64) Cell {
+    std::atomic<size_t> sequence{0};
+    EventPtr event;
+  };
+
+  // 一次 CAS 抢占最多 count 个连续槽位并写入，返回写入数量（0 表示队列已满）
+  size_t TryPush(const EventPtr* events, size_t count);
+  bool TryPop(EventPtr& event);
+  // 入队失败时判断是否应丢弃（队列已关闭，或生产者就是消费线程）
+  bool ShouldDrop() const;
+  // 消费者视角下队首槽位是否已发布
+  bool HasPending() const;
+  void WakeConsumer();
+
+  std::unique_ptr<Cell[]> cells_;
+  size_t mask_;
+  alignas(64) std::atomic<size_t> enqueue_pos_{0};
+  alignas(64) size_t dequeue_pos_{0};  // 仅消费者访问
+
+  // 休眠与唤醒
+  alignas(64) std::atomic_bool parked_{false};
+  std::atomic_bool closed_{false};
+  std::atomic<std::thread::id> consumer_id_{};
+  std::mutex park_mutex_;
+  std::condition_variable park_cv_;
+
+  std::atomic<std::uint64_t> dropped_{0};
+};
+
+// 按选项创建事件队列
+std::unique_ptr<IEventQueue> CreateEventQueue(const StateMachineOptions& options);
+
+}  // namespace smf
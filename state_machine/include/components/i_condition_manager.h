@@ -35,8 +35,10 @@
 
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "common_define.h"
@@ -47,7 +49,12 @@ class IConditionManager : public IComponent {
  public:
   virtual ~IConditionManager() = default;
   virtual void SetConditionValue(const std::string& name, int value) = 0;
+  virtual void SetConditionValue(ConditionId id, int value) = 0;
+  // 批量更新（一帧）：全部值写入后才通知变化，依赖这些条件的事件定义只重新检查一次
+  virtual void SetConditionValues(const std::vector<std::pair<std::string, int>>& values) = 0;
+  virtual void SetConditionValues(const std::vector<std::pair<ConditionId, int>>& values) = 0;
   virtual void GetConditionValue(const std::string& name, int& value) const = 0;
+  virtual int GetConditionValue(ConditionId id) const = 0;
   virtual bool CheckConditions(const std::vector<ConditionSharedPtr>& conditions,
                                const std::string& op, std::vector<ConditionInfo>& condition_infos) = 0;
   virtual void AddCondition(const ConditionSharedPtr& condition) = 0;
@@ -56,10 +63,19 @@ class IConditionManager : public IComponent {
   // condition_infos: 输出参数，返回满足的条件信息
   virtual bool CheckConditionExprs(const std::vector<ConditionExprSharedPtr>& condition_exprs,
                                    std::vector<ConditionInfo>& condition_infos) = 0;
+  // 将条件 ID 已解析的表达式编译为 expr.program，引用的条件须已通过 AddCondition 定义
+  virtual bool CompileConditionExpr(ConditionExpr& expr) const = 0;
   
   // 新增：注册条件变化回调
-  using ConditionChangeCallback = std::function<void(const std::string&, int, int, bool)>;
+  // 参数：条件 ID、条件值、持续时间(毫秒)、值是否在条件范围内
+  using ConditionChangeCallback = std::function<void(ConditionId, int, int, bool)>;
   virtual void RegisterConditionChangeCallback(ConditionChangeCallback callback) = 0;
+  // 注册批量更新的回调：一帧中有多个立即生效的变化时整体通知一次，
+  // 未注册时逐个调用 ConditionChangeCallback
+  using ConditionFrameCallback = std::function<void(const std::vector<ConditionChange>&)>;
+  virtual void RegisterConditionFrameCallback(ConditionFrameCallback callback) = 0;
+  // 已应用的条件更新数，可从任意线程调用
+  virtual std::uint64_t GetConditionUpdateCount() const = 0;
 };
 
 }  // namespace smf
\ No newline at end of file
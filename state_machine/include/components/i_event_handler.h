@@ -37,8 +37,12 @@
 
 #include <memory>
 
+#include <cstddef>
+
+#include "common_define.h"
 #include "event.h"
 #include "i_component.h"
+#include "state_machine_metrics.h"
 
 namespace smf {
 
@@ -46,7 +50,14 @@ class IEventHandler : public IComponent {
  public:
   virtual ~IEventHandler() = default;
   virtual void HandleEvent(const EventPtr& event) = 0;
+  // 批量投递事件，整批只做一次同步，按数组顺序处理
+  virtual void HandleEvents(const EventPtr* events, size_t count) = 0;
   virtual bool AddEventDefinition(const EventDefinition& event_definition) = 0;
+  // 条件变化生成的 INTERNAL_EVENT 的投递、合并与省略计数，可从任意线程调用
+  virtual InternalEventStats GetInternalEventStats() const = 0;
+  // 填充事件相关的指标：事件计数、队列深度高水位、转移数、内部事件统计与延迟直方图，
+  // 可从任意线程调用
+  virtual void GetMetrics(StateMachineMetrics& metrics) const = 0;
 };
 
 }  // namespace smf
\ No newline at end of file
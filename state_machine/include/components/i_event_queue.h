@@ -0,0 +1,71 @@
+/**
+ * @file i_event_queue.h
+ * @brief Interface for the event queue of the event handler
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @details This file defines the interface of the queue between event producers (user threads,
+ *          the condition thread, timer threads) and the single event processing thread.
+ *          Implementations must support any number of concurrent producers and exactly one
+ *          consumer.
+ * @version 1.0.0
+ **/
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2025 xiaokui.hu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "event.h"
+
+namespace smf {
+
+class IEventQueue {
+ public:
+  virtual ~IEventQueue() = default;
+
+  // 生产者调用（线程安全），入队失败（事件被丢弃）时返回 false
+  virtual bool Push(const EventPtr& event) = 0;
+
+  // 批量入队，整批只做一次同步与唤醒，同一批事件保持顺序；返回成功入队的数量
+  virtual size_t PushBatch(const EventPtr* events, size_t count) = 0;
+
+  // 消费者调用，阻塞直到有事件，然后一次取出当前所有待处理事件追加到 events；
+  // 队列关闭后返回 false，队列中剩余事件保留
+  virtual bool PopAll(std::vector<EventPtr>& events) = 0;
+
+  // 重新打开队列（消费线程启动前调用）
+  virtual void Open() = 0;
+
+  // 关闭队列并唤醒阻塞在 Pop 中的消费者
+  virtual void Close() = 0;
+
+  // 因队列已满而被丢弃的事件数
+  virtual std::uint64_t GetDroppedCount() const = 0;
+};
+
+}  // namespace smf
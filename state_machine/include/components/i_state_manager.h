@@ -35,6 +35,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <string>
 #include <vector>
@@ -49,13 +50,21 @@ class IStateManager : public IComponent {
  public:
   virtual ~IStateManager() = default;
   virtual bool AddStateInfo(const StateInfo& state_info) = 0;
-  virtual bool SetState(const State& state) = 0;
-  virtual State GetCurrentState() const = 0;
-  virtual std::vector<State> GetStateHierarchy(const State& state) const = 0;
-  virtual void GetStateHierarchy(const State& from, const State& to,
-                                 std::vector<State>& exit_states,
+  virtual bool SetState(StateId state) = 0;
+  // 获取当前状态名称（API 边界使用），运行时路径请使用 GetCurrentStateId。
+  // 返回符号表中驻留的名称，引用在状态机生命周期内有效
+  virtual const State& GetCurrentState() const = 0;
+  // 当前状态 ID 与状态代数均为原子变量，无锁，可从任意线程调用
+  virtual StateId GetCurrentStateId() const = 0;
+  // 状态代数：每次 SetState 后递增（在新状态发布之后），轮询方可据此判断状态是否变化
+  virtual std::uint64_t GetStateGeneration() const = 0;
+  virtual std::vector<State> GetStateHierarchy(StateId state) const = 0;
+  virtual void GetStateHierarchy(StateId from, StateId to, std::vector<State>& exit_states,
                                  std::vector<State>& enter_states) const = 0;
-  using StateTimeoutCallback = std::function<void(const State& state, int timeout)>;
+  // from -> to 的退出与进入状态序列。运行期间状态树不可修改，结果在首次查询时计算并缓存，
+  // 返回的引用在下次 AddStateInfo 前有效，转移路径上不再复制状态名
+  virtual const TransitionPath& GetTransitionPath(StateId from, StateId to) const = 0;
+  using StateTimeoutCallback = std::function<void(StateId state, int timeout)>;
   virtual void RegisterStateTimeoutCallback(StateTimeoutCallback callback) = 0;
 };
 
@@ -47,15 +47,29 @@ class ITransitionManager : public IComponent {
  public:
   virtual ~ITransitionManager() = default;
   virtual bool AddTransition(const TransitionRuleSharedPtr& rule) = 0;
-  virtual bool FindTransition(const State& current_state, const EventPtr& event,
+  virtual bool FindTransition(StateId current_state, EventId event,
                               std::vector<TransitionRuleSharedPtr>& out_rules) = 0;
   virtual void Clear() = 0;
 
+  // 是否启用编译模式（启动时将转移规则冻结为稠密表）
+  virtual bool IsCompiled() const = 0;
+  // 编译模式下查找转移规则：一次下标访问，无锁、无分配；
+  // 返回的视图在状态机停止前有效，未启用编译模式或未启动时返回空视图
+  virtual TransitionRuleSpan FindCompiledTransitions(StateId current_state,
+                                                     EventId event) const = 0;
+  // 条件变化生成的 INTERNAL_EVENT 在 state 下是否可能被处理：state 有以 INTERNAL_EVENT
+  // 触发的转移（未配置事件的条件转移），或存在挂起转移。无锁，可从任意线程调用
+  virtual bool HasConditionTransitions(StateId state) const = 0;
+
   // 待触发状态转移管理
-  virtual bool AddPendingTransition(const TransitionRuleSharedPtr& rule, const EventPtr& event,
+  // event_id 为 event 在本状态机中的事件 ID
+  virtual bool AddPendingTransition(const TransitionRuleSharedPtr& rule, EventId event_id,
+                                    const EventPtr& event,
                                     const std::vector<ConditionInfo>& unsatisfiedConditions) = 0;
-  virtual bool FindPendingTransition(const State& current_state, const EventPtr& event,
-                                     std::vector<TransitionRuleSharedPtr>& out_rules) = 0;
+  // changed_conditions 为引发 INTERNAL_EVENT 的条件 ID（升序），非空时只返回依赖其中任一条件的挂起转移
+  virtual bool FindPendingTransition(StateId current_state, EventId event,
+                                     std::vector<TransitionRuleSharedPtr>& out_rules,
+                                     const std::vector<ConditionId>& changed_conditions = {}) = 0;
   virtual void RemoveExpiredPendingTransitions() = 0;
   virtual void RemovePendingTransition(const TransitionRuleSharedPtr& rule) = 0;
   virtual void ClearPendingTransitions() = 0;
@@ -67,6 +81,8 @@ class ITransitionManager : public IComponent {
   // 获取触发该挂起转移时保存的用户原始事件；若不存在则返回 nullptr
   virtual EventPtr GetPendingTransitionOriginalEvent(
       const TransitionRuleSharedPtr& rule) const = 0;
+  // 挂起转移的新建与到期计数，可从任意线程调用
+  virtual PendingTransitionStats GetPendingTransitionStats() const = 0;
 };
 
 }  // namespace smf
\ No newline at end of file
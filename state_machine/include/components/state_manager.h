@@ -36,20 +36,25 @@
 #pragma once
 
 #include <atomic>
-#include <condition_variable>
+#include <chrono>
+#include <cstdint>
 #include <mutex>
-#include <thread>
+#include <shared_mutex>
 #include <unordered_map>
+#include <vector>
 
 #include "common_define.h"
 #include "i_event_handler.h"
 #include "i_state_manager.h"
+#include "symbol_table.h"
+#include "timing_wheel.h"
 
 namespace smf {
 
 class StateManager : public IStateManager {
  public:
-  StateManager();
+  // 状态超时定时器登记在 timer_wheel 上（由状态机持有，生命周期长于本组件）
+  StateManager(const SymbolTable* symbol_table, TimingWheel* timer_wheel);
   ~StateManager();
 
   // IComponent interface
@@ -59,29 +64,48 @@ class StateManager : public IStateManager {
 
   // IStateManager interface
   bool AddStateInfo(const StateInfo& state_info) override;
-  bool SetState(const State& state) override;
-  State GetCurrentState() const override;
-  std::vector<State> GetStateHierarchy(const State& state) const override;
-  void GetStateHierarchy(const State& from, const State& to, std::vector<State>& exit_states,
+  bool SetState(StateId state) override;
+  const State& GetCurrentState() const override;
+  StateId GetCurrentStateId() const override;
+  std::uint64_t GetStateGeneration() const override;
+  std::vector<State> GetStateHierarchy(StateId state) const override;
+  void GetStateHierarchy(StateId from, StateId to, std::vector<State>& exit_states,
                          std::vector<State>& enter_states) const override;
+  const TransitionPath& GetTransitionPath(StateId from, StateId to) const override;
   void RegisterStateTimeoutCallback(StateTimeoutCallback callback) override;
+
  private:
-  void StateTimeoutLoop();
-  void HandleStateTimeout();
+  // 为当前状态登记超时定时器（调用方持有 timeout_mutex_）
+  void ArmStateTimeoutLocked(std::chrono::steady_clock::time_point expiry);
+  // 超时定时器到期：generation 与当前一致时触发超时回调，并从本次触发时间起重新计时
+  void OnStateTimeoutTimer(std::uint64_t generation);
+  void HandleStateTimeout(StateId state, int timeout);
+  bool HasState(StateId state) const;
+  // 沿父状态链求 from -> to 的转移路径（调用方持有 state_mutex_ 或状态树不再修改）
+  void BuildTransitionPath(StateId from, StateId to, TransitionPath& path) const;
 
  private:
   std::atomic_bool running_{false};
+  const SymbolTable* symbol_table_;
+  TimingWheel* timer_wheel_;
 
-  // 状态相关
-  std::unordered_map<State, StateInfo> states_;
-  State current_state_;
+  // 状态相关，按状态 ID 索引
+  std::vector<StateInfo> states_;
   mutable std::mutex state_mutex_;
+  // 当前状态与状态代数：写入方持有 state_mutex_，读取方无锁
+  std::atomic<StateId> current_state_{INVALID_SYMBOL_ID};
+  std::atomic<std::uint64_t> state_generation_{0};
+
+  // 转移路径缓存，键为 (from << 32) | to；AddStateInfo 时清空。
+  // unordered_map 插入不会使已有元素的引用失效，命中时只持有读锁
+  mutable std::unordered_map<std::uint64_t, TransitionPath> path_cache_;
+  mutable std::shared_mutex path_mutex_;
 
-  // 状态超时相关
+  // 状态超时相关：每次切换状态 generation 递增，旧状态的定时器到期时据此识别并忽略
   StateTimeoutInfo current_state_timeout_;
+  TimingWheel::TimerId timeout_timer_{TimingWheel::INVALID_TIMER_ID};
+  std::uint64_t timeout_generation_{0};
   std::mutex timeout_mutex_;
-  std::condition_variable timeout_cv_;
-  std::thread timeout_thread_;
 
   // 状态超时回调
   StateTimeoutCallback state_timeout_callback_;
@@ -35,18 +35,23 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <mutex>
 #include <shared_mutex>
 #include <unordered_map>
 #include <vector>
 
 #include "i_transition_manager.h"
+#include "timing_wheel.h"
 
 namespace smf {
 
 class TransitionManager : public ITransitionManager {
  public:
-  TransitionManager();
+  // 挂起转移到期后由 timer_wheel 上的定时器清理（为 nullptr 时只在查找与添加时跳过/清理过期项）。
+  // compiled 为 true 时，Start() 会把转移规则编译为 CSR 稠密表，运行期间不可修改
+  explicit TransitionManager(TimingWheel* timer_wheel = nullptr, bool compiled = false);
   ~TransitionManager() override;
 
   // IComponent interface
@@ -56,15 +61,21 @@ class TransitionManager : public ITransitionManager {
 
   // ITransitionManager interface
   bool AddTransition(const TransitionRuleSharedPtr& rule) override;
-  bool FindTransition(const State& current_state, const EventPtr& event,
+  bool FindTransition(StateId current_state, EventId event,
                       std::vector<TransitionRuleSharedPtr>& out_rules) override;
   void Clear() override;
+  bool IsCompiled() const override;
+  TransitionRuleSpan FindCompiledTransitions(StateId current_state,
+                                             EventId event) const override;
+  bool HasConditionTransitions(StateId state) const override;
 
   // 待触发状态转移管理
-  bool AddPendingTransition(const TransitionRuleSharedPtr& rule, const EventPtr& event,
+  bool AddPendingTransition(const TransitionRuleSharedPtr& rule, EventId event_id,
+                            const EventPtr& event,
                             const std::vector<ConditionInfo>& unsatisfiedConditions) override;
-  bool FindPendingTransition(const State& current_state, const EventPtr& event,
-                             std::vector<TransitionRuleSharedPtr>& out_rules) override;
+  bool FindPendingTransition(StateId current_state, EventId event,
+                             std::vector<TransitionRuleSharedPtr>& out_rules,
+                             const std::vector<ConditionId>& changed_conditions = {}) override;
   void RemoveExpiredPendingTransitions() override;
   void RemovePendingTransition(const TransitionRuleSharedPtr& rule) override;
   void ClearPendingTransitions() override;
@@ -73,31 +84,50 @@ class TransitionManager : public ITransitionManager {
   bool IsPendingTransitionInvoked(const TransitionRuleSharedPtr& rule) const override;
   EventPtr GetPendingTransitionOriginalEvent(
       const TransitionRuleSharedPtr& rule) const override;
+  PendingTransitionStats GetPendingTransitionStats() const override;
 
  private:
-  // 使用状态ID和事件类型作为键的复合键结构
-  struct TransitionKey {
-    std::string state_id;
-    std::string event_type;
-
-    bool operator==(const TransitionKey& other) const {
-      return state_id == other.state_id && event_type == other.event_type;
-    }
-  };
-
-  // 为TransitionKey提供哈希函数
-  struct TransitionKeyHash {
-    std::size_t operator()(const TransitionKey& key) const {
-      return std::hash<std::string>()(key.state_id) ^
-             (std::hash<std::string>()(key.event_type) << 1);
-    }
-  };
+  // 使用状态ID和事件ID拼接成的 64 位整数作为键
+  using TransitionKey = std::uint64_t;
+  static TransitionKey MakeTransitionKey(StateId state, EventId event) {
+    return (static_cast<TransitionKey>(state) << 32) | event;
+  }
+
+  // 将 transitions_ 编译为 CSR 稠密表（启动时调用）
+  void CompileTransitions();
+  // 记录有 INTERNAL_EVENT 转移的状态（启动时调用）
+  void CollectConditionStates();
+
+  // 删除已过期的挂起转移并撤销其定时器（调用方持有 pending_mutex_ 写锁）
+  size_t EraseExpiredPendingLocked(std::chrono::steady_clock::time_point now);
+  // 撤销挂起转移的到期定时器
+  void CancelExpiryTimer(PendingTransition& pending);
+  // 挂起转移到期定时器回调
+  void OnPendingTransitionExpired(const TransitionRuleSharedPtr& rule);
 
   // 存储转换规则
-  std::unordered_multimap<TransitionKey, TransitionRuleSharedPtr, TransitionKeyHash> transitions_;
+  std::unordered_multimap<TransitionKey, TransitionRuleSharedPtr> transitions_;
+
+  // 编译模式：按 [state_id][event_id] 展开的 CSR 结构
+  // compiled_offsets_[state * compiled_event_count_ + event] 到下一个偏移之间为该键的规则，
+  // 规则顺序与 transitions_ 中 equal_range 的顺序一致
+  const bool compiled_;
+  size_t compiled_state_count_{0};
+  size_t compiled_event_count_{0};
+  std::vector<std::uint32_t> compiled_offsets_;
+  std::vector<TransitionRuleSharedPtr> compiled_rules_;
+
+  // 下标为 StateId，非 0 表示该状态有 INTERNAL_EVENT 转移；启动时生成，运行期间只读
+  std::vector<std::uint8_t> condition_states_;
 
   // 存储待触发状态转移
+  TimingWheel* timer_wheel_;
   std::vector<PendingTransition> pending_transitions_;
+  // pending_transitions_ 的大小（持有 pending_mutex_ 写锁时更新），供无锁查询
+  std::atomic<size_t> pending_count_{0};
+  // 挂起转移的新建与到期计数（持有 pending_mutex_ 写锁时更新）
+  std::atomic<std::uint64_t> pending_created_{0};
+  std::atomic<std::uint64_t> pending_expired_{0};
 
   // 使用共享互斥锁实现读写锁
   mutable std::shared_mutex mutex_;
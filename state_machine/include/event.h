@@ -41,6 +41,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <ostream>
@@ -49,9 +51,12 @@
 
 #include "common_define.h"
 #include "logger.h"
+#include "state_machine_metrics.h"
 
 namespace smf {
 
+class SymbolTable;
+
 class Event {
  public:
   // 默认构造函数
@@ -68,6 +73,18 @@ class Event {
   // 获取事件名称
   const std::string& GetName() const { return name_; }
 
+  // 获取事件 ID：ID 由分配它的符号表决定，scope 不匹配时返回 INVALID_SYMBOL_ID，
+  // 由调用方按名称重新解析（用户事件可以被投递到多个状态机）
+  EventId GetId(const SymbolTable* scope) const {
+    return scope == id_scope_ ? id_ : INVALID_SYMBOL_ID;
+  }
+
+  // 设置事件 ID（状态机内部生成事件时使用，避免处理时再按名称查找）
+  void SetId(EventId id, const SymbolTable* scope) {
+    id_ = id;
+    id_scope_ = scope;
+  }
+
   // 获取条件值
   const std::vector<ConditionInfo>& GetMatchedConditions() const { return matched_conditions_; }
 
@@ -85,8 +102,52 @@ class Event {
     }
   }
 
+  // 按条件名称合并：已有同名条件时更新其值与持续时间，否则追加
+  // （内部事件排队期间合并后续条件变化时使用，条目数不超过不同条件的个数，且保留最新值）
+  void MergeMatchedConditions(const std::vector<ConditionInfo>& conditions) {
+    for (const auto& condition : conditions) {
+      if (condition.name.empty() || condition.value < 0) {
+        SMF_LOGE("conditionName is empty or value is less than 0");
+        continue;
+      }
+      auto it = std::find_if(
+          matched_conditions_.begin(), matched_conditions_.end(),
+          [&condition](const ConditionInfo& info) { return info.name == condition.name; });
+      if (it != matched_conditions_.end()) {
+        it->value = condition.value;
+        it->duration = condition.duration;
+      } else {
+        matched_conditions_.push_back(condition);
+      }
+    }
+  }
+
+  // 用 conditions 覆盖已保存的条件值：逐个赋值到已有元素上，复用元素及其名称字符串的内存
+  // （事件对象被复用时使用，见 EventPool）
+  void AssignMatchedConditions(const std::vector<ConditionInfo>& conditions) {
+    size_t count = 0;
+    for (const auto& condition : conditions) {
+      if (condition.name.empty() || condition.value < 0) {
+        SMF_LOGE("conditionName is empty or value is less than 0");
+        continue;
+      }
+      if (count < matched_conditions_.size()) {
+        matched_conditions_[count] = condition;
+      } else {
+        matched_conditions_.push_back(condition);
+      }
+      ++count;
+    }
+    matched_conditions_.resize(count);
+  }
+
   void Clear() { matched_conditions_.clear(); }
 
+  // 投递到事件处理器的时刻（单调时钟纳秒），开启延迟统计时用于计算排队延迟；
+  // 同一事件对象在处理前被再次投递时以最后一次投递为准
+  void SetEnqueueTime(std::int64_t nanos) { enqueue_nanos_.Store(nanos); }
+  std::int64_t GetEnqueueTime() const { return enqueue_nanos_.Load(); }
+
   // 将事件转换为字符串（隐式转换）
   operator std::string() const { return name_; }
 
@@ -132,6 +193,9 @@ class Event {
  private:
   std::string name_;                               // 事件名称
   std::vector<ConditionInfo> matched_conditions_;  // 保存触发事件的条件的值
+  EventId id_{INVALID_SYMBOL_ID};                  // 事件 ID（仅在 id_scope_ 下有效）
+  const SymbolTable* id_scope_{nullptr};           // 分配事件 ID 的符号表
+  RelaxedAtomic<std::int64_t> enqueue_nanos_{0};  // 最近一次投递的时刻（事件线程读取）
 
   // 友元，用于实现流输出运算符
   friend std::ostream& operator<<(std::ostream& os, const Event& event);
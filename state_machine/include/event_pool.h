@@ -0,0 +1,91 @@
+/**
+ * @file event_pool.h
+ * @brief Per-state-machine pool of recycled internal events
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @details This file contains the definition of the EventPool class. Events generated by the
+ *          state machine itself (event definitions, their _RESET events, condition-change
+ *          internal events and state timeouts) are drawn from the pool by event ID. An event
+ *          whose only remaining owner is the pool is handed out again with its name, ID and
+ *          matched condition storage intact, so once every event ID has been seen, generating
+ *          an event no longer allocates.
+ * @version 1.0.0
+ **/
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2025 xiaokui.hu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "common_define.h"
+#include "event.h"
+
+namespace smf {
+
+class SymbolTable;
+
+// 按事件 ID 复用的事件对象池，每个状态机一个。
+// - 池内对象的 use_count() 回到 1（只剩池本身持有）时视为空闲，再次取出时只覆盖匹配条件
+// - 每个事件 ID 最多缓存 max_per_event 个对象，同一 ID 同时在途的事件更多时直接分配、用完即释放
+// - 用户在回调中保留的 EventPtr 会阻止对象被复用；只保留 weak_ptr 时对象可能已被复用为新的事件
+// Acquire 可从任意线程调用
+class EventPool final {
+ public:
+  static constexpr std::size_t kDefaultMaxPerEvent = 8;
+
+  explicit EventPool(const SymbolTable* symbol_table,
+                     std::size_t max_per_event = kDefaultMaxPerEvent);
+
+  EventPool(const EventPool&) = delete;
+  EventPool& operator=(const EventPool&) = delete;
+
+  // 为 symbol_table 中的全部事件 ID 预留槽位（符号表冻结后调用，之后 Acquire 不再扩容槽位表）
+  void Reserve();
+
+  // 取得名称与 ID 已设置、匹配条件为 matched_conditions 的事件
+  EventPtr Acquire(EventId id, const std::vector<ConditionInfo>& matched_conditions = {});
+
+  // 池中缓存的事件对象数
+  std::size_t Size() const;
+  // Acquire 复用已有对象的次数与新建对象的次数
+  std::uint64_t GetReusedCount() const;
+  std::uint64_t GetCreatedCount() const;
+
+ private:
+  const SymbolTable* symbol_table_;
+  const std::size_t max_per_event_;
+
+  mutable std::mutex mutex_;
+  // 下标为 EventId
+  std::vector<std::vector<EventPtr>> slots_;
+  std::uint64_t reused_{0};
+  std::uint64_t created_{0};
+};
+
+}  // namespace smf
@@ -0,0 +1,168 @@
+/**
+ * @file log_record.h
+ * @brief Typed log arguments, compile-time format checking and deferred log formatting
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @details This file contains the encoding of the arguments of SMF_LOG(level, fmt, args...)
+ *          records, the constexpr check of their "{}" format strings, and LogLineFormatter,
+ *          which renders a captured record as a text line or a JSON line. Records are captured by
+ *          value on the logging thread and formatted later by the background thread of Logger or
+ *          offline by the binary log decoder.
+ * @version 1.0.0
+ **/
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2025 xiaokui.hu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace smf {
+
+// 格式串中 "{}" 占位符的个数；"{{" 与 "}}" 输出花括号本身，其他花括号用法返回 -1
+constexpr int LogFormatArgCount(const char* format) {
+  int count = 0;
+  for (const char* p = format; *p != '\0'; ++p) {
+    if (*p == '{') {
+      if (p[1] == '{') {
+        ++p;
+      } else if (p[1] == '}') {
+        ++count;
+        ++p;
+      } else {
+        return -1;
+      }
+    } else if (*p == '}') {
+      if (p[1] != '}') {
+        return -1;
+      }
+      ++p;
+    }
+  }
+  return count;
+}
+
+// 只用于 decltype 中统计 SMF_LOG 的参数个数，不求值
+template <typename... Args>
+std::integral_constant<std::size_t, sizeof...(Args)> LogArgCount(const Args&...);
+
+// 参数编码：类型标签(1 字节) + 值；字符串为长度(uint32) + 字节，按值复制
+enum class LogArgType : std::uint8_t { INT64 = 1, UINT64, DOUBLE, BOOL, CHAR, STRING };
+
+namespace log_record_detail {
+
+inline void AppendTagged(std::string* out, LogArgType type, const void* value, std::size_t size) {
+  out->push_back(static_cast<char>(type));
+  out->append(static_cast<const char*>(value), size);
+}
+
+inline void AppendString(std::string* out, const char* data, std::size_t size) {
+  auto length = static_cast<std::uint32_t>(size);
+  AppendTagged(out, LogArgType::STRING, &length, sizeof(length));
+  out->append(data, size);
+}
+
+template <typename T>
+void AppendArg(std::string* out, const T& value) {
+  using Type = std::decay_t<T>;
+  if constexpr (std::is_same_v<Type, bool>) {
+    AppendTagged(out, LogArgType::BOOL, &value, sizeof(bool));
+  } else if constexpr (std::is_same_v<Type, char>) {
+    AppendTagged(out, LogArgType::CHAR, &value, sizeof(char));
+  } else if constexpr (std::is_enum_v<Type>) {
+    AppendArg(out, static_cast<std::underlying_type_t<Type>>(value));
+  } else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>) {
+    auto number = static_cast<std::int64_t>(value);
+    AppendTagged(out, LogArgType::INT64, &number, sizeof(number));
+  } else if constexpr (std::is_integral_v<Type>) {
+    auto number = static_cast<std::uint64_t>(value);
+    AppendTagged(out, LogArgType::UINT64, &number, sizeof(number));
+  } else if constexpr (std::is_floating_point_v<Type>) {
+    auto number = static_cast<double>(value);
+    AppendTagged(out, LogArgType::DOUBLE, &number, sizeof(number));
+  } else if constexpr (std::is_array_v<T> &&
+                       std::is_same_v<std::remove_cv_t<std::remove_extent_t<T>>, char>) {
+    // 字符数组（包括字符串字面量）不可能为空指针
+    AppendString(out, value, std::strlen(value));
+  } else if constexpr (std::is_same_v<Type, const char*> || std::is_same_v<Type, char*>) {
+    const char* text = value ? static_cast<const char*>(value) : "(null)";
+    AppendString(out, text, std::strlen(text));
+  } else if constexpr (std::is_convertible_v<const Type&, std::string_view>) {
+    std::string_view text(value);
+    AppendString(out, text.data(), text.size());
+  } else {
+    static_assert(std::is_same_v<Type, bool>,
+                  "unsupported SMF_LOG argument type: use integers, floating point, bool, char, "
+                  "enums or strings");
+  }
+}
+
+}  // namespace log_record_detail
+
+// 按值编码全部参数，追加到 out（复用 out 的容量）
+template <typename... Args>
+void EncodeLogArgs(std::string* out, const Args&... args) {
+  (log_record_detail::AppendArg(out, args), ...);
+}
+
+// 一条待格式化的日志记录；format 为空时 data 是完整的日志消息，否则是编码后的参数
+struct LogRecordView {
+  std::uint8_t level = 0;  // LogLevel
+  std::string_view file;
+  std::uint32_t line = 0;
+  std::string_view thread;
+  std::int64_t timestamp_ms = 0;  // system_clock 纪元以来的毫秒数
+  std::string_view format;
+  std::string_view data;
+};
+
+// 将记录渲染为文本行或 JSON 行（均不含换行符）。同一秒内的记录复用缓存的时间前缀，
+// 只补上毫秒；不是线程安全的，每个格式化线程使用自己的实例
+class LogLineFormatter final {
+ public:
+  // 文本行："[HH:MM:SS.mmm] [LEVEL] [file:line - thread] message"，color 为 true 时带 ANSI 颜色码
+  void AppendText(std::string* out, const LogRecordView& record, bool color);
+
+  // JSON 行：time/level/file/line/thread/message；带格式串的记录另有 format 与按类型输出的 args
+  void AppendJson(std::string* out, const LogRecordView& record);
+
+  // 只输出格式化后的消息；参数编码无法解析时返回 false，已输出的部分保留
+  static bool AppendMessage(std::string* out, const LogRecordView& record);
+
+ private:
+  void UpdateTime(std::int64_t timestamp_ms);
+
+  std::int64_t second_ = -1;
+  char date_[11] = {};  // YYYY-MM-DD
+  char time_[9] = {};   // HH:MM:SS
+  std::string message_;
+};
+
+}  // namespace smf
@@ -6,7 +6,9 @@
  * @details This file contains the definition of the Logger class, which provides logging
  *          functionality for the state machine. The logger supports different log levels (DEBUG, INFO, WARN,
  *          ERROR) and can be configured to display timestamps with milliseconds. The logger is thread-safe
- *          and can be used in a multi-threaded environment.
+ *          and can be used in a multi-threaded environment. In binary mode (see binary_log.h) each
+ *          thread writes fixed records into its own ring buffer and the background thread writes
+ *          them to the log file with writev; smf_log_decode renders such a file as text.
  **/
 
 /*
@@ -35,17 +37,34 @@
 
 #pragma once
 
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
 #include <atomic>
+#include <cerrno>
 #include <chrono>  // 添加对chrono的引用
+#include <climits>
 #include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 #include <ctime>
 #include <fstream>
-#include <iomanip>
 #include <iostream>
+#include <map>
+#include <memory>
 #include <mutex>
-#include <queue>
+#include <sstream>
 #include <string>
 #include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "binary_log.h"
+#include "log_record.h"
 
 namespace smf {
 
@@ -60,66 +79,178 @@ const std::string RED = "\033[31m";
 
 enum class LogLevel { DEBUG, INFO, WARN, ERROR };
 
+// TEXT：调用线程只复制消息或参数，后台线程格式化后输出到控制台与日志文件
+// BINARY：调用线程只向本线程的环形缓冲区写入二进制记录，后台线程批量写入日志文件，
+//         不输出到控制台；应在开始写日志之前设置
+enum class LogMode { TEXT, BINARY };
+
+// 文本模式下日志文件的格式：TEXT 与控制台相同的文本行，JSON 每条日志一个 JSON 对象（JSON Lines）
+enum class LogFileFormat { TEXT, JSON };
+
+// 从完整路径中取出文件名（指向 path 内部），SMF_LOG* 宏在编译期对 __FILE__ 求值
+constexpr const char* LogFileName(const char* path) {
+  const char* name = path;
+  for (const char* p = path; *p != '\0'; ++p) {
+    if (*p == '/' || *p == '\\') {
+      name = p + 1;
+    }
+  }
+  return name;
+}
+
+// SMF_LOG* 宏为每个调用点注册一次的静态信息，file 为文件名；format 为 SMF_LOG 的格式串，
+// 只输出消息的调用点为空
+struct LogCallSite {
+  const char* file;
+  int line;
+  std::uint32_t id;
+  const char* format = nullptr;
+};
+
+// 编译期日志级别（供 SMF_MIN_LOG_LEVEL 使用），与 LogLevel 的取值一一对应
+#define SMF_LOG_LEVEL_DEBUG 0
+#define SMF_LOG_LEVEL_INFO 1
+#define SMF_LOG_LEVEL_WARN 2
+#define SMF_LOG_LEVEL_ERROR 3
+
+// 低于该级别的 SMF_LOG* 语句在编译期移除，消息表达式不会被求值；
+// 例如 -DSMF_MIN_LOG_LEVEL=SMF_LOG_LEVEL_WARN 移除全部 DEBUG 与 INFO 日志
+#ifndef SMF_MIN_LOG_LEVEL
+#define SMF_MIN_LOG_LEVEL SMF_LOG_LEVEL_DEBUG
+#endif
+
 class Logger {
  public:
+  // 实例不析构：全局对象（如 StateMachineFactory 持有的状态机）析构时仍可能写日志；
+  // 退出时由 atexit 调用 Shutdown 写出剩余日志并停止后台线程
   static Logger& GetInstance() {
-    static Logger instance;
-    return instance;
+    static Logger* instance = [] {
+      auto* logger = new Logger();
+      std::atexit([] { GetInstance().Shutdown(); });
+      return logger;
+    }();
+    return *instance;
   }
 
-  void SetLogLevel(LogLevel level) { level_ = level; }
+  void SetLogLevel(LogLevel level) { level_.store(level, std::memory_order_relaxed); }
 
   void SetLogFile(const std::string& file) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::mutex> lock(file_mutex_);
+    // 已缓冲的日志写入原来的文件
+    FlushTextFile();
     log_file_ = file;
     if (ofs_.is_open())
       ofs_.close();
     if (!log_file_.empty())
-      ofs_.open(log_file_, std::ios::app);
+      OpenTextFile(std::ios::app);
+    binary_file_changed_ = true;
   }
 
   // 新增：设置循环日志参数
   void SetLogFileRolling(size_t max_file_size, int max_backup_index) {
+    std::lock_guard<std::mutex> lock(file_mutex_);
     max_log_file_size_ = max_file_size;
     max_backup_index_ = max_backup_index;
   }
 
-  LogLevel GetLogLevel() const { return level_; }
+  // 文本日志文件的写入缓冲：缓冲数据达到 flush_bytes 字节或距上次写入超过 flush_interval_ms 毫秒时
+  // 写入文件，为 0 的条件不生效；两者均为 0（默认）时后台线程每取出一批日志就写入一次
+  void SetLogFileBuffering(size_t flush_bytes, int flush_interval_ms) {
+    std::lock_guard<std::mutex> lock(file_mutex_);
+    flush_bytes_ = flush_bytes;
+    flush_interval_ = std::chrono::milliseconds(flush_interval_ms > 0 ? flush_interval_ms : 0);
+  }
 
-  void Log(LogLevel level, const std::string& file, int line, const std::string& message) {
-    if (level < level_) {
-      return;
+  // 文本模式下日志文件的格式，控制台输出总是文本行
+  void SetLogFileFormat(LogFileFormat format) {
+    std::lock_guard<std::mutex> lock(file_mutex_);
+    file_format_ = format;
+  }
+
+  LogLevel GetLogLevel() const { return level_.load(std::memory_order_relaxed); }
+
+  void SetLogMode(LogMode mode) { mode_.store(mode, std::memory_order_relaxed); }
+
+  LogMode GetLogMode() const { return mode_.load(std::memory_order_relaxed); }
+
+  // 二进制模式下每个线程环形缓冲区的大小（字节），只影响之后首次写日志的线程
+  void SetBinaryRingSize(size_t bytes) { ring_size_.store(bytes, std::memory_order_relaxed); }
+
+  // 注册调用点并返回其 ID；file 为完整路径（__FILE__），format 须为字符串字面量。
+  // 完整路径、行号与格式串都相同才返回同一 ID：同名文件的同一行、同一行上的 SMF_LOGx 与
+  // SMF_LOG 各有自己的 ID，MESSAGE_ARGS 记录总按自己的格式串解码
+  std::uint32_t RegisterCallSite(const char* file, int line, const char* format = nullptr) {
+    std::lock_guard<std::mutex> lock(sites_mutex_);
+    auto key = std::make_tuple(std::string(file), line, format != nullptr,
+                               std::string(format ? format : ""));
+    auto it = site_ids_.find(key);
+    if (it != site_ids_.end()) {
+      return it->second;
     }
+    auto id = static_cast<std::uint32_t>(sites_.size());
+    sites_.push_back({LogFileName(file), line, format});
+    site_ids_.emplace(std::move(key), id);
+    return id;
+  }
 
-    // 格式化日志字符串
-    auto now = std::chrono::system_clock::now();
-    auto now_c = std::chrono::system_clock::to_time_t(now);
-    std::tm* localTime = std::localtime(&now_c);
-    auto duration = now.time_since_epoch();
-    auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count() % 1000;
-    std::string fileName = ExtractFileName(file);
+  // 该级别的日志是否输出；SMF_LOG* 宏先判断再构造消息
+  bool IsEnabled(LogLevel level) const { return level >= GetLogLevel(); }
 
-    std::ostringstream oss;
-    oss << "[" << std::setw(2) << std::setfill('0') << localTime->tm_hour << ":" << std::setw(2)
-        << std::setfill('0') << localTime->tm_min << ":" << std::setw(2) << std::setfill('0')
-        << localTime->tm_sec << "." << std::setw(3) << std::setfill('0') << millis << "] "
-        << LevelToString(level) << " "
-        << "[" << fileName << ":" << line << " - " << std::this_thread::get_id() << "] " << message
-        << Color::RESET;
+  void Log(LogLevel level, const LogCallSite& site, const std::string& message) {
+    if (!IsEnabled(level)) {
+      return;
+    }
+    if (GetLogMode() == LogMode::BINARY) {
+      LogBinary(level, site.id, message);
+      return;
+    }
+    CaptureText(level, site.file, site.line, nullptr, message.data(), message.size());
+  }
 
-    std::string logStr = oss.str();
+  // SMF_LOG 的入口：参数按值编码，格式化推迟到后台线程（或离线解码）
+  template <typename... Args>
+  void LogFormat(LogLevel level, const LogCallSite& site, const char* /*format*/,
+                 const Args&... args) {
+    if (!IsEnabled(level)) {
+      return;
+    }
+    thread_local std::string encoded;
+    encoded.clear();
+    EncodeLogArgs(&encoded, args...);
+    if (GetLogMode() == LogMode::BINARY) {
+      LogBinary(level, site.id, encoded, BinaryLogRecordType::MESSAGE_ARGS);
+      return;
+    }
+    CaptureText(level, site.file, site.line, site.format, encoded.data(), encoded.size());
+  }
 
-    // 控制台输出
-    {
-      std::lock_guard<std::mutex> lock(mutex_);
-      std::cerr << logStr << std::endl;
+  // 未经 SMF_LOG* 宏的调用在二进制模式下每次都要查找调用点 ID
+  void Log(LogLevel level, const char* file, int line, const std::string& message) {
+    if (!IsEnabled(level)) {
+      return;
     }
-    // 推入日志队列，后台线程写盘
-    {
-      std::lock_guard<std::mutex> lock(queue_mutex_);
-      log_queue_.push(logStr);
-      queue_cv_.notify_one();
+    if (GetLogMode() == LogMode::BINARY) {
+      LogBinary(level, RegisterCallSite(file, line), message);
+      return;
     }
+    CaptureText(level, LogFileName(file), line, nullptr, message.data(), message.size());
+  }
+
+  void Log(LogLevel level, const std::string& file, int line, const std::string& message) {
+    Log(level, file.c_str(), line, message);
+  }
+
+  // 将各线程缓冲区中已写入的二进制记录立即写入日志文件
+  void Flush() { DrainBinary(); }
+
+  // 二进制模式下因缓冲区已满而丢弃的记录数
+  std::uint64_t GetDroppedRecords() {
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    std::uint64_t dropped = retired_dropped_;
+    for (const auto& ring : rings_) {
+      dropped += ring->GetDropped();
+    }
+    return dropped;
   }
 
   void Shutdown() {
@@ -127,6 +258,13 @@ class Logger {
     queue_cv_.notify_one();
     if (bg_thread_.joinable())
       bg_thread_.join();
+    DrainBinary();
+    {
+      std::lock_guard<std::mutex> lock(binary_mutex_);
+      CloseBinaryFile();
+    }
+    std::lock_guard<std::mutex> lock(file_mutex_);
+    FlushTextFile();
     if (ofs_.is_open())
       ofs_.close();
   }
@@ -134,107 +272,430 @@ class Logger {
  private:
   Logger()
       : level_(LogLevel::INFO),
+        mode_(LogMode::TEXT),
+        ring_size_(64 * 1024),
         log_file_(""),
         running_(true),
-        bg_thread_(&Logger::BackgroundWrite, this),
         max_log_file_size_(10 * 1024 * 1024),  // 默认10MB
-        max_backup_index_(3) {}
-
-  ~Logger() { Shutdown(); }
+        max_backup_index_(3) {
+    // 全部成员初始化之后再启动后台线程
+    bg_thread_ = std::thread(&Logger::BackgroundWrite, this);
+  }
 
   Logger(const Logger&) = delete;
   Logger& operator=(const Logger&) = delete;
 
-  std::string LevelToString(LogLevel level) const {
-    switch (level) {
-      case LogLevel::DEBUG:
-        return Color::WHITE + "[DEBUG]";
-      case LogLevel::INFO:
-        return Color::GREEN + "[INFO] ";
-      case LogLevel::WARN:
-        return Color::YELLOW + "[WARN] ";
-      case LogLevel::ERROR:
-        return Color::RED + "[ERROR]";
-      default:
-        return "[UNKNOWN]";
+  // 队列中的一条待格式化日志。队列与后台线程的批次交换后槽位被复用，字符串保留容量，
+  // 稳定运行后写日志不再分配内存
+  struct QueuedLog {
+    LogLevel level;
+    std::int64_t timestamp_ms;
+    int line;
+    const char* format;  // 字符串字面量；为空时 data 是完整消息
+    std::string file;
+    std::string thread;
+    std::string data;
+  };
+
+  static const std::string& ThreadIdText() {
+    thread_local std::string thread_id = [] {
+      std::ostringstream oss;
+      oss << std::this_thread::get_id();
+      return oss.str();
+    }();
+    return thread_id;
+  }
+
+  // 复制一条文本模式日志到队列，file 为文件名
+  void CaptureText(LogLevel level, const char* file, int line, const char* format,
+                   const char* data, size_t size) {
+    const std::string& thread = ThreadIdText();
+    auto timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                            std::chrono::system_clock::now().time_since_epoch())
+                            .count();
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    if (queue_count_ == log_queue_.size()) {
+      log_queue_.emplace_back();
     }
+    QueuedLog& slot = log_queue_[queue_count_++];
+    slot.level = level;
+    slot.timestamp_ms = timestamp_ms;
+    slot.line = line;
+    slot.format = format;
+    slot.file.assign(file);
+    slot.thread.assign(thread);
+    slot.data.assign(data, size);
+    queue_cv_.notify_one();
   }
 
-  // 辅助函数：从完整路径中提取文件名
-  std::string ExtractFileName(const std::string& fullPath) const {
-    size_t pos = fullPath.find_last_of("/\\");
-    if (pos == std::string::npos)
-      return fullPath;
-    return fullPath.substr(pos + 1);
+  // 线程退出时关闭本线程的环形缓冲区，由后台线程读空后移除
+  struct RingHolder {
+    std::shared_ptr<BinaryLogRing> ring;
+    ~RingHolder() {
+      if (ring) {
+        ring->Close();
+      }
+    }
+  };
+
+  BinaryLogRing* LocalRing() {
+    thread_local RingHolder holder;
+    if (!holder.ring) {
+      std::lock_guard<std::mutex> lock(rings_mutex_);
+      holder.ring = std::make_shared<BinaryLogRing>(ring_size_.load(std::memory_order_relaxed),
+                                                    next_thread_index_++);
+      rings_.push_back(holder.ring);
+    }
+    return holder.ring.get();
   }
 
-  void BackgroundWrite() {
-    while (running_ || !log_queue_.empty()) {
-      std::unique_lock<std::mutex> lock(queue_mutex_);
-      queue_cv_.wait_for(lock, std::chrono::milliseconds(100),
-                         [this] { return !log_queue_.empty() || !running_; });
-
-      while (!log_queue_.empty()) {
-        std::string logStr = log_queue_.front();
-        log_queue_.pop();
-        lock.unlock();
-        if (!log_file_.empty()) {
-          std::lock_guard<std::mutex> file_lock(mutex_);
-          RotateIfNeeded();
-          if (!ofs_.is_open()) {
-            ofs_.open(log_file_, std::ios::app);
-          }
-          if (ofs_.is_open()) {
-            ofs_ << logStr << std::endl;
-            ofs_.flush();
+  void LogBinary(LogLevel level, std::uint32_t site_id, const std::string& message,
+                 BinaryLogRecordType type = BinaryLogRecordType::MESSAGE) {
+    BinaryLogRing* ring = LocalRing();
+    // 参数记录不能截断，放不下时计为丢弃
+    if (type == BinaryLogRecordType::MESSAGE_ARGS && message.size() > ring->GetMaxPayload()) {
+      ring->Drop();
+      return;
+    }
+    BinaryLogRecordHeader header{};
+    header.type = static_cast<std::uint16_t>(type);
+    header.level = static_cast<std::uint8_t>(level);
+    header.site_id = site_id;
+    header.thread_index = ring->GetThreadIndex();
+    header.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::system_clock::now().time_since_epoch())
+                              .count();
+    ring->TryWrite(header, message.data(), message.size());
+  }
+
+  // 读空各线程的环形缓冲区：新注册的调用点记录与各缓冲区的可读区域一次 writev 写入，
+  // 缓冲区内存直接作为 iovec，不再复制；未设置日志文件时丢弃记录
+  void DrainBinary() {
+    std::lock_guard<std::mutex> binary_lock(binary_mutex_);
+    {
+      std::lock_guard<std::mutex> lock(rings_mutex_);
+      drain_rings_.assign(rings_.begin(), rings_.end());
+    }
+    // 先取得各缓冲区的可读区域再读取调用点：记录引用的调用点在记录发布之前已注册
+    iov_.clear();
+    iov_.push_back({nullptr, 0});  // 调用点记录占位
+    drain_ends_.clear();
+    drain_closed_.clear();
+    for (const auto& ring : drain_rings_) {
+      drain_closed_.push_back(ring->IsClosed());
+      struct iovec segments[2];
+      std::uint64_t end = 0;
+      int count = ring->Peek(segments, &end);
+      iov_.insert(iov_.end(), segments, segments + count);
+      drain_ends_.push_back(end);
+    }
+
+    if (binary_file_changed_.exchange(false)) {
+      CloseBinaryFile();
+      std::lock_guard<std::mutex> lock(file_mutex_);
+      binary_path_ = log_file_;
+    }
+    if (iov_.size() > 1 && !binary_path_.empty()) {
+      if (binary_fd_ >= 0 && max_log_file_size_ > 0 && binary_file_size_ >= max_log_file_size_) {
+        CloseBinaryFile();
+        RotateFiles(binary_path_);
+        OpenBinaryFile(O_TRUNC);
+      }
+      if (binary_fd_ < 0) {
+        OpenBinaryFile(O_APPEND);
+      }
+      if (binary_fd_ >= 0) {
+        AppendNewCallSites();
+        iov_[0].iov_base = &site_buffer_[0];
+        iov_[0].iov_len = site_buffer_.size();
+        WriteAll(iov_.data(), iov_.size());
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    for (size_t i = 0; i < drain_rings_.size(); ++i) {
+      drain_rings_[i]->Consume(drain_ends_[i]);
+      // 关闭之后线程不再写入，读空即可移除
+      if (drain_closed_[i]) {
+        retired_dropped_ += drain_rings_[i]->GetDropped();
+        for (auto it = rings_.begin(); it != rings_.end(); ++it) {
+          if (*it == drain_rings_[i]) {
+            rings_.erase(it);
+            break;
           }
         }
-        lock.lock();
       }
     }
+    drain_rings_.clear();
   }
 
-  void RotateIfNeeded() {
-    if (log_file_.empty() || max_log_file_size_ == 0)
+  // 序列化尚未写入当前文件的调用点记录到 site_buffer_
+  void AppendNewCallSites() {
+    site_buffer_.clear();
+    std::lock_guard<std::mutex> lock(sites_mutex_);
+    for (; sites_written_ < sites_.size(); ++sites_written_) {
+      const auto& site = sites_[sites_written_];
+      size_t format_size = site.format ? 1 + std::strlen(site.format) : 0;
+      BinaryLogRecordHeader header{};
+      header.size = static_cast<std::uint32_t>(sizeof(header) + sizeof(std::uint32_t) +
+                                               site.file.size() + format_size);
+      header.type = static_cast<std::uint16_t>(BinaryLogRecordType::CALL_SITE);
+      header.site_id = static_cast<std::uint32_t>(sites_written_);
+      auto line = static_cast<std::uint32_t>(site.line);
+      site_buffer_.append(reinterpret_cast<const char*>(&header), sizeof(header));
+      site_buffer_.append(reinterpret_cast<const char*>(&line), sizeof(line));
+      site_buffer_.append(site.file);
+      if (site.format) {
+        site_buffer_.push_back('\0');
+        site_buffer_.append(site.format);
+      }
+    }
+  }
+
+  // 打开二进制日志文件并写入文件头；之后所有调用点需重新写入
+  void OpenBinaryFile(int flags) {
+    binary_fd_ = ::open(binary_path_.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | flags, 0644);
+    if (binary_fd_ < 0) {
       return;
-    ofs_.seekp(0, std::ios::end);
-    std::streampos size = ofs_.tellp();
-    if (size < 0)
+    }
+    struct stat st;
+    binary_file_size_ = ::fstat(binary_fd_, &st) == 0 ? static_cast<size_t>(st.st_size) : 0;
+    sites_written_ = 0;
+    char file_header[kBinaryLogFileHeaderSize];
+    std::memcpy(file_header, kBinaryLogMagic, sizeof(kBinaryLogMagic));
+    std::memcpy(file_header + sizeof(kBinaryLogMagic), &kBinaryLogVersion,
+                sizeof(kBinaryLogVersion));
+    struct iovec iov = {file_header, sizeof(file_header)};
+    WriteAll(&iov, 1);
+  }
+
+  void CloseBinaryFile() {
+    if (binary_fd_ >= 0) {
+      ::close(binary_fd_);
+      binary_fd_ = -1;
+    }
+  }
+
+  // 写出全部 iovec，处理部分写入与 IOV_MAX 限制；出错时放弃本批数据
+  void WriteAll(struct iovec* iov, size_t count) {
+    while (count > 0) {
+      if (iov->iov_len == 0) {
+        ++iov;
+        --count;
+        continue;
+      }
+      int batch = static_cast<int>(count < IOV_MAX ? count : IOV_MAX);
+      ssize_t written = ::writev(binary_fd_, iov, batch);
+      if (written < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return;
+      }
+      binary_file_size_ += static_cast<size_t>(written);
+      auto remaining = static_cast<size_t>(written);
+      while (count > 0 && remaining >= iov->iov_len) {
+        remaining -= iov->iov_len;
+        ++iov;
+        --count;
+      }
+      if (remaining > 0) {
+        iov->iov_base = static_cast<char*>(iov->iov_base) + remaining;
+        iov->iov_len -= remaining;
+      }
+    }
+  }
+
+  // 后台线程：每次一并取出队列中的全部日志，格式化后输出到控制台，并追加到写入缓冲区，
+  // 按 SetLogFileBuffering 的条件写入文件
+  void BackgroundWrite() {
+    std::vector<QueuedLog> batch;
+    while (true) {
+      if (GetLogMode() == LogMode::BINARY) {
+        DrainBinary();
+      }
+      size_t count = 0;
+      {
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        // 二进制模式下写日志的线程不通知后台线程，按较短的间隔轮询各线程的缓冲区
+        queue_cv_.wait_for(lock, WaitInterval(),
+                           [this] { return queue_count_ > 0 || !running_; });
+        // 交换后原来的批次成为新的队列，其槽位供写日志的线程复用
+        batch.swap(log_queue_);
+        count = queue_count_;
+        queue_count_ = 0;
+        if (count == 0 && !running_) {
+          break;
+        }
+      }
+      WriteTextBatch(batch, count);
+    }
+  }
+
+  std::chrono::milliseconds WaitInterval() {
+    std::chrono::milliseconds interval(GetLogMode() == LogMode::BINARY ? 10 : 100);
+    std::lock_guard<std::mutex> lock(file_mutex_);
+    if (flush_interval_.count() > 0 && flush_interval_ < interval) {
+      interval = flush_interval_;
+    }
+    return interval;
+  }
+
+  static LogRecordView ToRecordView(const QueuedLog& log) {
+    LogRecordView record;
+    record.level = static_cast<std::uint8_t>(log.level);
+    record.file = log.file;
+    record.line = static_cast<std::uint32_t>(log.line);
+    record.thread = log.thread;
+    record.timestamp_ms = log.timestamp_ms;
+    record.format = log.format ? std::string_view(log.format) : std::string_view();
+    record.data = log.data;
+    return record;
+  }
+
+  void WriteTextBatch(const std::vector<QueuedLog>& batch, size_t count) {
+    // 控制台输出
+    console_buffer_.clear();
+    for (size_t i = 0; i < count; ++i) {
+      formatter_.AppendText(&console_buffer_, ToRecordView(batch[i]), true);
+      console_buffer_.push_back('\n');
+    }
+    if (!console_buffer_.empty()) {
+      std::cerr.write(console_buffer_.data(), static_cast<std::streamsize>(console_buffer_.size()));
+      std::cerr.flush();
+    }
+
+    std::lock_guard<std::mutex> lock(file_mutex_);
+    if (log_file_.empty()) {
       return;
-    if (static_cast<size_t>(size) < max_log_file_size_)
+    }
+    if (file_format_ == LogFileFormat::TEXT) {
+      write_buffer_.append(console_buffer_);
+    } else {
+      for (size_t i = 0; i < count; ++i) {
+        formatter_.AppendJson(&write_buffer_, ToRecordView(batch[i]));
+        write_buffer_.push_back('\n');
+      }
+    }
+    bool by_size = flush_bytes_ > 0 && write_buffer_.size() >= flush_bytes_;
+    bool by_time = flush_interval_.count() > 0 &&
+                   std::chrono::steady_clock::now() - last_flush_ >= flush_interval_;
+    bool unbuffered = flush_bytes_ == 0 && flush_interval_.count() == 0;
+    if (by_size || by_time || unbuffered) {
+      FlushTextFile();
+    }
+  }
+
+  // 将写入缓冲区写入文件（调用者持有 file_mutex_）；文件大小在内存中累计，写入前按需轮转
+  void FlushTextFile() {
+    last_flush_ = std::chrono::steady_clock::now();
+    if (write_buffer_.empty() || log_file_.empty()) {
+      write_buffer_.clear();
       return;
+    }
+    RotateIfNeeded();
+    if (!ofs_.is_open()) {
+      OpenTextFile(std::ios::app);
+    }
+    if (ofs_.is_open()) {
+      ofs_.write(write_buffer_.data(), static_cast<std::streamsize>(write_buffer_.size()));
+      ofs_.flush();
+      text_file_size_ += write_buffer_.size();
+    }
+    write_buffer_.clear();
+  }
+
+  // 打开文本日志文件，追加时只在打开时取一次文件大小
+  void OpenTextFile(std::ios::openmode mode) {
+    ofs_.open(log_file_, mode);
+    text_file_size_ = 0;
+    if (ofs_.is_open() && (mode & std::ios::app)) {
+      ofs_.seekp(0, std::ios::end);
+      std::streampos size = ofs_.tellp();
+      text_file_size_ = size > 0 ? static_cast<size_t>(size) : 0;
+    }
+  }
 
+  void RotateIfNeeded() {
+    if (!ofs_.is_open() || max_log_file_size_ == 0 || text_file_size_ < max_log_file_size_)
+      return;
     ofs_.close();
+    RotateFiles(log_file_);
+    OpenTextFile(std::ios::trunc);
+  }
+
+  // 轮转日志文件：file 重命名为 file.1，旧的备份依次后移
+  void RotateFiles(const std::string& file) {
     // 删除最老的备份
     if (max_backup_index_ > 0) {
-      std::string oldest = log_file_ + "." + std::to_string(max_backup_index_);
+      std::string oldest = file + "." + std::to_string(max_backup_index_);
       std::remove(oldest.c_str());
       // 依次重命名
       for (int i = max_backup_index_ - 1; i >= 1; --i) {
-        std::string src = log_file_ + "." + std::to_string(i);
-        std::string dst = log_file_ + "." + std::to_string(i + 1);
+        std::string src = file + "." + std::to_string(i);
+        std::string dst = file + "." + std::to_string(i + 1);
         std::rename(src.c_str(), dst.c_str());
       }
       // 当前日志文件重命名为 .1
-      std::rename(log_file_.c_str(), (log_file_ + ".1").c_str());
+      std::rename(file.c_str(), (file + ".1").c_str());
     } else {
-      std::remove(log_file_.c_str());
+      std::remove(file.c_str());
     }
-    ofs_.open(log_file_, std::ios::trunc);
   }
 
-  LogLevel level_;
+  std::atomic<LogLevel> level_;
+  std::atomic<LogMode> mode_;
+  std::atomic<size_t> ring_size_;
+  // 日志文件与写入缓冲区，由 file_mutex_ 保护，写日志的线程不会等待文件写入或轮转
+  std::mutex file_mutex_;
   std::string log_file_;
   std::ofstream ofs_;
-  std::mutex mutex_;
-  std::queue<std::string> log_queue_;
+  size_t text_file_size_ = 0;
+  std::string write_buffer_;
+  size_t flush_bytes_ = 0;
+  std::chrono::milliseconds flush_interval_{0};
+  std::chrono::steady_clock::time_point last_flush_;
+  LogFileFormat file_format_ = LogFileFormat::TEXT;
+  // 后台线程独占的格式化状态
+  LogLineFormatter formatter_;
+  std::string console_buffer_;
+  // 待格式化的日志：log_queue_ 的前 queue_count_ 个槽位有效
+  std::vector<QueuedLog> log_queue_;
+  size_t queue_count_ = 0;
   std::mutex queue_mutex_;
   std::condition_variable queue_cv_;
   std::atomic<bool> running_;
-  std::thread bg_thread_;
   // 新增循环日志参数
   size_t max_log_file_size_;
   int max_backup_index_;
+  // 调用点表：sites_[id] 为文件名、行号与格式串
+  struct RegisteredSite {
+    std::string file;
+    int line;
+    const char* format;
+  };
+  std::mutex sites_mutex_;
+  std::vector<RegisteredSite> sites_;
+  // 键为完整路径、行号、是否有格式串与格式串
+  std::map<std::tuple<std::string, int, bool, std::string>, std::uint32_t> site_ids_;
+  // 各线程的二进制记录缓冲区
+  std::mutex rings_mutex_;
+  std::vector<std::shared_ptr<BinaryLogRing>> rings_;
+  std::uint32_t next_thread_index_ = 0;
+  std::uint64_t retired_dropped_ = 0;
+  // 二进制日志文件，由 binary_mutex_ 保护（同一时刻只有一个消费者读取缓冲区）
+  std::mutex binary_mutex_;
+  std::atomic<bool> binary_file_changed_{true};
+  std::string binary_path_;
+  int binary_fd_ = -1;
+  size_t binary_file_size_ = 0;
+  size_t sites_written_ = 0;
+  std::string site_buffer_;
+  std::vector<struct iovec> iov_;
+  std::vector<std::shared_ptr<BinaryLogRing>> drain_rings_;
+  std::vector<std::uint64_t> drain_ends_;
+  std::vector<bool> drain_closed_;
+  std::thread bg_thread_;
 };
 
 }  // namespace smf
@@ -247,12 +708,72 @@ class Logger {
 #define SMF_LOGGER_SET_ROLLING(max_file_size, max_backup_index) \
   smf::Logger::GetInstance().SetLogFileRolling(max_file_size, max_backup_index)
 
+// Set log file buffering
+#define SMF_LOGGER_SET_BUFFERING(flush_bytes, flush_interval_ms) \
+  smf::Logger::GetInstance().SetLogFileBuffering(flush_bytes, flush_interval_ms)
+
+#define SMF_LOGGER_SET_MODE(mode) smf::Logger::GetInstance().SetLogMode(mode)
+
+// 先判断运行期日志级别，级别被过滤时不求值 message（不拼接字符串）；
+// 文件名在编译期取出，调用点在首次输出时注册一次，二进制记录只携带调用点 ID
+#define SMF_LOG_MESSAGE(level, message)                                                  \
+  do {                                                                                   \
+    smf::Logger& smf_logger_ = smf::Logger::GetInstance();                               \
+    if (smf_logger_.IsEnabled(level)) {                                                  \
+      static constexpr const char* smf_log_file_ = smf::LogFileName(__FILE__);           \
+      static const smf::LogCallSite smf_log_site_{                                       \
+          smf_log_file_, __LINE__, smf_logger_.RegisterCallSite(__FILE__, __LINE__)};      \
+      smf_logger_.Log(level, smf_log_site_, message);                                    \
+    }                                                                                    \
+  } while (0)
+
+// 编译期移除的日志语句：message 只出现在不求值的 sizeof 中，不生成代码，
+// 只在日志中使用的变量也不会产生未使用告警
+#define SMF_LOG_DISCARD(message) \
+  do {                           \
+    (void)sizeof(message);       \
+  } while (0)
+
+// 结构化日志：SMF_LOG(level, "fmt {} {}", args...)。
+// - fmt 必须是字符串字面量，"{}" 的个数在编译期与参数个数比较（"{{" / "}}" 输出花括号）
+// - 参数按值复制（整数、浮点、bool、char、枚举、字符串），格式化推迟到后台线程或离线解码
+// - 低于 SMF_MIN_LOG_LEVEL 或运行期日志级别时不求值参数
+#define SMF_LOG(level, ...) SMF_LOG_FORMAT_(level, SMF_LOG_FIRST_(__VA_ARGS__, unused), __VA_ARGS__)
+#define SMF_LOG_FIRST_(first, ...) first
+#define SMF_LOG_FORMAT_(level, format, ...)                                                   \
+  do {                                                                                        \
+    static_assert(smf::LogFormatArgCount(format) >= 0 &&                                      \
+                      static_cast<std::size_t>(smf::LogFormatArgCount(format)) + 1 ==         \
+                          decltype(smf::LogArgCount(__VA_ARGS__))::value,                     \
+                  "SMF_LOG format string does not match its arguments");                      \
+    smf::Logger& smf_logger_ = smf::Logger::GetInstance();                                    \
+    if (static_cast<int>(level) >= SMF_MIN_LOG_LEVEL && smf_logger_.IsEnabled(level)) {       \
+      static constexpr const char* smf_log_file_ = smf::LogFileName(__FILE__);                \
+      static const smf::LogCallSite smf_log_site_{                                            \
+          smf_log_file_, __LINE__,                                                            \
+          smf_logger_.RegisterCallSite(__FILE__, __LINE__, format), format};                  \
+      smf_logger_.LogFormat(level, smf_log_site_, __VA_ARGS__);                               \
+    }                                                                                         \
+  } while (0)
+
 // Log macros for users
-#define SMF_LOGD(message) \
-  smf::Logger::GetInstance().Log(smf::LogLevel::DEBUG, __FILE__, __LINE__, message)
-#define SMF_LOGI(message) \
-  smf::Logger::GetInstance().Log(smf::LogLevel::INFO, __FILE__, __LINE__, message)
-#define SMF_LOGW(message) \
-  smf::Logger::GetInstance().Log(smf::LogLevel::WARN, __FILE__, __LINE__, message)
-#define SMF_LOGE(message) \
-  smf::Logger::GetInstance().Log(smf::LogLevel::ERROR, __FILE__, __LINE__, message)
+#if SMF_MIN_LOG_LEVEL <= SMF_LOG_LEVEL_DEBUG
+#define SMF_LOGD(message) SMF_LOG_MESSAGE(smf::LogLevel::DEBUG, message)
+#else
+#define SMF_LOGD(message) SMF_LOG_DISCARD(message)
+#endif
+#if SMF_MIN_LOG_LEVEL <= SMF_LOG_LEVEL_INFO
+#define SMF_LOGI(message) SMF_LOG_MESSAGE(smf::LogLevel::INFO, message)
+#else
+#define SMF_LOGI(message) SMF_LOG_DISCARD(message)
+#endif
+#if SMF_MIN_LOG_LEVEL <= SMF_LOG_LEVEL_WARN
+#define SMF_LOGW(message) SMF_LOG_MESSAGE(smf::LogLevel::WARN, message)
+#else
+#define SMF_LOGW(message) SMF_LOG_DISCARD(message)
+#endif
+#if SMF_MIN_LOG_LEVEL <= SMF_LOG_LEVEL_ERROR
+#define SMF_LOGE(message) SMF_LOG_MESSAGE(smf::LogLevel::ERROR, message)
+#else
+#define SMF_LOGE(message) SMF_LOG_DISCARD(message)
+#endif
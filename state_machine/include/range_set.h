@@ -0,0 +1,111 @@
+/**
+ * @file range_set.h
+ * @brief Sorted range sets and range-membership kernels for condition evaluation
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @details This file contains the definition of the RangeSet and RangeSetBatch classes. A range
+ *          set keeps a condition's ranges sorted and merged as separate lower/upper bound arrays,
+ *          which the membership kernels scan with SSE2/AVX2 compares or, for large sets, with a
+ *          binary search. RangeSetBatch tests one value against the ranges of many conditions in
+ *          a single pass.
+ * @version 1.0.0
+ **/
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2025 xiaokui.hu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace smf {
+
+// 有序范围集合：范围按下界排序并合并重叠/相邻区间，下界与上界分别存放在两个数组中（SoA）
+// - 只有一两个范围时在头文件内直接比较，其余交给 ContainsSorted 的向量化或二分查找实现
+// - 下界大于上界的无效范围在构建时丢弃，与逐个比较的结果一致
+class RangeSet final {
+ public:
+  RangeSet() = default;
+  explicit RangeSet(const std::vector<std::pair<int, int>>& ranges) { Assign(ranges); }
+
+  // 用给定范围重建集合
+  void Assign(const std::vector<std::pair<int, int>>& ranges);
+
+  bool Contains(int value) const noexcept {
+    const std::size_t count = mins_.size();
+    if (count <= 2) {
+      return (count > 0 && value >= mins_[0] && value <= maxs_[0]) ||
+             (count > 1 && value >= mins_[1] && value <= maxs_[1]);
+    }
+    return ContainsSorted(mins_.data(), maxs_.data(), count, value);
+  }
+
+  std::size_t Size() const noexcept { return mins_.size(); }
+  bool Empty() const noexcept { return mins_.empty(); }
+  const std::vector<int>& Mins() const noexcept { return mins_; }
+  const std::vector<int>& Maxs() const noexcept { return maxs_; }
+
+  // 在有序且互不重叠的范围 [mins[i], maxs[i]] 中查找 value：
+  // 范围较少时向量化线性扫描，较多时二分查找（分界随向量宽度变化，见 range_set.cpp）
+  static bool ContainsSorted(const int* mins, const int* maxs, std::size_t count,
+                             int value) noexcept;
+
+  // 以下为各实现路径，供测试与基准测试对比
+  static bool ContainsScalar(const int* mins, const int* maxs, std::size_t count,
+                             int value) noexcept;
+  static bool ContainsSimd(const int* mins, const int* maxs, std::size_t count,
+                           int value) noexcept;
+  static bool ContainsBinarySearch(const int* mins, const int* maxs, std::size_t count,
+                                   int value) noexcept;
+  // 编译进库的向量化实现："avx2"、"sse2" 或 "scalar"
+  static const char* SimdKernelName() noexcept;
+
+ private:
+  std::vector<int> mins_;
+  std::vector<int> maxs_;
+};
+
+// 多个范围集合的批量判断：各集合的范围首尾相接存放，一次扫描得到 value 对每个集合的结果。
+// 用于同一条件 ID 下以不同范围定义的多个条件
+class RangeSetBatch final {
+ public:
+  // 追加一个集合，返回其在批量中的下标
+  std::size_t Add(const RangeSet& set);
+
+  std::size_t Size() const noexcept { return set_count_; }
+
+  // out[i] 置为 value 是否落在第 i 个集合内，out 至少需要 Size() 个元素
+  void Contains(int value, std::uint8_t* out) const noexcept;
+
+ private:
+  std::vector<int> mins_;
+  std::vector<int> maxs_;
+  std::vector<std::uint32_t> owners_;  // 每个范围所属集合的下标
+  std::size_t set_count_{0};
+};
+
+}  // namespace smf
@@ -0,0 +1,121 @@
+/**
+ * @file shared_executor.h
+ * @brief Shared worker pool with per-owner serialized strands
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @details This file contains the definition of the SharedExecutor and Strand classes. A
+ *          SharedExecutor owns a fixed number of worker threads and one timing wheel thread. Each
+ *          Strand is a FIFO task queue that runs on whichever worker is free, but never on two
+ *          workers at once, so tasks posted to one strand execute in order and one at a time
+ *          while different strands run in parallel.
+ * @version 1.0.0
+ **/
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2025 xiaokui.hu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "timing_wheel.h"
+
+namespace smf {
+
+class SharedExecutor;
+
+// 串行执行单元：投递到同一 Strand 的任务按投递顺序逐个执行，不会并发
+class Strand final : public std::enable_shared_from_this<Strand> {
+ public:
+  using Task = std::function<void()>;
+
+  Strand(const Strand&) = delete;
+  Strand& operator=(const Strand&) = delete;
+
+  // 投递任务（线程安全）
+  void Post(Task task);
+
+  // 在 deadline 到达后投递任务（线程安全）；Strand 先于到期被销毁时任务丢弃
+  void PostAt(std::chrono::steady_clock::time_point deadline, Task task);
+
+  // 当前线程是否正在执行本 Strand 的任务
+  bool RunningInThisThread() const;
+
+ private:
+  friend class SharedExecutor;
+  explicit Strand(SharedExecutor* executor) : executor_(executor) {}
+
+  // 工作线程调用：执行当前已排队的全部任务，仍有任务时返回 true
+  bool RunPending();
+
+  SharedExecutor* executor_;
+  std::mutex mutex_;
+  std::vector<Task> tasks_;
+  // 正在执行的批次（仅调度到的工作线程访问）
+  std::vector<Task> running_tasks_;
+  // 已在就绪队列中或正在执行，防止同一 Strand 被两个工作线程同时调度
+  bool scheduled_{false};
+};
+
+// 共享线程池：固定数量的工作线程轮流执行就绪的 Strand，另由一个时间轮定时线程处理 PostAt
+class SharedExecutor final {
+ public:
+  // threads 为 0 时使用 std::thread::hardware_concurrency()
+  explicit SharedExecutor(size_t threads = 0);
+  ~SharedExecutor();
+  SharedExecutor(const SharedExecutor&) = delete;
+  SharedExecutor& operator=(const SharedExecutor&) = delete;
+
+  // 创建一个绑定到本线程池的 Strand（Strand 的生命周期不得超过线程池）
+  std::shared_ptr<Strand> CreateStrand();
+
+  size_t GetThreadCount() const { return workers_.size(); }
+
+ private:
+  friend class Strand;
+
+  // Strand 从空闲变为有任务时加入就绪队列
+  void Schedule(std::shared_ptr<Strand> strand);
+  void WorkerLoop();
+
+  std::atomic_bool stopping_{false};
+  std::vector<std::thread> workers_;
+  std::deque<std::shared_ptr<Strand>> ready_;
+  std::mutex ready_mutex_;
+  std::condition_variable ready_cv_;
+
+  // PostAt 的定时器，到期后把任务投递回对应的 Strand
+  TimingWheel timers_;
+};
+
+}  // namespace smf
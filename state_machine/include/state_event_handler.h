@@ -126,6 +126,13 @@ class StateEventHandler final {
     };
   }
 
+  // 是否设置了对应回调（未设置的回调不计入回调耗时统计）
+  bool HasTransitionCallback() const { return static_cast<bool>(transitionCallback); }
+  bool HasPreEventCallback() const { return static_cast<bool>(preEventCallback); }
+  bool HasEnterStateCallback() const { return static_cast<bool>(enterStateCallback); }
+  bool HasExitStateCallback() const { return static_cast<bool>(exitStateCallback); }
+  bool HasPostEventCallback() const { return static_cast<bool>(postEventCallback); }
+
   // 实际处理状态转换
   void OnTransition(const std::vector<State>& fromStates, const EventPtr& event,
                     const std::vector<State>& toStates) {
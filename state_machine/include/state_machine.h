@@ -37,8 +37,12 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "common_define.h"
@@ -50,7 +54,12 @@
 #include "components/i_transition_manager.h"
 #include "event.h"
 #include "logger.h"
+#include "shared_executor.h"
 #include "state_event_handler.h"
+#include "state_machine_metrics.h"
+#include "state_machine_options.h"
+#include "symbol_table.h"
+#include "timing_wheel.h"
 
 namespace smf {
 
@@ -74,6 +83,8 @@ class FiniteStateMachine final : public std::enable_shared_from_this<FiniteState
             const std::string& transConfigDir);
 
   // 启动状态机
+  // 共享线程池模式下 Start/Stop 在本状态机的 Strand 上执行并等待完成，因此不要在
+  // 其他共享线程池状态机的回调中同步启停本状态机（线程池只有一个线程时会死锁）
   bool Start();
 
   // 停止状态机
@@ -82,6 +93,22 @@ class FiniteStateMachine final : public std::enable_shared_from_this<FiniteState
   // 处理事件（线程安全）
   void HandleEvent(const EventPtr& event);
 
+  // 批量处理事件（线程安全），整批只做一次同步，按顺序处理
+  void HandleEvents(const EventPtr* events, size_t count);
+  void HandleEvents(const std::vector<EventPtr>& events);
+
+  // 同步执行模式（ExecutionMode::INLINE）下推进定时器：
+  // 触发到期时间不晚于 now 的持续时间条件与状态超时，并同步处理由此产生的事件；
+  // 返回下一次需要调用 Poll 的时间（没有定时器时为 time_point::max()）
+  std::chrono::steady_clock::time_point Poll(std::chrono::steady_clock::time_point now);
+
+  // 同步执行模式下以当前时间反复 Poll，直到没有已到期的定时器，返回下一次到期时间
+  std::chrono::steady_clock::time_point RunUntilIdle();
+
+  // 最近一个定时器（持续时间条件、状态超时或挂起转移到期）的到期时间，没有定时器时为
+  // time_point::max()
+  std::chrono::steady_clock::time_point GetNextDeadline() const;
+
   // 设置状态转移回调 - 函数对象版本
   void SetTransitionCallback(StateEventHandler::TransitionCallback callback);
 
@@ -167,29 +194,78 @@ class FiniteStateMachine final : public std::enable_shared_from_this<FiniteState
   // 继续支持原有的接口，但现在作为兼容层
   void SetStateEventHandler(std::shared_ptr<StateEventHandler> handler);
 
-  // 获取当前状态
-  State GetCurrentState() const;
+  // 获取当前状态：无锁读取原子状态 ID，返回符号表中驻留的名称（状态机生命周期内有效），
+  // 可被监控线程高频轮询而不与事件线程竞争
+  const State& GetCurrentState() const;
+
+  // 状态代数：每次状态切换后递增，轮询方只需比较代数即可判断状态是否变化
+  std::uint64_t GetStateGeneration() const;
 
   // 设置条件值
   void SetConditionValue(const std::string& name, int value);
 
+  // 批量设置条件值（一帧）：全部值写入后才重新检查依赖这些条件的事件定义，每个定义只检查一次，
+  // 整帧只生成一个 INTERNAL_EVENT
+  void SetConditionValues(const std::vector<std::pair<std::string, int>>& values);
+
   // 获取条件值
   void GetConditionValue(const std::string& name, int& value) const;
 
+  // 条件变化生成的 INTERNAL_EVENT 统计：未处理的内部事件之后没有其他事件时，新的条件变化合并到
+  // 其中；没有待处理事件且当前状态既没有条件转移也没有挂起转移时不生成内部事件
+  InternalEventStats GetInternalEventStats() const;
+
+  // 运行指标快照：事件投递/处理/丢弃数、队列深度高水位、条件更新数、转移与挂起转移数，
+  // 以及（StateMachineOptions::latency_metrics 开启时）排队延迟与回调耗时直方图。
+  // 指标以 relaxed 原子量记录，可从任意线程调用，各字段之间不保证是同一时刻的值
+  StateMachineMetrics GetMetrics() const;
+
  private:
-  explicit FiniteStateMachine(const std::string& name);
+  // executor 仅在 ExecutionMode::SHARED_POOL 下使用；timer_wheel 为已启动的共享时间轮
+  // （StateMachineOptions::shared_timer_thread），为空时状态机创建自己的时间轮
+  FiniteStateMachine(const std::string& name, const StateMachineOptions& options,
+                     std::shared_ptr<SharedExecutor> executor = nullptr,
+                     std::shared_ptr<TimingWheel> timer_wheel = nullptr);
+
+  void StartComponents();
+  void StopComponents();
+  // 推进到期的定时器（同步执行与共享线程池模式）
+  void PollTimers(std::chrono::steady_clock::time_point now);
+  // 是否由本状态机启停时间轮的定时线程（THREADED 且未使用共享时间轮）
+  bool OwnsTimerThread() const;
+
+  // 共享线程池模式：把 task 投递到本状态机的 Strand，task 执行后重新登记定时器；
+  // 已在本 Strand 上（回调中调用）时直接执行。其他模式直接执行
+  void Dispatch(std::function<void()> task);
+  // 共享线程池模式：在本 Strand 上执行 task 并等待完成（用于 Start/Stop）
+  void DispatchAndWait(const std::function<void()>& task);
+  // 共享线程池模式：下一个到期时间早于已登记的定时器时，向线程池登记定时器（在 Strand 上调用）
+  void ArmTimer();
 
  private:
   std::string name_;
+  StateMachineOptions options_;
   std::atomic_bool running_{false};
   std::atomic_bool initialized_{false};
   std::shared_ptr<StateEventHandler> state_event_handler_;
+  // 符号表（需在组件之前构造）
+  std::unique_ptr<SymbolTable> symbol_table_;
+  // 组件共用的时间轮（需在组件之前构造、之后析构）；THREADED 模式下由定时线程推进，
+  // 其他模式下由 Poll() 或 Strand 上的定时任务推进
+  std::shared_ptr<TimingWheel> timer_wheel_;
   // 组件
   std::unique_ptr<ITransitionManager> transition_manager_;
   std::unique_ptr<IStateManager> state_manager_;
   std::unique_ptr<IConditionManager> condition_manager_;
   std::unique_ptr<IEventHandler> event_handler_;
   std::unique_ptr<IConfigLoader> config_loader_;
+
+  // 共享线程池模式：线程池与本状态机的 Strand
+  std::shared_ptr<SharedExecutor> executor_;
+  std::shared_ptr<Strand> strand_;
+  // 已向线程池登记的最早定时器到期时间（仅在 Strand 上访问）
+  std::chrono::steady_clock::time_point armed_deadline_{
+      std::chrono::steady_clock::time_point::max()};
 };
 
 using FiniteStateMachinePtr = std::shared_ptr<FiniteStateMachine>;
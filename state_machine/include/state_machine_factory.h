@@ -40,7 +40,9 @@ namespace smf {
 
 class StateMachineFactory {
  public:
-  static std::shared_ptr<FiniteStateMachine> CreateStateMachine(const std::string& name);
+  // 创建状态机；同名状态机已存在时直接返回已有实例（忽略 options）
+  static std::shared_ptr<FiniteStateMachine> CreateStateMachine(
+      const std::string& name, const StateMachineOptions& options = StateMachineOptions());
 
   static std::vector<std::string> GetAllStateMachineNames();
 
@@ -48,9 +50,25 @@ class StateMachineFactory {
 
   static std::unordered_map<std::string, std::shared_ptr<FiniteStateMachine>> GetAllStateMachines();
 
+  // 设置 ExecutionMode::SHARED_POOL 状态机共用线程池的工作线程数，
+  // 需在创建第一个该模式的状态机之前调用；0（默认）表示使用硬件并发数
+  static bool SetSharedExecutorThreads(size_t threads);
+
+  // 获取共享线程池，首次调用时创建
+  static std::shared_ptr<SharedExecutor> GetSharedExecutor();
+
+  // 获取 StateMachineOptions::shared_timer_thread 状态机共用的时间轮，首次调用时创建并启动
+  static std::shared_ptr<TimingWheel> GetSharedTimingWheel();
+
  private:
+  static std::shared_ptr<SharedExecutor> GetSharedExecutorLocked();
+  static std::shared_ptr<TimingWheel> GetSharedTimingWheelLocked();
+
   static std::unordered_map<std::string, std::shared_ptr<FiniteStateMachine>> state_machines_;
   static std::mutex mutex_;
+  static std::shared_ptr<SharedExecutor> shared_executor_;
+  static size_t shared_executor_threads_;
+  static std::shared_ptr<TimingWheel> shared_timing_wheel_;
 };
 
 }  // namespace smf
@@ -0,0 +1,162 @@
+/**
+ * @file state_machine_metrics.h
+ * @brief Runtime metrics of a state machine
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @details This file contains the metrics snapshot returned by FiniteStateMachine::GetMetrics()
+ *          and the primitives used to record it: a log-linear latency histogram whose buckets
+ *          are relaxed atomics, and helpers for counters that only one thread writes. Counters
+ *          are always recorded; the latency histograms are recorded only when
+ *          StateMachineOptions::latency_metrics is set, since they read the monotonic clock on
+ *          every event and callback.
+ * @version 1.0.0
+ **/
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2025 xiaokui.hu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "common_define.h"
+
+namespace smf {
+
+// 单调时钟纳秒
+inline std::int64_t MonotonicNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// 只有一个线程（或已串行化的调用方）写入的计数：普通的读后写即可，避免加锁的读-改-写指令
+inline void SingleWriterAdd(std::atomic<std::uint64_t>& counter, std::uint64_t n = 1) {
+  counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+// 多个线程写入的最大值
+inline void UpdateMax(std::atomic<std::uint64_t>& target, std::uint64_t value) {
+  std::uint64_t current = target.load(std::memory_order_relaxed);
+  while (value > current &&
+         !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+  }
+}
+
+// 可复制的 relaxed 原子变量：复制时取当前值，用于需要保持可复制的对象中的统计字段
+template <typename T>
+class RelaxedAtomic {
+ public:
+  RelaxedAtomic() = default;
+  RelaxedAtomic(T value) : value_(value) {}
+  RelaxedAtomic(const RelaxedAtomic& other) : value_(other.Load()) {}
+  RelaxedAtomic& operator=(const RelaxedAtomic& other) {
+    Store(other.Load());
+    return *this;
+  }
+
+  T Load() const { return value_.load(std::memory_order_relaxed); }
+  void Store(T value) { value_.store(value, std::memory_order_relaxed); }
+
+ private:
+  std::atomic<T> value_{};
+};
+
+// 延迟直方图快照（纳秒）：按 2 的幂分段，每段再等分为 kSubBuckets 个桶，
+// 百分位的相对误差不超过 1/kSubBuckets
+struct HistogramSnapshot {
+  static constexpr int kSubBucketBits = 3;
+  static constexpr int kSubBuckets = 1 << kSubBucketBits;
+  static constexpr std::size_t kBucketCount = 64 * kSubBuckets;
+
+  std::array<std::uint64_t, kBucketCount> buckets{};
+  std::uint64_t count{0};
+  std::uint64_t sum{0};
+  std::uint64_t max{0};
+
+  double Mean() const;
+  // 第 percentile（0~100）百分位所在桶的上界（不超过 max）
+  std::uint64_t Percentile(double percentile) const;
+
+  static std::size_t BucketIndex(std::uint64_t value);
+  static std::uint64_t BucketUpperBound(std::size_t index);
+};
+
+// 并发读取的延迟直方图：Record 只能由一个线程（或已串行化的调用方）调用，不分配内存；
+// Snapshot 可从任意线程调用，与 Record 并发时各字段之间可能相差正在记录的样本
+class LatencyHistogram {
+ public:
+  void Record(std::int64_t nanos);
+  void Snapshot(HistogramSnapshot& snapshot) const;
+
+ private:
+  std::array<std::atomic<std::uint64_t>, HistogramSnapshot::kBucketCount> buckets_{};
+  std::atomic<std::uint64_t> sum_{0};
+  std::atomic<std::uint64_t> max_{0};
+};
+
+// 开启延迟统计时记录作用域的耗时，histogram 为空时不读时钟
+class LatencyScope {
+ public:
+  explicit LatencyScope(LatencyHistogram* histogram)
+      : histogram_(histogram), start_(histogram ? MonotonicNanos() : 0) {}
+  ~LatencyScope() {
+    if (histogram_) {
+      histogram_->Record(MonotonicNanos() - start_);
+    }
+  }
+
+  LatencyScope(const LatencyScope&) = delete;
+  LatencyScope& operator=(const LatencyScope&) = delete;
+
+ private:
+  LatencyHistogram* histogram_;
+  std::int64_t start_;
+};
+
+// 状态机运行指标快照（自状态机创建起累计），由 FiniteStateMachine::GetMetrics() 返回
+struct StateMachineMetrics {
+  // 事件
+  std::uint64_t events_enqueued{0};   // 投递到事件处理器的事件数（含内部生成的事件）
+  std::uint64_t events_processed{0};  // 处理完成的事件数
+  std::uint64_t events_dropped{0};    // 停止、回调异常或队列丢弃而未处理的事件数
+  std::uint64_t queue_depth_high_water{0};  // 已投递但尚未处理完的事件数的最大值
+
+  // 条件与转移
+  std::uint64_t condition_updates{0};  // 已应用的条件更新数（含事件定义的同名标志条件）
+  std::uint64_t transitions{0};        // 执行的状态转移数（含消费挂起转移）
+  PendingTransitionStats pending_transitions;
+  InternalEventStats internal_events;
+
+  // 延迟（纳秒），仅在 StateMachineOptions::latency_metrics 开启时记录
+  HistogramSnapshot queue_latency;      // 事件从投递到开始处理的时间
+  HistogramSnapshot callback_duration;  // 每次已设置的用户回调（OnPreEvent/...）的耗时
+};
+
+}  // namespace smf
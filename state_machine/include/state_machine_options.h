@@ -0,0 +1,89 @@
+/**
+ * @file state_machine_options.h
+ * @brief Construction options for a state machine
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @details This file contains the definition of StateMachineOptions, which is passed to
+ *          StateMachineFactory::CreateStateMachine() to select optional runtime strategies of a
+ *          state machine. Default-constructed options keep the original behavior.
+ * @version 1.0.0
+ **/
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2025 xiaokui.hu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace smf {
+
+// 事件队列类型
+enum class EventQueueType {
+  MUTEX,      // 互斥锁保护的无界队列（默认）
+  LOCK_FREE,  // 有界无锁多生产者单消费者环形队列
+};
+
+// 执行模式
+enum class ExecutionMode {
+  THREADED,  // 事件、条件各使用独立线程，全部定时器共用一个时间轮线程（默认）
+  INLINE,    // 不创建后台线程，在调用方线程上同步处理，定时器由 Poll()/RunUntilIdle() 推进
+  SHARED_POOL,  // 不创建专用线程，在工厂持有的共享线程池上以本状态机独占的 Strand 串行处理
+};
+
+// 状态机构造选项
+struct StateMachineOptions {
+  // 启动时将转移规则编译为 [state_id][event_id] 稠密表（CSR），
+  // 转移查找变为一次下标访问，无锁、无分配；代价是启动后不能再 Clear() 转移规则，
+  // 且表大小为 状态数 x 事件数 个偏移量
+  bool compiled_transitions{false};
+
+  // 事件队列类型；多个线程高频投递事件时，LOCK_FREE 可避免入队互斥锁竞争
+  EventQueueType event_queue{EventQueueType::MUTEX};
+  // LOCK_FREE 队列容量（向上取整为 2 的幂），队列满时生产者等待
+  size_t event_queue_capacity{4096};
+
+  // 执行模式；INLINE 下 HandleEvent/SetConditionValue 在调用线程上运行至完成（回调中
+  // 再投递的事件与条件更新在当前处理结束后依次处理），不使用 event_queue 选项。
+  // 调用方需串行化对同一状态机的调用，并在 GetNextDeadline() 到期时调用 Poll()。
+  // SHARED_POOL 下各接口可从任意线程调用：调用被投递到本状态机的 Strand 后立即返回，
+  // 同一状态机的事件保持顺序，不同状态机在线程池中并行；定时器由线程池的定时线程推进。
+  // 线程数见 StateMachineFactory::SetSharedExecutorThreads()
+  ExecutionMode execution{ExecutionMode::THREADED};
+
+  // THREADED 模式下使用工厂持有的共享时间轮线程，而不是每个状态机一个定时线程；
+  // 持续时间条件、状态超时与挂起转移到期的回调都在该线程上执行，应保持简短
+  bool shared_timer_thread{false};
+
+  // 记录事件排队延迟与用户回调耗时的直方图（见 FiniteStateMachine::GetMetrics()）；
+  // 每个事件与回调多读取一到两次单调时钟。计数类指标始终记录，不受此选项影响
+  bool latency_metrics{false};
+
+  // 加载事件与转移配置时读取、解析并校验 JSON 文件的线程数；0 表示
+  // std::thread::hardware_concurrency()，1 表示在调用线程上逐个加载。
+  // 注册仍按文件顺序在调用线程上进行，与线程数无关
+  size_t config_load_threads{0};
+};
+
+}  // namespace smf
@@ -0,0 +1,104 @@
+/**
+ * @file symbol_table.h
+ * @brief Symbol table for interned state, event and condition names
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @details This file contains the definition of the SymbolTable class. The config loader interns
+ *          every state, event and condition name into a dense integer ID at load time, so that the
+ *          runtime paths of the components only deal with IDs. Names are resolved only at API
+ *          boundaries (user events, condition updates, callbacks) and for logging.
+ * @version 1.0.0
+ **/
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2025 xiaokui.hu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "common_define.h"
+
+namespace smf {
+
+// 符号表：在配置加载阶段将名称驻留为稠密整数 ID
+// 线程安全约定：Intern* 只允许在 Freeze() 之前（配置加载阶段）由单个线程调用；
+// Freeze() 之后符号表只读，Find* / Get*Name 可被任意线程无锁并发调用。
+class SymbolTable final {
+ public:
+  SymbolTable();
+  ~SymbolTable() = default;
+  SymbolTable(const SymbolTable&) = delete;
+  SymbolTable& operator=(const SymbolTable&) = delete;
+
+  // 驻留名称，已存在时返回原有 ID；冻结后返回 INVALID_SYMBOL_ID
+  StateId InternState(const std::string& name);
+  EventId InternEvent(const std::string& name);
+  ConditionId InternCondition(const std::string& name);
+
+  // 查找名称对应的 ID，不存在时返回 INVALID_SYMBOL_ID
+  StateId FindState(const std::string& name) const;
+  EventId FindEvent(const std::string& name) const;
+  ConditionId FindCondition(const std::string& name) const;
+
+  // 根据 ID 获取名称，ID 无效时返回空字符串；返回的引用在符号表生命周期内有效
+  const std::string& GetStateName(StateId id) const;
+  const std::string& GetEventName(EventId id) const;
+  const std::string& GetConditionName(ConditionId id) const;
+
+  size_t GetStateCount() const { return states_.Size(); }
+  size_t GetEventCount() const { return events_.Size(); }
+  size_t GetConditionCount() const { return conditions_.Size(); }
+
+  // 冻结符号表（状态机启动时调用），之后不再允许驻留新名称
+  void Freeze() { frozen_ = true; }
+  bool IsFrozen() const { return frozen_; }
+
+ private:
+  // 单一命名空间：名称 <-> ID 双向映射
+  class Namespace {
+   public:
+    SymbolId Intern(const std::string& name);
+    SymbolId Find(const std::string& name) const;
+    const std::string& GetName(SymbolId id) const;
+    size_t Size() const { return names_.size(); }
+
+   private:
+    std::unordered_map<std::string, SymbolId> ids_;
+    std::deque<std::string> names_;  // deque 保证已驻留名称的引用稳定
+  };
+
+  SymbolId Intern(Namespace& ns, const std::string& name, const char* kind);
+
+  Namespace states_;
+  Namespace events_;
+  Namespace conditions_;
+  std::atomic_bool frozen_{false};
+};
+
+}  // namespace smf
@@ -0,0 +1,170 @@
+/**
+ * @file timing_wheel.h
+ * @brief Hierarchical timing wheel shared by the state machine timers
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @details This file contains the definition of the TimingWheel class. Timers are kept in four
+ *          levels of 64 slots each, so arming and cancelling a timer are O(1) and advancing the
+ *          clock only touches the slots that are due. The wheel is driven either by its own
+ *          timer thread (Start) or by the owner calling Advance, and it can be shared by the
+ *          components of one state machine or by every machine of a factory.
+ * @version 1.0.0
+ **/
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2025 xiaokui.hu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace smf {
+
+// 分层时间轮：4 层、每层 64 个槽位，第 0 层每槽一个 tick，上一层每槽覆盖下一层一整圈
+// - 登记与撤销均为 O(1)：定时器节点存放在节点池中，以下标组成槽位内的双向链表
+// - 推进时只访问到期的槽位，空槽通过占用位图跳过；上层槽位到期时逐层下放（cascade）
+// - 到期回调在内部锁之外执行，回调中可以再登记或撤销定时器
+// - 超出 4 层范围（1 ms tick 时约 4.6 小时）的定时器暂存在最高层最远的槽位，下放时重新计算
+class TimingWheel final {
+ public:
+  using Clock = std::chrono::steady_clock;
+  // 定时器 ID：高 32 位为节点代数，低 32 位为节点下标 + 1，节点复用后旧 ID 自动失效
+  using TimerId = std::uint64_t;
+  using Callback = std::function<void()>;
+
+  static constexpr TimerId INVALID_TIMER_ID = 0;
+
+  explicit TimingWheel(Clock::duration tick = std::chrono::milliseconds(1));
+  ~TimingWheel();
+  TimingWheel(const TimingWheel&) = delete;
+  TimingWheel& operator=(const TimingWheel&) = delete;
+
+  // 登记定时器（线程安全），callback 在不早于 deadline 的某次推进中执行一次
+  TimerId Schedule(Clock::time_point deadline, Callback callback);
+
+  // 撤销定时器（线程安全，不阻塞）；回调尚未开始执行时返回 true，之后不会再执行。
+  // 回调已执行、正在执行或 ID 无效时返回 false
+  bool Cancel(TimerId id);
+
+  // 等待正在其他线程上执行的到期回调结束（在回调线程上调用时直接返回）。
+  // 组件停止时先撤销自己的定时器再调用本函数，返回后不会再有该组件的回调在执行
+  void WaitForCallbacks();
+
+  // 推进到 now 并执行所有已到期的回调，返回下一个定时器的触发时间（没有时为 time_point::max()）。
+  // 使用定时线程时由定时线程调用；不可在回调中重入调用
+  Clock::time_point Advance(Clock::time_point now);
+
+  // 下一个定时器的触发时间（按 tick 向上取整），没有定时器时为 time_point::max()
+  Clock::time_point GetNextDeadline() const;
+
+  // 尚未触发的定时器数量
+  size_t Size() const;
+
+  // 启动/停止定时线程；不启动时由调用方按 GetNextDeadline() 调用 Advance()
+  void Start();
+  void Stop();
+  bool IsRunning() const;
+
+ private:
+  static constexpr int kLevels = 4;
+  static constexpr int kSlotBits = 6;
+  static constexpr std::uint64_t kSlots = 1u << kSlotBits;
+  static constexpr std::uint64_t kSlotMask = kSlots - 1;
+  static constexpr std::uint32_t kNil = 0xFFFFFFFFu;
+  // 已到期但尚未执行的定时器所在的链表（Schedule 时已过期，或 Advance 已收集待执行）
+  static constexpr int kDueLevel = -1;
+
+  enum class NodeState : std::uint8_t { FREE, LINKED, FIRING };
+
+  struct Node {
+    Callback callback;
+    std::uint64_t expiry_tick{0};
+    std::uint64_t sequence{0};  // 登记顺序，同一 tick 到期的回调按此顺序执行
+    std::uint32_t generation{1};
+    std::uint32_t prev{kNil};
+    std::uint32_t next{kNil};
+    std::int8_t level{0};
+    std::uint8_t slot{0};
+    NodeState state{NodeState::FREE};
+  };
+
+  std::uint64_t CeilTick(Clock::time_point deadline) const;
+  std::uint64_t FloorTick(Clock::time_point now) const;
+  Clock::time_point TickTime(std::uint64_t tick) const;
+
+  std::uint32_t AllocNode();
+  void FreeNode(std::uint32_t index);
+  // 按到期 tick 放入对应层级的槽位，已到期的放入到期链表
+  void Link(std::uint32_t index);
+  void Unlink(std::uint32_t index);
+  std::uint32_t& Head(int level, std::uint32_t slot);
+  // 把上层槽位中的定时器重新放入下层（now_tick_ 跨过对应层级的整圈时调用）
+  void Cascade();
+  // 把槽位（或到期链表）中的定时器标记为待执行并追加到 firing
+  void CollectSlot(int level, std::uint32_t slot, std::vector<TimerId>& firing);
+  Clock::time_point GetNextDeadlineLocked() const;
+  static TimerId MakeId(std::uint32_t index, std::uint32_t generation) {
+    return (static_cast<TimerId>(generation) << 32) | (static_cast<TimerId>(index) + 1);
+  }
+  void ThreadLoop();
+
+  const Clock::duration tick_;
+  const Clock::time_point origin_;
+
+  mutable std::mutex mutex_;
+  std::vector<Node> nodes_;
+  std::vector<std::uint32_t> free_nodes_;
+  std::uint32_t slots_[kLevels][kSlots];
+  std::uint64_t occupied_[kLevels]{};
+  std::uint32_t due_head_{kNil};
+  // 已处理到的 tick（相对 origin_）
+  std::uint64_t now_tick_{0};
+  // 槽位与到期链表中的定时器数量
+  size_t size_{0};
+  std::uint64_t next_sequence_{0};
+
+  // 正在执行的回调及其线程，用于 WaitForCallbacks()
+  TimerId running_id_{INVALID_TIMER_ID};
+  std::thread::id running_thread_;
+  std::condition_variable callback_cv_;
+
+  // 同一时刻只允许一个线程推进
+  std::mutex advance_mutex_;
+  std::vector<TimerId> firing_;
+
+  // 定时线程
+  bool running_{false};
+  std::thread thread_;
+  std::condition_variable wake_cv_;
+  // 定时线程当前等待到的时间，新定时器更早时才需要唤醒
+  Clock::time_point sleep_until_{Clock::time_point::max()};
+};
+
+}  // namespace smf
@@ -0,0 +1,149 @@
+/**
+ * @file binary_log.cpp
+ * @brief Implementation of the binary log decoder
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @details This file contains the implementation of DecodeBinaryLog.
+ * @version 1.0.0
+ **/
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2025 xiaokui.hu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "binary_log.h"
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "log_record.h"
+
+namespace smf {
+
+namespace {
+
+struct CallSiteInfo {
+  std::string file;
+  std::string format;
+  std::uint32_t line = 0;
+};
+
+}  // namespace
+
+bool DecodeBinaryLog(std::istream& in, std::ostream& out, bool json) {
+  std::vector<CallSiteInfo> sites;
+  std::string payload;
+  std::string line;
+  std::string thread;
+  std::string unknown_site;
+  LogLineFormatter formatter;
+  bool has_file_header = false;
+  while (true) {
+    char magic[sizeof(kBinaryLogMagic)];
+    if (!in.read(magic, sizeof(magic))) {
+      return in.gcount() == 0 || has_file_header;
+    }
+    if (std::memcmp(magic, kBinaryLogMagic, sizeof(magic)) == 0) {
+      // 文件头（文件开头或追加写入的新进程）：调用点 ID 重新编号
+      std::uint32_t version = 0;
+      if (!in.read(reinterpret_cast<char*>(&version), sizeof(version))) {
+        return has_file_header;
+      }
+      if (version == 0 || version > kBinaryLogVersion) {
+        return false;
+      }
+      has_file_header = true;
+      sites.clear();
+      continue;
+    }
+    if (!has_file_header) {
+      return false;
+    }
+
+    BinaryLogRecordHeader header;
+    std::memcpy(&header, magic, sizeof(magic));
+    char* rest = reinterpret_cast<char*>(&header) + sizeof(magic);
+    if (!in.read(rest, sizeof(header) - sizeof(magic))) {
+      return true;
+    }
+    if (header.size < sizeof(header)) {
+      return false;
+    }
+    payload.resize(header.size - sizeof(header));
+    if (!in.read(&payload[0], static_cast<std::streamsize>(payload.size()))) {
+      return true;
+    }
+
+    switch (static_cast<BinaryLogRecordType>(header.type)) {
+      case BinaryLogRecordType::CALL_SITE: {
+        if (payload.size() < sizeof(std::uint32_t)) {
+          return false;
+        }
+        if (sites.size() <= header.site_id) {
+          sites.resize(header.site_id + 1);
+        }
+        CallSiteInfo& site = sites[header.site_id];
+        std::memcpy(&site.line, payload.data(), sizeof(std::uint32_t));
+        std::string rest = payload.substr(sizeof(std::uint32_t));
+        size_t separator = rest.find('\0');
+        site.file = rest.substr(0, separator);
+        site.format = separator == std::string::npos ? std::string() : rest.substr(separator + 1);
+        break;
+      }
+      case BinaryLogRecordType::MESSAGE:
+      case BinaryLogRecordType::MESSAGE_ARGS: {
+        LogRecordView record;
+        record.level = header.level;
+        record.timestamp_ms = header.timestamp_ns / 1000000;
+        if (header.site_id < sites.size()) {
+          record.file = sites[header.site_id].file;
+          record.line = sites[header.site_id].line;
+          if (header.type == static_cast<std::uint16_t>(BinaryLogRecordType::MESSAGE_ARGS)) {
+            record.format = sites[header.site_id].format;
+          }
+        } else {
+          unknown_site = "<site " + std::to_string(header.site_id) + ">";
+          record.file = unknown_site;
+        }
+        thread = "T" + std::to_string(header.thread_index);
+        record.thread = thread;
+        record.data = payload;
+        line.clear();
+        if (json) {
+          formatter.AppendJson(&line, record);
+        } else {
+          formatter.AppendText(&line, record, false);
+        }
+        line.push_back('\n');
+        out.write(line.data(), static_cast<std::streamsize>(line.size()));
+        break;
+      }
+      default:
+        return false;
+    }
+  }
+}
+
+}  // namespace smf
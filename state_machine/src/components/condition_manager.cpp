@@ -38,10 +38,15 @@
 #include <algorithm>
 
 #include "logger.h"
+#include "state_machine_metrics.h"
 
 namespace smf {
 
-ConditionManager::ConditionManager() = default;
+ConditionManager::ConditionManager(const SymbolTable* symbol_table, TimingWheel* timer_wheel,
+                                   bool inline_execution)
+    : symbol_table_(symbol_table),
+      timer_wheel_(timer_wheel),
+      inline_execution_(inline_execution) {}
 
 ConditionManager::~ConditionManager() { Stop(); }
 
@@ -49,9 +54,24 @@ void ConditionManager::Start() {
   if (running_) {
     return;
   }
+  {
+    // 为所有已驻留的条件（包括事件同名的触发标记条件）分配值存储
+    // 启动后符号表已冻结，值表大小固定，读取方可无锁访问
+    std::lock_guard<std::mutex> lock(condition_values_mutex_);
+    condition_values_.Reserve(symbol_table_->GetConditionCount(),
+                              std::chrono::steady_clock::now());
+  }
+  {
+    std::lock_guard<std::mutex> lock(timer_mutex_);
+    duration_timers_.assign(symbol_table_->GetConditionCount(), TimingWheel::INVALID_TIMER_ID);
+  }
   running_ = true;
+  if (inline_execution_) {
+    // 启动前设置的条件值在此一并处理
+    DrainConditionUpdates();
+    return;
+  }
   condition_thread_ = std::thread(&ConditionManager::ConditionLoop, this);
-  timer_thread_ = std::thread(&ConditionManager::TimerLoop, this);
 }
 
 void ConditionManager::Stop() {
@@ -63,31 +83,101 @@ void ConditionManager::Stop() {
   if (condition_thread_.joinable()) {
     condition_thread_.join();
   }
-  timer_cv_.notify_all();
-  if (timer_thread_.joinable()) {
-    timer_thread_.join();
+  // 撤销全部持续时间定时器，并等待可能正在执行的到期回调结束
+  std::vector<TimingWheel::TimerId> timers;
+  {
+    std::lock_guard<std::mutex> lock(timer_mutex_);
+    timers.swap(duration_timers_);
+  }
+  for (TimingWheel::TimerId id : timers) {
+    if (id != TimingWheel::INVALID_TIMER_ID) {
+      timer_wheel_->Cancel(id);
+    }
   }
+  timer_wheel_->WaitForCallbacks();
 }
 
 bool ConditionManager::IsRunning() const { return running_; }
 
 void ConditionManager::SetConditionValue(const std::string& name, int value) {
+  ConditionId id = symbol_table_->FindCondition(name);
+  if (id == INVALID_SYMBOL_ID) {
+    SMF_LOG(LogLevel::WARN, "Condition is not defined in config: {}, value ignored", name);
+    return;
+  }
+  SetConditionValue(id, value);
+}
+
+void ConditionManager::SetConditionValue(ConditionId id, int value) {
+  if (running_ && !condition_values_.Contains(id)) {
+    SMF_LOG(LogLevel::WARN, "Condition id is out of range: {}, value ignored", id);
+    return;
+  }
   {
     std::lock_guard<std::mutex> lock(condition_update_mutex_);
-    condition_update_queue_.push({name, value, std::chrono::steady_clock::now()});
+    condition_update_queue_.push_back({id, value, std::chrono::steady_clock::now(), 1});
+  }
+  if (inline_execution_) {
+    if (running_) {
+      DrainConditionUpdates();
+    }
+    return;
   }
   condition_update_cv_.notify_one();
 }
 
-bool ConditionManager::CheckConditions(const std::vector<ConditionSharedPtr>& conditions,
-                                       const std::string& op,
-                                       std::vector<ConditionInfo>& condition_infos) {
-  std::unordered_map<std::string, ConditionValue> values_copy;
+void ConditionManager::SetConditionValues(const std::vector<std::pair<std::string, int>>& values) {
+  std::vector<std::pair<ConditionId, int>> resolved;
+  resolved.reserve(values.size());
+  for (const auto& entry : values) {
+    ConditionId id = symbol_table_->FindCondition(entry.first);
+    if (id == INVALID_SYMBOL_ID) {
+      SMF_LOG(LogLevel::WARN, "Condition is not defined in config: {}, value ignored", entry.first);
+      continue;
+    }
+    resolved.emplace_back(id, entry.second);
+  }
+  SetConditionValues(resolved);
+}
+
+void ConditionManager::SetConditionValues(const std::vector<std::pair<ConditionId, int>>& values) {
+  std::uint32_t frame_size = 0;
+  for (const auto& entry : values) {
+    if (running_ && !condition_values_.Contains(entry.first)) {
+      SMF_LOG(LogLevel::WARN, "Condition id is out of range: {}, value ignored", entry.first);
+      continue;
+    }
+    ++frame_size;
+  }
+  if (frame_size == 0) {
+    return;
+  }
   {
-    std::lock_guard<std::mutex> lock(condition_values_mutex_);
-    values_copy = condition_values_;
+    // 一帧的更新在同一次加锁内连续入队，处理时整体取出
+    std::lock_guard<std::mutex> lock(condition_update_mutex_);
+    const auto now = std::chrono::steady_clock::now();
+    bool first = true;
+    for (const auto& entry : values) {
+      if (running_ && !condition_values_.Contains(entry.first)) {
+        continue;
+      }
+      condition_update_queue_.push_back(
+          {entry.first, entry.second, now, first ? frame_size : 0});
+      first = false;
+    }
   }
+  if (inline_execution_) {
+    if (running_) {
+      DrainConditionUpdates();
+    }
+    return;
+  }
+  condition_update_cv_.notify_one();
+}
 
+bool ConditionManager::CheckConditions(const std::vector<ConditionSharedPtr>& conditions,
+                                       const std::string& op,
+                                       std::vector<ConditionInfo>& condition_infos) {
   if (conditions.empty()) {
     return true;
   }
@@ -95,111 +185,111 @@ bool ConditionManager::CheckConditions(const std::vector<ConditionSharedPtr>& co
   if (op != "AND" && op != "OR") {
     throw std::invalid_argument("Invalid operator: " + op);
   }
+  const bool isAnd = (op == "AND");
 
   condition_infos.clear();
   auto now = std::chrono::steady_clock::now();
 
+  // 只读取被引用的条件，逐个槽位无锁读取，不复制整张值表；
+  // 无持续时间的条件只访问值列
+  int value;
+  std::chrono::steady_clock::time_point changed;
   for (const auto& cond : conditions) {
-    auto it = values_copy.find(cond->name);
-    if (it == values_copy.end()) {
+    bool found = cond->duration > 0 ? condition_values_.ReadChanged(cond->id, value, changed)
+                                    : condition_values_.Read(cond->id, value);
+    if (!found) {
       throw std::invalid_argument("Condition value not set: " + cond->name);
     }
 
-    int value = it->second.value;
     bool valueInRange = cond->IsValueInRange(value);
 
     // 检查持续时间
     if (cond->duration > 0 && valueInRange) {
       auto elapsed =
-          std::chrono::duration_cast<std::chrono::milliseconds>(now - it->second.lastChangedTime)
-              .count();
+          std::chrono::duration_cast<std::chrono::milliseconds>(now - changed).count();
       valueInRange = (elapsed >= cond->duration);
       if (valueInRange) {
         condition_infos.push_back({cond->name, value, elapsed});
       }
     }
 
-    if (op == "AND" && !valueInRange) {
+    if (isAnd && !valueInRange) {
       condition_infos.clear();
       return false;
-    } else if (op == "OR" && valueInRange) {
+    } else if (!isAnd && valueInRange) {
       return true;
     }
   }
 
-  return (op == "AND");
+  return isAnd;
 }
 
 bool ConditionManager::CheckConditionRef(const ConditionRef& ref,
-                                         const std::unordered_map<std::string, ConditionValue>& values_copy,
-                                         ConditionInfo& info) {
-  auto it = values_copy.find(ref.name);
-  if (it == values_copy.end()) {
-    SMF_LOGW("Condition value not set for expression: " + ref.name + ", treating as not satisfied");
+                                         std::chrono::steady_clock::time_point now,
+                                         std::vector<ConditionInfo>& condition_infos) const {
+  if (!condition_values_.Contains(ref.id)) {
+    SMF_LOG(LogLevel::WARN, "Condition value not set for expression: {}, treating as not satisfied",
+            ref.name);
     return ref.negated;  // 如果条件不存在，未取反时返回 false，取反时返回 true
   }
 
-  int value = it->second.value;
-  bool satisfied = false;
-
-  // 查找该条件名称对应的 Condition 定义
-  bool found = false;
-  for (const auto& cond : all_conditions_) {
-    if (cond->name == ref.name) {
-      found = true;
-      satisfied = cond->IsValueInRange(value);
+  // 使用该条件 ID 的第一个 Condition 定义（启动后只读，无需加锁）
+  bool found = ref.id < condition_defs_.size() && !condition_defs_[ref.id].empty();
+  if (!found) {
+    SMF_LOG(LogLevel::WARN,
+            "Condition definition not found for: {}, treating as not satisfied. Make sure the "
+            "condition is defined via AddCondition().",
+            ref.name);
+    return ref.negated;
+  }
 
-      // 检查持续时间
-      if (cond->duration > 0 && satisfied) {
-        auto now = std::chrono::steady_clock::now();
-        auto elapsed =
-            std::chrono::duration_cast<std::chrono::milliseconds>(now - it->second.lastChangedTime)
-                .count();
-        satisfied = (elapsed >= cond->duration);
-        if (satisfied) {
-          info = {ref.name, value, elapsed};
-        }
-      } else if (satisfied) {
-        info = {ref.name, value, 0};
-      }
-      break;
-    }
+  const auto& cond = condition_defs_[ref.id].front();
+  // 无持续时间的条件只访问值列
+  int value;
+  std::chrono::steady_clock::time_point changed;
+  if (cond->duration > 0) {
+    condition_values_.ReadChanged(ref.id, value, changed);
+  } else {
+    value = condition_values_.ReadValue(ref.id);
   }
+  bool satisfied = cond->IsValueInRange(value);
+  long elapsed = 0;
 
-  // 如果条件定义未找到，记录警告
-  if (!found) {
-    SMF_LOGW("Condition definition not found for: " + ref.name +
-             ", treating as not satisfied. Make sure the condition is defined via AddCondition().");
+  // 检查持续时间
+  if (cond->duration > 0 && satisfied) {
+    elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - changed).count();
+    satisfied = (elapsed >= cond->duration);
   }
 
-  // 应用取反逻辑
+  // 应用取反逻辑：取反后的满足不记录条件信息
   if (ref.negated) {
-    satisfied = !satisfied;
+    return !satisfied;
+  }
+  if (satisfied) {
+    condition_infos.push_back({ref.name, value, elapsed});
   }
-
   return satisfied;
 }
 
-bool ConditionManager::CheckSingleConditionExpr(
-    const ConditionExprSharedPtr& expr,
-    const std::unordered_map<std::string, ConditionValue>& values_copy,
-    std::vector<ConditionInfo>& condition_infos) {
-  
+bool ConditionManager::CheckSingleConditionExpr(const ConditionExprSharedPtr& expr,
+                                                std::vector<ConditionInfo>& condition_infos) const {
   if (!expr || !expr->IsValid()) {
     SMF_LOGE("Invalid condition expression");
     return false;
   }
 
+  if (!expr->program.Empty()) {
+    return RunConditionProgram(expr->program, condition_infos);
+  }
+
   if (expr->conditions.empty()) {
     return true;
   }
 
+  auto now = std::chrono::steady_clock::now();
+
   // 检查第一个条件
-  ConditionInfo firstInfo;
-  bool result = CheckConditionRef(expr->conditions[0], values_copy, firstInfo);
-  if (result && firstInfo.name.length() > 0) {
-    condition_infos.push_back(firstInfo);
-  }
+  bool result = CheckConditionRef(expr->conditions[0], now, condition_infos);
 
   // 按顺序依次处理后续条件和操作符
   // 例如: A OR B AND C
@@ -207,58 +297,136 @@ bool ConditionManager::CheckSingleConditionExpr(
   // 再计算 result1 AND C = final
   for (size_t i = 0; i < expr->operators.size(); ++i) {
     const auto& op = expr->operators[i];
-    const auto& nextRef = expr->conditions[i + 1];
-    
-    ConditionInfo nextInfo;
-    bool nextResult = CheckConditionRef(nextRef, values_copy, nextInfo);
-    
+    bool nextResult = CheckConditionRef(expr->conditions[i + 1], now, condition_infos);
+
     if (op == "AND") {
       result = result && nextResult;
     } else if (op == "OR") {
       result = result || nextResult;
     } else {
-      SMF_LOGE("Invalid operator in condition expression: " + op);
+      SMF_LOG(LogLevel::ERROR, "Invalid operator in condition expression: {}", op);
       return false;
     }
-    
-    if (nextResult && nextInfo.name.length() > 0) {
-      condition_infos.push_back(nextInfo);
+  }
+
+  return result;
+}
+
+bool ConditionManager::RunConditionProgram(const ConditionProgram& program,
+                                           std::vector<ConditionInfo>& condition_infos) const {
+  const auto now =
+      program.needs_clock ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+  bool result = false;
+  std::chrono::steady_clock::time_point changed;
+  for (size_t i = 0; i < program.terms.size(); ++i) {
+    const auto& term = program.terms[i];
+    bool satisfied;
+    int value;
+    long elapsed = 0;
+    if (term.duration > 0) {
+      // 持续时间条件需要值与变化时间的一致快照
+      if (!condition_values_.ReadChanged(term.id, value, changed)) {
+        SMF_LOG(LogLevel::WARN,
+                "Condition value not set for expression: {}, treating as not satisfied",
+                *term.name);
+        satisfied = false;
+        value = 0;
+      } else {
+        satisfied = program.InRange(term, value);
+        if (satisfied) {
+          elapsed =
+              std::chrono::duration_cast<std::chrono::milliseconds>(now - changed).count();
+          satisfied = elapsed >= term.duration;
+        }
+      }
+    } else {
+      value = condition_values_.ReadValue(term.id);
+      satisfied = program.InRange(term, value);
+    }
+
+    // 取反后的满足不记录条件信息
+    if (term.negated) {
+      satisfied = !satisfied;
+    } else if (satisfied) {
+      condition_infos.push_back({*term.name, value, elapsed});
+    }
+
+    if (i == 0) {
+      result = satisfied;
+    } else if (term.op == LogicOp::AND) {
+      result = result && satisfied;
+    } else {
+      result = result || satisfied;
     }
   }
+  return result;
+}
 
-  // 如果最终结果为 false，清空条件信息
-  if (!result) {
-    condition_infos.clear();
+bool ConditionManager::CompileConditionExpr(ConditionExpr& expr) const {
+  if (!expr.IsValid()) {
+    SMF_LOGE("Invalid condition expression");
+    return false;
   }
 
-  return result;
+  std::lock_guard<std::mutex> lock(condition_values_mutex_);
+  ConditionProgram program;
+  program.terms.reserve(expr.conditions.size());
+  for (size_t i = 0; i < expr.conditions.size(); ++i) {
+    const auto& ref = expr.conditions[i];
+    // 与解释执行一致：使用该条件 ID 的第一个定义
+    if (ref.id >= condition_defs_.size() || condition_defs_[ref.id].empty()) {
+      SMF_LOG(LogLevel::ERROR, "Condition definition not found for: {}", ref.name);
+      return false;
+    }
+    const auto& cond = condition_defs_[ref.id].front();
+
+    ConditionProgram::Term term;
+    term.name = &symbol_table_->GetConditionName(ref.id);
+    term.id = ref.id;
+    term.duration = cond->duration;
+    term.negated = ref.negated;
+    if (i > 0) {
+      const auto& op = expr.operators[i - 1];
+      if (op == "AND") {
+        term.op = LogicOp::AND;
+      } else if (op == "OR") {
+        term.op = LogicOp::OR;
+      } else {
+        SMF_LOG(LogLevel::ERROR, "Invalid operator in condition expression: {}", op);
+        return false;
+      }
+    }
+
+    // 范围按下界排序并合并重叠区间后展开到程序的范围数组中
+    RangeSet ranges(cond->range_values);
+    term.range_begin = static_cast<std::uint32_t>(program.range_mins.size());
+    program.range_mins.insert(program.range_mins.end(), ranges.Mins().begin(), ranges.Mins().end());
+    program.range_maxs.insert(program.range_maxs.end(), ranges.Maxs().begin(), ranges.Maxs().end());
+    term.range_end = static_cast<std::uint32_t>(program.range_mins.size());
+    program.needs_clock = program.needs_clock || term.duration > 0;
+    program.terms.push_back(term);
+  }
+
+  expr.program = std::move(program);
+  return true;
 }
 
 bool ConditionManager::CheckConditionExprs(const std::vector<ConditionExprSharedPtr>& condition_exprs,
                                            std::vector<ConditionInfo>& condition_infos) {
-  std::unordered_map<std::string, ConditionValue> values_copy;
-  {
-    std::lock_guard<std::mutex> lock(condition_values_mutex_);
-    values_copy = condition_values_;
-  }
-
   if (condition_exprs.empty()) {
     return true;
   }
 
-  condition_infos.clear();
-
   // 多个表达式之间是 OR 关系，满足任意一个即可
+  // 直接在输出参数上累积条件信息，不满足时清空后继续，避免临时容器
   for (const auto& expr : condition_exprs) {
-    std::vector<ConditionInfo> expr_infos;
-    if (CheckSingleConditionExpr(expr, values_copy, expr_infos)) {
-      condition_infos = std::move(expr_infos);
-      SMF_LOGD("Condition expression satisfied");
+    condition_infos.clear();
+    if (CheckSingleConditionExpr(expr, condition_infos)) {
       return true;
     }
   }
 
-  SMF_LOGD("No condition expression satisfied");
+  condition_infos.clear();
   return false;
 }
 
@@ -267,37 +435,47 @@ void ConditionManager::AddCondition(const ConditionSharedPtr& condition) {
     SMF_LOGE("Cannot add condition while running");
     return;
   }
+  if (condition->id == INVALID_SYMBOL_ID) {
+    SMF_LOG(LogLevel::ERROR, "Condition id is not assigned: {}", condition->name);
+    return;
+  }
+  // 手动构造的条件可能未生成有序范围集合
+  condition->CompileRanges();
   std::lock_guard<std::mutex> lock(condition_values_mutex_);
-  all_conditions_.push_back(condition);
-
-  // 初始化条件值
-  if (condition_values_.find(condition->name) == condition_values_.end()) {
-    auto now = std::chrono::steady_clock::now();
-    condition_values_[condition->name] = {condition->name,
-                                         0,  // 初始值
-                                         now, now};
+  if (condition_defs_.size() <= condition->id) {
+    condition_defs_.resize(condition->id + 1);
+    range_batches_.resize(condition->id + 1);
   }
+  condition_defs_[condition->id].push_back(condition);
+  range_batches_[condition->id].Add(condition->range_set);
+  range_hits_.resize(std::max(range_hits_.size(), condition_defs_[condition->id].size()));
+
+  // 初始化条件值为 0
+  condition_values_.Reserve(condition->id + 1, std::chrono::steady_clock::now());
 }
 
 bool ConditionManager::HasCondition(const std::string& name) const {
+  ConditionId id = symbol_table_->FindCondition(name);
   std::lock_guard<std::mutex> lock(condition_values_mutex_);
-  for (const auto& cond : all_conditions_) {
-    if (cond->name == name) {
-      return true;
-    }
-  }
-  return false;
+  return id < condition_defs_.size() && !condition_defs_[id].empty();
 }
 
 void ConditionManager::GetConditionValue(const std::string& name, int& value) const {
-  std::lock_guard<std::mutex> lock(condition_values_mutex_);
-  auto it = condition_values_.find(name);
-  if (it != condition_values_.end()) {
-    value = it->second.value;
-  } else {
+  ConditionId id = symbol_table_->FindCondition(name);
+  if (id == INVALID_SYMBOL_ID) {
     value = 0;
-    SMF_LOGW("Condition value not set: " + name + ", return 0");
+    SMF_LOG(LogLevel::WARN, "Condition value not set: {}, return 0", name);
+    return;
   }
+  value = GetConditionValue(id);
+}
+
+int ConditionManager::GetConditionValue(ConditionId id) const {
+  return condition_values_.ReadValue(id);
+}
+
+std::uint64_t ConditionManager::GetConditionUpdateCount() const {
+  return condition_updates_.load(std::memory_order_relaxed);
 }
 
 void ConditionManager::RegisterConditionChangeCallback(ConditionChangeCallback callback) {
@@ -309,6 +487,37 @@ void ConditionManager::RegisterConditionChangeCallback(ConditionChangeCallback c
   condition_change_callback_ = std::move(callback);
 }
 
+void ConditionManager::RegisterConditionFrameCallback(ConditionFrameCallback callback) {
+  if (running_) {
+    SMF_LOGE("Cannot register condition frame callback while running");
+    return;
+  }
+  std::lock_guard<std::mutex> lock(callback_mutex_);
+  condition_frame_callback_ = std::move(callback);
+}
+
+void ConditionManager::DrainConditionUpdates() {
+  if (draining_) {
+    return;
+  }
+  draining_ = true;
+  try {
+    for (;;) {
+      {
+        std::lock_guard<std::mutex> lock(condition_update_mutex_);
+        if (condition_update_queue_.empty()) {
+          break;
+        }
+      }
+      ProcessConditionUpdates();
+    }
+  } catch (...) {
+    draining_ = false;
+    throw;
+  }
+  draining_ = false;
+}
+
 void ConditionManager::ConditionLoop() {
   while (running_) {
     {
@@ -325,125 +534,175 @@ void ConditionManager::ConditionLoop() {
   }
 }
 
-void ConditionManager::TimerLoop() {
-  while (running_) {
-    // 局部变量用于存储过期条件
-    DurationCondition expiredCondition;
-    bool hasExpiredCondition = false;
-    std::chrono::steady_clock::time_point nextWaitTime;
-    {
-      std::unique_lock<std::mutex> lock(timer_mutex_);
-
-      // 如果队列为空，等待通知
-      if (timer_queue_.empty()) {
-        timer_cv_.wait(lock, [this] { return !running_ || !timer_queue_.empty(); });
-        if (!running_) {
-          break;
-        }
-        if (timer_queue_.empty()) {
-          continue;
-        }
-      }
+void ConditionManager::RearmDurationTimer(const DurationCondition& timer) {
+  TimingWheel::TimerId armed = TimingWheel::INVALID_TIMER_ID;
+  if (timer.duration > 0 && running_) {
+    armed = timer_wheel_->Schedule(timer.expiryTime, [this, timer] { OnDurationTimer(timer); });
+  }
+  TimingWheel::TimerId stale = TimingWheel::INVALID_TIMER_ID;
+  {
+    std::lock_guard<std::mutex> lock(timer_mutex_);
+    if (timer.id < duration_timers_.size()) {
+      stale = duration_timers_[timer.id];
+      duration_timers_[timer.id] = armed;
+    }
+  }
+  // 旧定时器记录的值已不是当前值，到期也不会满足，撤销而不是留在时间轮中等到期
+  if (stale != TimingWheel::INVALID_TIMER_ID) {
+    timer_wheel_->Cancel(stale);
+  }
+}
 
-      auto now = std::chrono::steady_clock::now();
+void ConditionManager::OnDurationTimer(const DurationCondition& timer) {
+  if (!running_) {
+    return;
+  }
+  if (!inline_execution_) {
+    HandleExpiredTimer(timer);
+    return;
+  }
+  // 同步执行模式：到期回调中产生的条件更新（事件同名标记条件）推迟到回调结束后再处理，
+  // 避免在持有回调锁时重入条件变化回调，且与线程模式下定时与条件分开处理的顺序一致
+  const bool nested = draining_;
+  draining_ = true;
+  try {
+    HandleExpiredTimer(timer);
+  } catch (...) {
+    draining_ = nested;
+    throw;
+  }
+  draining_ = nested;
+  if (!nested) {
+    DrainConditionUpdates();
+  }
+}
 
-      // 检查队首定时器是否到期
-      if (now >= timer_queue_.top().expiryTime) {
-        // 复制一份数据，然后立即释放锁
-        expiredCondition = timer_queue_.top();
-        timer_queue_.pop();
-        hasExpiredCondition = true;
-      } else {
-        // 如果没有到期，设置等待时间
-        nextWaitTime = timer_queue_.top().expiryTime;
-        // 释放锁并等待到下一个到期时间
-        timer_cv_.wait_until(lock, nextWaitTime);
-        continue;
-      }
-    }
-    bool expired = false;
-    // 处理过期的条件
-    if (hasExpiredCondition) {
-      auto now = std::chrono::steady_clock::now();
-      SMF_LOGD("Duration condition expired: " + expiredCondition.name + " with value " +
-               std::to_string(expiredCondition.value));
-
-      // 检查条件是否仍然满足
-      std::lock_guard<std::mutex> condLock(condition_values_mutex_);
-      auto it = condition_values_.find(expiredCondition.name);
-      if (it != condition_values_.end()) {
-        auto& condValue = it->second;
-        auto elapsed =
-            std::chrono::duration_cast<std::chrono::milliseconds>(now - condValue.lastChangedTime)
-                .count();
-        if (condValue.value == expiredCondition.value && elapsed >= expiredCondition.duration) {
-          expired = true;
-          SMF_LOGI("Duration condition triggered: " + expiredCondition.name + " with value " +
-                   std::to_string(expiredCondition.value));
-        }
-      }
+void ConditionManager::HandleExpiredTimer(const DurationCondition& timer) {
+  auto now = std::chrono::steady_clock::now();
+  const std::string& conditionName = symbol_table_->GetConditionName(timer.id);
+  SMF_LOG(LogLevel::DEBUG, "Duration condition expired: {} with value {}", conditionName,
+          timer.value);
+
+  // 检查条件是否仍然满足
+  bool expired = false;
+  int value;
+  std::chrono::steady_clock::time_point changed;
+  if (condition_values_.ReadChanged(timer.id, value, changed)) {
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - changed).count();
+    if (value == timer.value && elapsed >= timer.duration) {
+      expired = true;
+      SMF_LOG(LogLevel::INFO, "Duration condition triggered: {} with value {}", conditionName,
+              timer.value);
     }
+  }
 
-    // 如果条件满足，触发事件检查
-    if (expired) {
-      NotifyConditionChange(expiredCondition.name, expiredCondition.value,
-                            expiredCondition.duration, true);
-    }
+  // 如果条件满足，触发事件检查
+  if (expired) {
+    NotifyConditionChange(timer.id, timer.value, timer.duration, true);
   }
 }
 
 void ConditionManager::ProcessConditionUpdates() {
-  std::queue<ConditionUpdateEvent> updates;
+  // 只在处理条件更新的线程上访问（同步执行模式下由 draining_ 防止重入）
+  std::vector<ConditionUpdateEvent>& updates = processing_updates_;
+  updates.clear();
   {
     std::lock_guard<std::mutex> lock(condition_update_mutex_);
     updates.swap(condition_update_queue_);
   }
 
-  while (!updates.empty()) {
-    const auto& update = updates.front();
-    bool hasDurationCondition = false;
-    bool valueInRange = false;
+  size_t next = 0;
+  while (next < updates.size()) {
+    // 一帧的全部更新在一次加锁内写入，之后统一登记定时器并通知，
+    // 事件处理器看到变化时帧内的值都已生效
+    std::uint32_t frame = std::max<std::uint32_t>(updates[next].frameSize, 1);
+    frame_timers_.clear();
+    frame_changes_.clear();
+    std::uint64_t applied = 0;
     {
       std::lock_guard<std::mutex> lock(condition_values_mutex_);
-      if (condition_values_.find(update.name) == condition_values_.end()) {
-        condition_values_[update.name] = {update.name, update.value, update.updateTime,
-                                          update.updateTime};
-      } else {
-        auto oldValue = condition_values_[update.name].value;
-        condition_values_[update.name].value = update.value;
-        condition_values_[update.name].lastUpdateTime = update.updateTime;
-        if (oldValue != update.value) {
-          condition_values_[update.name].lastChangedTime = update.updateTime;
-          // 检查是否满足任何条件的范围要求
-          for (const auto& cond : all_conditions_) {
-            if (cond->name == update.name) {
-              valueInRange = cond->IsValueInRange(update.value);
-              if (cond->duration > 0 && valueInRange) {
-                hasDurationCondition = true;
-                std::lock_guard<std::mutex> timerLock(timer_mutex_);
-                auto expiryTime = update.updateTime + std::chrono::milliseconds(cond->duration);
-                timer_queue_.push({update.name, update.value, cond->duration, expiryTime});
-                timer_cv_.notify_one();
-                break;
-              }
-            }
-          }
+      for (; frame > 0 && next < updates.size(); --frame, ++next) {
+        const auto& update = updates[next];
+        DurationCondition timer{update.id, update.value, 0, update.updateTime};
+        bool rearm = false;
+        bool valueInRange = false;
+        if (!ApplyConditionUpdate(update, timer, rearm, valueInRange)) {
+          continue;
+        }
+        ++applied;
+        if (rearm) {
+          frame_timers_.push_back(timer);
+        }
+        if (timer.duration == 0) {
+          frame_changes_.push_back({update.id, update.value, 0, valueInRange});
         }
       }
     }
-    if (!hasDurationCondition) {
-      NotifyConditionChange(update.name, update.value, 0, valueInRange);
+    SingleWriterAdd(condition_updates_, applied);
+    for (const auto& timer : frame_timers_) {
+      RearmDurationTimer(timer);
+    }
+    if (frame_changes_.size() == 1) {
+      const auto& change = frame_changes_.front();
+      NotifyConditionChange(change.id, change.value, change.duration, change.inRange);
+    } else if (!frame_changes_.empty()) {
+      NotifyConditionFrame(frame_changes_);
     }
+  }
+}
 
-    updates.pop();
+bool ConditionManager::ApplyConditionUpdate(const ConditionUpdateEvent& update,
+                                            DurationCondition& timer, bool& rearm,
+                                            bool& in_range) {
+  ConditionValue condValue;
+  if (!condition_values_.Read(update.id, condValue)) {
+    return false;
+  }
+  auto oldValue = condValue.value;
+  condValue.value = update.value;
+  condValue.lastUpdateTime = update.updateTime;
+  if (oldValue != update.value) {
+    condValue.lastChangedTime = update.updateTime;
+  }
+  condition_values_.Write(update.id, condValue);
+  rearm = oldValue != update.value;
+  if (rearm) {
+    // 检查是否满足任何条件的范围要求：一次扫描得到新值对该 ID 下所有定义的判断结果
+    if (update.id < condition_defs_.size()) {
+      const auto& defs = condition_defs_[update.id];
+      range_batches_[update.id].Contains(update.value, range_hits_.data());
+      for (size_t i = 0; i < defs.size(); ++i) {
+        const auto& cond = defs[i];
+        in_range = range_hits_[i] != 0;
+        if (cond->duration > 0 && in_range) {
+          timer.duration = cond->duration;
+          timer.expiryTime = update.updateTime + std::chrono::milliseconds(cond->duration);
+          break;
+        }
+      }
+    }
   }
+  return true;
 }
 
-void ConditionManager::NotifyConditionChange(const std::string& name, int value, int duration,
+void ConditionManager::NotifyConditionChange(ConditionId id, int value, int duration,
                                              bool meetsCondition) {
   std::lock_guard<std::mutex> lock(callback_mutex_);
   if (condition_change_callback_) {
-    condition_change_callback_(name, value, duration, meetsCondition);
+    condition_change_callback_(id, value, duration, meetsCondition);
+  }
+}
+
+void ConditionManager::NotifyConditionFrame(const std::vector<ConditionChange>& changes) {
+  std::lock_guard<std::mutex> lock(callback_mutex_);
+  if (condition_frame_callback_) {
+    condition_frame_callback_(changes);
+    return;
+  }
+  if (condition_change_callback_) {
+    for (const auto& change : changes) {
+      condition_change_callback_(change.id, change.value, change.duration, change.inRange);
+    }
   }
 }
 
@@ -35,6 +35,7 @@
 
 #include "components/config_loader.h"
 
+#include <algorithm>
 #include <chrono>
 #include <fstream>
 #include <thread>
@@ -48,19 +49,34 @@
 
 namespace smf {
 
-ConfigLoader::ConfigLoader(IStateManager* state_manager, IConditionManager* condition_manager,
-                           ITransitionManager* transition_manager, IEventHandler* event_handler)
-    : state_manager_(state_manager),
+namespace {
+
+// 每个加载线程至少分到的文件数，文件较少时不值得启动线程
+constexpr size_t kMinFilesPerLoadThread = 8;
+
+}  // namespace
+
+ConfigLoader::ConfigLoader(SymbolTable* symbol_table, IStateManager* state_manager,
+                           IConditionManager* condition_manager,
+                           ITransitionManager* transition_manager, IEventHandler* event_handler,
+                           size_t load_threads)
+    : symbol_table_(symbol_table),
+      state_manager_(state_manager),
       condition_manager_(condition_manager),
       transition_manager_(transition_manager),
-      event_handler_(event_handler) {}
+      event_handler_(event_handler),
+      load_threads_(load_threads) {}
 
 ConfigLoader::~ConfigLoader() { Stop(); }
 
 void ConfigLoader::Start() {
   bool expected = false;
   if (running_.compare_exchange_strong(expected, true)) {
-    SMF_LOGI("ConfigLoader started");
+    // 配置加载完成，冻结符号表，之后运行时只读
+    symbol_table_->Freeze();
+    SMF_LOGI("ConfigLoader started, interned " + std::to_string(symbol_table_->GetStateCount()) +
+             " states, " + std::to_string(symbol_table_->GetEventCount()) + " events, " +
+             std::to_string(symbol_table_->GetConditionCount()) + " conditions");
   }
 }
 
@@ -131,20 +147,15 @@ bool ConfigLoader::LoadEventConfig(const std::string& eventConfigDir) {
     return true;
   }
 
+  // 并行读取并校验，再按文件顺序解析注册
   bool success = true;
-  for (const auto& file : configFiles) {
-    json config;
-    if (!LoadJsonFile(file, config)) {
-      success = false;
-      continue;
-    }
-
-    if (!ValidateEventConfig(config)) {
+  for (const auto& file : LoadConfigFiles(configFiles, &ConfigLoader::ValidateEventConfig)) {
+    if (!file.valid) {
       success = false;
       continue;
     }
 
-    if (!ParseEventConfig(config)) {
+    if (!ParseEventConfig(file.config)) {
       success = false;
     }
   }
@@ -164,20 +175,15 @@ bool ConfigLoader::LoadTransitionConfig(const std::string& transConfigDir) {
     return false;
   }
 
+  // 并行读取并校验，再按文件顺序解析注册
   bool success = true;
-  for (const auto& file : configFiles) {
-    json config;
-    if (!LoadJsonFile(file, config)) {
-      success = false;
-      continue;
-    }
-
-    if (!ValidateTransitionConfig(config)) {
+  for (const auto& file : LoadConfigFiles(configFiles, &ConfigLoader::ValidateTransitionConfig)) {
+    if (!file.valid) {
       success = false;
       continue;
     }
 
-    if (!ParseTransitionConfig(config)) {
+    if (!ParseTransitionConfig(file.config)) {
       success = false;
     }
   }
@@ -318,8 +324,9 @@ bool ConfigLoader::ParseStateConfig(const json& config) {
       std::string name = state["name"];
       std::string parent = state.value("parent", "");
       int timeout = state.value("timeout", 0);
-      state_names_.emplace(name);
       StateInfo stateInfo{name, parent, {}, timeout};
+      stateInfo.id = symbol_table_->InternState(name);
+      stateInfo.parent_id = parent.empty() ? INVALID_SYMBOL_ID : symbol_table_->FindState(parent);
       if (!state_manager_->AddStateInfo(stateInfo)) {
         SMF_LOGE("Failed to add state: " + name);
         return false;
@@ -328,7 +335,7 @@ bool ConfigLoader::ParseStateConfig(const json& config) {
 
     // 设置初始状态
     std::string initialState = config["initial_state"];
-    if (!state_manager_->SetState(initialState)) {
+    if (!state_manager_->SetState(symbol_table_->FindState(initialState))) {
       SMF_LOGE("Failed to set initial state: " + initialState);
       return false;
     }
@@ -345,6 +352,7 @@ bool ConfigLoader::ParseConditionFromJson(const json& condJson, ConditionSharedP
   outCondition = std::make_shared<Condition>();
   outCondition->name = condJson["name"];
   outCondition->duration = condJson.value("duration", 0);
+  outCondition->id = symbol_table_->InternCondition(outCondition->name);
 
   if (!condJson.contains("range")) {
     return true;
@@ -368,6 +376,7 @@ bool ConfigLoader::ParseConditionFromJson(const json& condJson, ConditionSharedP
       }
     }
   }
+  outCondition->CompileRanges();
 
   return true;
 }
@@ -378,6 +387,10 @@ bool ConfigLoader::ParseEventConfig(const json& config) {
     eventDef.name = config["name"];
     eventDef.trigger_mode = config.value("trigger_mode", "edge");
     eventDef.conditionsOperator = config.value("conditions_operator", "AND");
+    eventDef.id = symbol_table_->InternEvent(eventDef.name);
+    eventDef.reset_id = symbol_table_->InternEvent(eventDef.name + "_RESET");
+    // 事件定义使用同名条件记录触发状态（edge/level 判定）
+    eventDef.flag_id = symbol_table_->InternCondition(eventDef.name);
 
     std::string contextInfo = "event config: " + eventDef.name;
 
@@ -399,14 +412,9 @@ bool ConfigLoader::ParseEventConfig(const json& config) {
         return false;
       }
       
-      // 校验复杂表达式中引用的条件是否已经定义
-      for (const auto& expr : eventDef.condition_exprs) {
-        for (const auto& ref : expr->conditions) {
-          if (!condition_manager_->HasCondition(ref.name)) {
-            SMF_LOGE("Condition '" + ref.name + "' referenced in conditions_expr is not defined in " + contextInfo);
-            return false;
-          }
-        }
+      // 校验复杂表达式中引用的条件是否已经定义，并编译为求值程序
+      if (!CompileConditionExprs(eventDef.condition_exprs, contextInfo)) {
+        return false;
       }
       
       SMF_LOGI("Using complex condition expressions for event: " + eventDef.name);
@@ -461,13 +469,18 @@ bool ConfigLoader::ParseTransitionConfig(const json& config) {
     // 解析timeout字段
     rule->timeout = config.value("timeout", 0);
 
-    if (state_names_.find(rule->from) == state_names_.end() ||
-        state_names_.find(rule->to) == state_names_.end()) {
+    rule->from_id = symbol_table_->FindState(rule->from);
+    rule->to_id = symbol_table_->FindState(rule->to);
+    if (rule->from_id == INVALID_SYMBOL_ID || rule->to_id == INVALID_SYMBOL_ID) {
       SMF_LOGE("Invalid 'from' or 'to' state in transition config: " + rule->from + " -> " +
                rule->to);
       return false;
     }
 
+    for (const auto& event : rule->events) {
+      rule->event_ids.push_back(symbol_table_->InternEvent(event));
+    }
+
     std::string contextInfo = "transition config: " + rule->from + " -> " + rule->to;
 
     // 先解析 conditions（简单条件模式），注册条件定义
@@ -488,14 +501,9 @@ bool ConfigLoader::ParseTransitionConfig(const json& config) {
         return false;
       }
       
-      // 校验复杂表达式中引用的条件是否已经定义
-      for (const auto& expr : rule->condition_exprs) {
-        for (const auto& ref : expr->conditions) {
-          if (!condition_manager_->HasCondition(ref.name)) {
-            SMF_LOGE("Condition '" + ref.name + "' referenced in conditions_expr is not defined in " + contextInfo);
-            return false;
-          }
-        }
+      // 校验复杂表达式中引用的条件是否已经定义，并编译为求值程序
+      if (!CompileConditionExprs(rule->condition_exprs, contextInfo)) {
+        return false;
       }
       
       SMF_LOGI("Using complex condition expressions for transition: " + rule->from + " -> " + rule->to);
@@ -513,7 +521,7 @@ bool ConfigLoader::ParseTransitionConfig(const json& config) {
   }
 }
 
-bool ConfigLoader::LoadJsonFile(const std::string& filePath, json& jsonData) {
+bool ConfigLoader::LoadJsonFile(const std::string& filePath, json& jsonData) const {
   try {
     // 检查文件是否存在
     if (!std::filesystem::exists(filePath)) {
@@ -539,6 +547,44 @@ bool ConfigLoader::LoadJsonFile(const std::string& filePath, json& jsonData) {
   }
 }
 
+std::vector<ConfigLoader::LoadedConfigFile> ConfigLoader::LoadConfigFiles(
+    const std::vector<std::string>& files, ConfigValidator validate) const {
+  std::vector<LoadedConfigFile> loaded(files.size());
+  // 各线程按下标领取文件，结果写入各自的槽位
+  std::atomic<size_t> next{0};
+  auto worker = [&]() {
+    for (size_t i = next.fetch_add(1); i < files.size(); i = next.fetch_add(1)) {
+      LoadedConfigFile& file = loaded[i];
+      try {
+        file.valid = LoadJsonFile(files[i], file.config) && (this->*validate)(file.config);
+      } catch (const std::exception& e) {
+        SMF_LOG(LogLevel::ERROR, "Error loading config file {}: {}", files[i], e.what());
+        file.valid = false;
+      }
+    }
+  };
+
+  size_t threads = load_threads_;
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  threads = std::min(threads, (files.size() + kMinFilesPerLoadThread - 1) / kMinFilesPerLoadThread);
+  std::vector<std::thread> workers;
+  try {
+    for (size_t i = 1; i < threads; ++i) {
+      workers.emplace_back(worker);
+    }
+  } catch (const std::system_error& e) {
+    // 无法创建线程时由已启动的线程与调用线程完成剩余文件
+    SMF_LOG(LogLevel::WARN, "Failed to start config load thread: {}", e.what());
+  }
+  worker();
+  for (auto& thread : workers) {
+    thread.join();
+  }
+  return loaded;
+}
+
 std::vector<std::string> ConfigLoader::GetJsonFilesInDirectory(const std::string& dirPath) {
   std::vector<std::string> jsonFiles;
 
@@ -673,6 +719,25 @@ bool ConfigLoader::ParseConditionExprs(const json& exprsJson,
   return true;
 }
 
+bool ConfigLoader::CompileConditionExprs(std::vector<ConditionExprSharedPtr>& exprs,
+                                         const std::string& contextInfo) {
+  for (const auto& expr : exprs) {
+    for (auto& ref : expr->conditions) {
+      if (!condition_manager_->HasCondition(ref.name)) {
+        SMF_LOGE("Condition '" + ref.name + "' referenced in conditions_expr is not defined in " +
+                 contextInfo);
+        return false;
+      }
+      ref.id = symbol_table_->FindCondition(ref.name);
+    }
+    if (!condition_manager_->CompileConditionExpr(*expr)) {
+      SMF_LOGE("Failed to compile conditions_expr in " + contextInfo);
+      return false;
+    }
+  }
+  return true;
+}
+
 bool ConfigLoader::ValidateCondition(const json& condition) const {
   if (!condition.contains("name") || !condition["name"].is_string()) {
     SMF_LOGE("Missing or invalid 'name' in condition");
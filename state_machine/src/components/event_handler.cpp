@@ -35,20 +35,29 @@
 
 #include "components/event_handler.h"
 
+#include <algorithm>
 #include <set>
 
 #include "logger.h"
 
 namespace smf {
 
-EventHandler::EventHandler(IStateManager* state_manager, IConditionManager* condition_manager,
+EventHandler::EventHandler(const SymbolTable* symbol_table, IStateManager* state_manager,
+                           IConditionManager* condition_manager,
                            ITransitionManager* transition_manager,
-                           std::shared_ptr<StateEventHandler> state_event_handler)
-    : state_manager_(state_manager),
+                           std::shared_ptr<StateEventHandler> state_event_handler,
+                           std::unique_ptr<IEventQueue> event_queue, bool inline_execution,
+                           bool latency_metrics)
+    : event_queue_(event_queue ? std::move(event_queue) : std::make_unique<MutexEventQueue>()),
+      inline_execution_(inline_execution),
+      event_pool_(symbol_table),
+      latency_metrics_(latency_metrics),
+      symbol_table_(symbol_table),
+      state_manager_(state_manager),
       condition_manager_(condition_manager),
       transition_manager_(transition_manager),
       state_event_handler_(state_event_handler) {
-  if (state_manager_ == nullptr || condition_manager_ == nullptr ||
+  if (symbol_table_ == nullptr || state_manager_ == nullptr || condition_manager_ == nullptr ||
       transition_manager_ == nullptr || state_event_handler_ == nullptr) {
     SMF_LOGE("Invalid parameters");
     return;
@@ -56,6 +65,8 @@ EventHandler::EventHandler(IStateManager* state_manager, IConditionManager* cond
   condition_manager_->RegisterConditionChangeCallback(
       std::bind(&EventHandler::TriggerEvent, this, std::placeholders::_1, std::placeholders::_2,
                 std::placeholders::_3, std::placeholders::_4));
+  condition_manager_->RegisterConditionFrameCallback(
+      std::bind(&EventHandler::TriggerEvents, this, std::placeholders::_1));
   state_manager_->RegisterStateTimeoutCallback(std::bind(
       &EventHandler::TriggerStateTimeoutEvent, this, std::placeholders::_1, std::placeholders::_2));
 }
@@ -66,7 +77,15 @@ void EventHandler::Start() {
   if (running_) {
     return;
   }
+  // 符号表已冻结，按事件数预留对象池槽位
+  event_pool_.Reserve();
   running_ = true;
+  if (inline_execution_) {
+    // 启动前投递的事件在此一并处理
+    DispatchInlineEvents();
+    return;
+  }
+  event_queue_->Open();
   event_thread_ = std::thread(&EventHandler::EventLoop, this);
 }
 
@@ -75,18 +94,128 @@ void EventHandler::Stop() {
     return;
   }
   running_ = false;
-  event_cv_.notify_all();
+  event_queue_->Close();
   if (event_thread_.joinable()) {
     event_thread_.join();
   }
+  // 停止时未处理的内部事件可能已被丢弃，之后的条件变化不再合并到其中
+  std::lock_guard<std::mutex> lock(internal_mutex_);
+  queued_internal_.reset();
 }
 
 bool EventHandler::IsRunning() const { return running_; }
 
 void EventHandler::HandleEvent(const EventPtr& event) {
-  std::lock_guard<std::mutex> lock(event_mutex_);
-  event_queue_.push(event);
-  event_cv_.notify_one();
+  Enqueue(event);
+  // 之后的条件变化不能再合并到排在该事件之前的内部事件中
+  internal_at_tail_.store(false, std::memory_order_release);
+}
+
+void EventHandler::HandleEvents(const EventPtr* events, size_t count) {
+  if (inline_execution_) {
+    inline_events_.insert(inline_events_.end(), events, events + count);
+    RecordEnqueue(events, count, inline_events_.size());
+    DispatchInlineEvents();
+  } else {
+    size_t depth = events_in_flight_.fetch_add(count, std::memory_order_relaxed) + count;
+    RecordEnqueue(events, count, depth);
+    size_t pushed = event_queue_->PushBatch(events, count);
+    events_in_flight_.fetch_sub(count - pushed, std::memory_order_release);
+  }
+  internal_at_tail_.store(false, std::memory_order_release);
+}
+
+bool EventHandler::Enqueue(const EventPtr& event) {
+  if (inline_execution_) {
+    inline_events_.push_back(event);
+    RecordEnqueue(&event, 1, inline_events_.size());
+    DispatchInlineEvents();
+    return true;
+  }
+  size_t depth = events_in_flight_.fetch_add(1, std::memory_order_relaxed) + 1;
+  RecordEnqueue(&event, 1, depth);
+  if (!event_queue_->Push(event)) {
+    events_in_flight_.fetch_sub(1, std::memory_order_release);
+    return false;
+  }
+  return true;
+}
+
+void EventHandler::RecordEnqueue(const EventPtr* events, size_t count, size_t depth) {
+  events_enqueued_.fetch_add(count, std::memory_order_relaxed);
+  UpdateMax(queue_depth_high_water_, depth);
+  if (latency_metrics_) {
+    // 须在入队前写入：事件线程取出事件后读取
+    const std::int64_t now = MonotonicNanos();
+    for (size_t i = 0; i < count; ++i) {
+      events[i]->SetEnqueueTime(now);
+    }
+  }
+}
+
+bool EventHandler::IsIdle() const {
+  if (inline_execution_) {
+    return !dispatching_ && inline_events_.empty();
+  }
+  return events_in_flight_.load(std::memory_order_acquire) == 0;
+}
+
+InternalEventStats EventHandler::GetInternalEventStats() const {
+  InternalEventStats stats;
+  stats.posted = internal_posted_.load(std::memory_order_relaxed);
+  stats.coalesced = internal_coalesced_.load(std::memory_order_relaxed);
+  stats.skipped = internal_skipped_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void EventHandler::GetMetrics(StateMachineMetrics& metrics) const {
+  metrics.events_enqueued = events_enqueued_.load(std::memory_order_relaxed);
+  metrics.events_processed = events_processed_.load(std::memory_order_relaxed);
+  // 队列已满时由队列丢弃的事件另行计数
+  metrics.events_dropped =
+      events_dropped_.load(std::memory_order_relaxed) + event_queue_->GetDroppedCount();
+  metrics.queue_depth_high_water = queue_depth_high_water_.load(std::memory_order_relaxed);
+  metrics.transitions = transitions_.load(std::memory_order_relaxed);
+  metrics.internal_events = GetInternalEventStats();
+  queue_latency_.Snapshot(metrics.queue_latency);
+  callback_duration_.Snapshot(metrics.callback_duration);
+}
+
+void EventHandler::DispatchInlineEvents() {
+  if (dispatching_ || !running_) {
+    return;
+  }
+  dispatching_ = true;
+  size_t processed = 0;
+  try {
+    while (running_ && !inline_events_.empty()) {
+      inline_batch_.swap(inline_events_);
+      processed = 0;
+      for (const auto& event : inline_batch_) {
+        if (!running_) {
+          break;
+        }
+        ProcessEvent(event);
+        ++processed;
+        SingleWriterAdd(events_processed_);
+      }
+      // 回调中停止状态机时，批次中剩余的事件被丢弃
+      SingleWriterAdd(events_dropped_, inline_batch_.size() - processed);
+      inline_batch_.clear();
+    }
+  } catch (...) {
+    // 回调抛出的异常传给调用方，未处理的事件（含抛出异常的事件）丢弃，状态机仍可继续使用
+    SingleWriterAdd(events_dropped_, inline_batch_.size() - processed + inline_events_.size());
+    inline_batch_.clear();
+    inline_events_.clear();
+    dispatching_ = false;
+    {
+      std::lock_guard<std::mutex> lock(internal_mutex_);
+      queued_internal_.reset();
+    }
+    throw;
+  }
+  dispatching_ = false;
 }
 
 bool EventHandler::AddEventDefinition(const EventDefinition& event_definition) {
@@ -94,18 +223,62 @@ bool EventHandler::AddEventDefinition(const EventDefinition& event_definition) {
     SMF_LOGE("EventHandler is running, cannot add event definition");
     return false;
   }
+  if (event_definition.id == INVALID_SYMBOL_ID || event_definition.reset_id == INVALID_SYMBOL_ID ||
+      event_definition.flag_id == INVALID_SYMBOL_ID) {
+    SMF_LOG(LogLevel::ERROR, "Event definition ids are not resolved: {}", event_definition.name);
+    return false;
+  }
+  const auto index = static_cast<std::uint32_t>(event_definitions_.size());
   event_definitions_.emplace_back(event_definition);
+
+  std::vector<ConditionId> condition_ids;
+  if (!CollectConditionIds(event_definition.conditions, event_definition.condition_exprs,
+                           condition_ids) ||
+      condition_ids.empty()) {
+    unindexed_definitions_.push_back(index);
+    return true;
+  }
+  for (ConditionId id : condition_ids) {
+    if (id >= definitions_by_condition_.size()) {
+      definitions_by_condition_.resize(id + 1);
+    }
+    definitions_by_condition_[id].push_back(index);
+  }
   return true;
 }
 
+EventId EventHandler::ResolveEventId(const EventPtr& event) const {
+  EventId id = event->GetId(symbol_table_);
+  if (id != INVALID_SYMBOL_ID) {
+    return id;
+  }
+  return symbol_table_->FindEvent(event->GetName());
+}
+
 void EventHandler::ProcessEvent(const EventPtr& event) {
-  State current_state = state_manager_->GetCurrentState();
+  if (latency_metrics_) {
+    queue_latency_.Record(MonotonicNanos() - event->GetEnqueueTime());
+  }
+  const StateId current_state_id = state_manager_->GetCurrentStateId();
+  const State& current_state = symbol_table_->GetStateName(current_state_id);
+  const EventId event_id = ResolveEventId(event);
+  if (event_id == INTERNAL_EVENT_ID) {
+    // 开始处理后不再向该事件合并条件变化
+    std::lock_guard<std::mutex> lock(internal_mutex_);
+    if (queued_internal_ == event) {
+      queued_internal_.reset();
+    }
+  }
 
   // 事件预处理
-  if (state_event_handler_ && !state_event_handler_->OnPreEvent(current_state, event)) {
-    if (state_event_handler_) {
-      state_event_handler_->OnPostEvent(event, false);
-    }
+  bool accepted = true;
+  if (state_event_handler_) {
+    LatencyScope scope(CallbackHistogram(state_event_handler_->HasPreEventCallback()));
+    accepted = state_event_handler_->OnPreEvent(current_state, event);
+  }
+  if (!accepted) {
+    LatencyScope scope(CallbackHistogram(state_event_handler_->HasPostEventCallback()));
+    state_event_handler_->OnPostEvent(event, false);
     return;
   }
 
@@ -114,13 +287,31 @@ void EventHandler::ProcessEvent(const EventPtr& event) {
   // 应使用挂起时保存的"用户原始事件"，而不是当前正在处理的事件
   // （后者很可能是条件变化派生的 INTERNAL_EVENT，会让用户在回调中产生困惑）。
   EventPtr callback_event = event;
-  std::vector<TransitionRuleSharedPtr> rules;
-  // 清理过期的待触发状态转移
-  transition_manager_->RemoveExpiredPendingTransitions();
+  std::vector<TransitionRuleSharedPtr>& rules = transition_rules_;
+  rules.clear();
+  // 条件变化引发的内部事件只需重新检查依赖这些条件的挂起转移（批量更新时携带多个条件）
+  changed_conditions_.clear();
+  if (event_id == INTERNAL_EVENT_ID) {
+    for (const auto& info : event->GetMatchedConditions()) {
+      ConditionId id = symbol_table_->FindCondition(info.name);
+      if (id != INVALID_SYMBOL_ID) {
+        changed_conditions_.push_back(id);
+      }
+    }
+    if (changed_conditions_.size() > 1) {
+      std::sort(changed_conditions_.begin(), changed_conditions_.end());
+      changed_conditions_.erase(
+          std::unique(changed_conditions_.begin(), changed_conditions_.end()),
+          changed_conditions_.end());
+    }
+  }
+  // 过期的待触发状态转移由时间轮定时器清理，查找时也会跳过，这里不再逐个事件扫描
   // 首先检查待触发状态转移（优先级更高）
-  if (transition_manager_->FindPendingTransition(current_state, event, rules)) {
+  if (transition_manager_->FindPendingTransition(current_state_id, event_id, rules,
+                                                 changed_conditions_)) {
     for (const auto& rule : rules) {
-      std::vector<ConditionInfo> condition_infos;
+      std::vector<ConditionInfo>& condition_infos = rule_infos_;
+      condition_infos.clear();
       bool conditionsSatisfied = false;
       
       // 优先检查复杂条件表达式
@@ -140,11 +331,12 @@ void EventHandler::ProcessEvent(const EventPtr& event) {
         EventPtr pending_origin = transition_manager_->GetPendingTransitionOriginalEvent(rule);
         EventPtr resume_event = pending_origin ? pending_origin : event;
         if (pending_origin && pending_origin.get() != event.get()) {
-          SMF_LOGD("Resume pending transition with original event '" +
-                   pending_origin->GetName() + "' (current processed event: '" +
-                   event->GetName() + "')");
+          SMF_LOG(LogLevel::DEBUG,
+                  "Resume pending transition with original event '{}' "
+                  "(current processed event: '{}')",
+                  pending_origin->GetName(), event->GetName());
         }
-        ExecuteTransition(current_state, rule, resume_event, condition_infos,
+        ExecuteTransition(current_state_id, rule, resume_event, condition_infos,
                           /*skip_on_transition=*/alreadyInvoked);
         eventHandled = true;
         callback_event = resume_event;
@@ -156,9 +348,19 @@ void EventHandler::ProcessEvent(const EventPtr& event) {
   }
 
   // 如果没有处理待触发转移，则查找常规转换规则
-  if (!eventHandled && transition_manager_->FindTransition(current_state, event, rules)) {
-    for (const auto& rule : rules) {
-      std::vector<ConditionInfo> condition_infos;
+  // 编译模式下直接引用转移表中的规则，无需复制到 rules
+  TransitionRuleSpan candidates;
+  if (!eventHandled) {
+    if (transition_manager_->IsCompiled()) {
+      candidates = transition_manager_->FindCompiledTransitions(current_state_id, event_id);
+    } else if (transition_manager_->FindTransition(current_state_id, event_id, rules)) {
+      candidates = {rules.data(), rules.data() + rules.size()};
+    }
+  }
+  if (!candidates.empty()) {
+    for (const auto& rule : candidates) {
+      std::vector<ConditionInfo>& condition_infos = rule_infos_;
+      condition_infos.clear();
       bool conditionsSatisfied = false;
       
       // 优先检查复杂条件表达式
@@ -172,7 +374,7 @@ void EventHandler::ProcessEvent(const EventPtr& event) {
       
       if (conditionsSatisfied) {
         // 执行状态转换，并传递满足的条件信息
-        ExecuteTransition(current_state, rule, event, condition_infos);
+        ExecuteTransition(current_state_id, rule, event, condition_infos);
         eventHandled = true;
         break;
       } else if (rule->timeout > 0) {
@@ -186,18 +388,20 @@ void EventHandler::ProcessEvent(const EventPtr& event) {
         }
 
         // 仅当真正新挂起（无重复）时，提前回调 OnTransition
-        if (transition_manager_->AddPendingTransition(rule, event, unsatisfiedConditions)) {
-          SMF_LOGI("Added pending transition for rule: " + rule->from + " -> " + rule->to +
-                   " with timeout " + std::to_string(rule->timeout) + "ms");
+        if (transition_manager_->AddPendingTransition(rule, event_id, event,
+                                                      unsatisfiedConditions)) {
+          SMF_LOG(LogLevel::INFO, "Added pending transition for rule: {} -> {} with timeout {}ms",
+                  rule->from, rule->to, rule->timeout);
 
           // 首次事件匹配但条件未满足：提前触发 OnTransition 回调
           if (state_event_handler_) {
-            std::vector<State> exitStates;
-            std::vector<State> enterStates;
-            state_manager_->GetStateHierarchy(current_state, rule->to, exitStates, enterStates);
-            SMF_LOGI("Pre-Transition (pending): " + current_state + " -> " + rule->to +
-                     " on event " + event->toString() + ", waiting conditions");
-            state_event_handler_->OnTransition(exitStates, event, enterStates);
+            const TransitionPath& path =
+                state_manager_->GetTransitionPath(current_state_id, rule->to_id);
+            SMF_LOG(LogLevel::INFO,
+                    "Pre-Transition (pending): {} -> {} on event {}, waiting conditions",
+                    current_state, rule->to, event->toString());
+            LatencyScope scope(CallbackHistogram(state_event_handler_->HasTransitionCallback()));
+            state_event_handler_->OnTransition(path.exit_states, event, path.enter_states);
           }
           transition_manager_->MarkPendingTransitionInvoked(rule);
         }
@@ -207,116 +411,198 @@ void EventHandler::ProcessEvent(const EventPtr& event) {
 
   // 事件回收处理：消费挂起时使用原始事件，避免回调中出现内部事件让业务困惑
   if (state_event_handler_) {
+    LatencyScope scope(CallbackHistogram(state_event_handler_->HasPostEventCallback()));
     state_event_handler_->OnPostEvent(callback_event, eventHandled);
   }
 }
 
 void EventHandler::EventLoop() {
-  while (running_) {
-    EventPtr event{nullptr};
-    {
-      std::unique_lock<std::mutex> lock(event_mutex_);
-      event_cv_.wait(lock, [this] { return !running_ || !event_queue_.empty(); });
-
+  // 每次取出队列中全部待处理事件，处理整批期间不再访问队列
+  // batch 在循环间复用，稳定后不再分配内存
+  std::vector<EventPtr> batch;
+  // 队列关闭（Stop）后 PopAll 返回 false，剩余事件不再处理
+  while (running_ && event_queue_->PopAll(batch)) {
+    size_t processed = 0;
+    for (const auto& event : batch) {
       if (!running_) {
         break;
       }
-
-      if (!event_queue_.empty()) {
-        event = event_queue_.front();
-        event_queue_.pop();
-      } else {
-        continue;
-      }
+      ProcessEvent(event);
+      ++processed;
+      SingleWriterAdd(events_processed_);
+      events_in_flight_.fetch_sub(1, std::memory_order_release);
     }
-    // 处理事件
-    ProcessEvent(event);
+    // 停止时批次中剩余的事件被丢弃
+    SingleWriterAdd(events_dropped_, batch.size() - processed);
+    events_in_flight_.fetch_sub(batch.size() - processed, std::memory_order_release);
+    batch.clear();
   }
 }
 
-void EventHandler::TriggerEvent(const std::string& condition_name, int value, int duration,
+void EventHandler::TriggerEvent(ConditionId condition_id, int value, int duration,
                                 bool value_in_range) {
-  SMF_LOGD("TriggerEvent: " + condition_name + " " + std::to_string(value) + " " +
-           std::to_string(value_in_range));
-  for (const auto& event_definition : event_definitions_) {
-    std::vector<ConditionInfo> condition_infos;
-    int event_condition_value = 0;
-    condition_manager_->GetConditionValue(event_definition.name, event_condition_value);
-    
-    // 检查条件是否满足：优先使用复杂条件表达式
-    bool conditionsSatisfied = false;
-    if (event_definition.HasConditionExprs()) {
-      conditionsSatisfied = condition_manager_->CheckConditionExprs(
-          event_definition.condition_exprs, condition_infos);
+  const std::string& condition_name = symbol_table_->GetConditionName(condition_id);
+  SMF_LOG(LogLevel::DEBUG, "TriggerEvent: {} {} {}", condition_name, value, value_in_range);
+  // 复用匹配条件信息容器，避免每个事件定义都重新分配
+  std::vector<ConditionInfo>& condition_infos = trigger_infos_;
+  // 只重新检查引用该条件的事件定义与无法索引的事件定义，两者按定义顺序合并
+  static const std::vector<std::uint32_t> kNoDefinitions;
+  const std::vector<std::uint32_t>& dependents = condition_id < definitions_by_condition_.size()
+                                                     ? definitions_by_condition_[condition_id]
+                                                     : kNoDefinitions;
+  size_t i = 0;
+  size_t j = 0;
+  while (i < dependents.size() || j < unindexed_definitions_.size()) {
+    std::uint32_t index;
+    if (j == unindexed_definitions_.size() ||
+        (i < dependents.size() && dependents[i] < unindexed_definitions_[j])) {
+      index = dependents[i++];
     } else {
-      conditionsSatisfied = condition_manager_->CheckConditions(
-          event_definition.conditions, event_definition.conditionsOperator, condition_infos);
+      index = unindexed_definitions_[j++];
     }
-    
-    if (conditionsSatisfied) {
-      // 如果条件满足，且对应事件条件当前值为0，边缘触发与水平触发均可触发事件
-      if (event_condition_value == 0) {
-        // 更新事件同名条件值为1
-        condition_manager_->SetConditionValue(event_definition.name, 1);
-        EventPtr eventPtr = std::make_shared<Event>(event_definition.name);
-        eventPtr->SetMatchedConditions(condition_infos);
-        HandleEvent(eventPtr);
-      } else {
-        // 如果条件满足，且对应事件条件当前值为1，水平触发可触发事件
-        if (event_definition.trigger_mode == "level") {
-          EventPtr eventPtr = std::make_shared<Event>(event_definition.name);
-          eventPtr->SetMatchedConditions(condition_infos);
-          HandleEvent(eventPtr);
-        }
+    EvaluateEventDefinition(event_definitions_[index], condition_infos);
+  }
+
+  // 所有条件更新都支持触发内部事件
+  condition_infos.clear();
+  condition_infos.emplace_back(ConditionInfo{condition_name, value, duration});
+  PostInternalEvent(condition_infos);
+}
+
+void EventHandler::TriggerEvents(const std::vector<ConditionChange>& changes) {
+  SMF_LOG(LogLevel::DEBUG, "TriggerEvents: {} conditions", changes.size());
+  // 依赖任一变化条件的定义与无法索引的定义去重后按定义顺序各检查一次
+  if (frame_marks_.size() < event_definitions_.size()) {
+    frame_marks_.resize(event_definitions_.size());
+  }
+  frame_definitions_.clear();
+  auto collect = [this](const std::vector<std::uint32_t>& indices) {
+    for (std::uint32_t index : indices) {
+      if (!frame_marks_[index]) {
+        frame_marks_[index] = 1;
+        frame_definitions_.push_back(index);
       }
+    }
+  };
+  for (const auto& change : changes) {
+    if (change.id < definitions_by_condition_.size()) {
+      collect(definitions_by_condition_[change.id]);
+    }
+  }
+  collect(unindexed_definitions_);
+  std::sort(frame_definitions_.begin(), frame_definitions_.end());
+  for (std::uint32_t index : frame_definitions_) {
+    frame_marks_[index] = 0;
+  }
+
+  std::vector<ConditionInfo>& condition_infos = trigger_infos_;
+  for (std::uint32_t index : frame_definitions_) {
+    EvaluateEventDefinition(event_definitions_[index], condition_infos);
+  }
+
+  // 整帧只生成一个内部事件，携带全部变化的条件
+  condition_infos.clear();
+  for (const auto& change : changes) {
+    condition_infos.push_back(
+        {symbol_table_->GetConditionName(change.id), change.value, change.duration});
+  }
+  PostInternalEvent(condition_infos);
+}
+
+void EventHandler::PostInternalEvent(std::vector<ConditionInfo>& condition_infos) {
+  // 没有待处理的事件时，内部事件处理时的状态就是当前状态
+  if (running_ && IsIdle() &&
+      !transition_manager_->HasConditionTransitions(state_manager_->GetCurrentStateId())) {
+    internal_skipped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  EventPtr eventPtr;
+  {
+    std::lock_guard<std::mutex> lock(internal_mutex_);
+    if (queued_internal_ && internal_at_tail_.load(std::memory_order_acquire)) {
+      queued_internal_->MergeMatchedConditions(condition_infos);
+      internal_coalesced_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    eventPtr = event_pool_.Acquire(INTERNAL_EVENT_ID, condition_infos);
+    queued_internal_ = eventPtr;
+    // 先标记再入队：入队后其他线程投递的事件会把标记清除
+    internal_at_tail_.store(true, std::memory_order_release);
+  }
+  internal_posted_.fetch_add(1, std::memory_order_relaxed);
+  if (!Enqueue(eventPtr)) {
+    std::lock_guard<std::mutex> lock(internal_mutex_);
+    if (queued_internal_ == eventPtr) {
+      queued_internal_.reset();
+    }
+  }
+}
+
+void EventHandler::EvaluateEventDefinition(const EventDefinition& event_definition,
+                                           std::vector<ConditionInfo>& condition_infos) {
+  condition_infos.clear();
+  int event_condition_value = condition_manager_->GetConditionValue(event_definition.flag_id);
+  
+  // 检查条件是否满足：优先使用复杂条件表达式
+  bool conditionsSatisfied = false;
+  if (event_definition.HasConditionExprs()) {
+    conditionsSatisfied = condition_manager_->CheckConditionExprs(
+        event_definition.condition_exprs, condition_infos);
+  } else {
+    conditionsSatisfied = condition_manager_->CheckConditions(
+        event_definition.conditions, event_definition.conditionsOperator, condition_infos);
+  }
+  
+  if (conditionsSatisfied) {
+    // 如果条件满足，且对应事件条件当前值为0，边缘触发与水平触发均可触发事件
+    if (event_condition_value == 0) {
+      // 更新事件同名条件值为1
+      condition_manager_->SetConditionValue(event_definition.flag_id, 1);
+      HandleEvent(event_pool_.Acquire(event_definition.id, condition_infos));
     } else {
-      // 如果条件不满足，且对应事件条件当前值为1，边缘触发 event_definition.name + "_RESET" 事件
-      if (event_condition_value == 1) {
-        // 将事件同名条件值重置为0
-        condition_manager_->SetConditionValue(event_definition.name, 0);
-        if (event_definition.trigger_mode == "edge") {
-          EventPtr eventPtr = std::make_shared<Event>(event_definition.name + "_RESET");
-          HandleEvent(eventPtr);
-        }
+      // 如果条件满足，且对应事件条件当前值为1，水平触发可触发事件
+      if (event_definition.trigger_mode == "level") {
+        HandleEvent(event_pool_.Acquire(event_definition.id, condition_infos));
+      }
+    }
+  } else {
+    // 如果条件不满足，且对应事件条件当前值为1，边缘触发 event_definition.name + "_RESET" 事件
+    if (event_condition_value == 1) {
+      // 将事件同名条件值重置为0
+      condition_manager_->SetConditionValue(event_definition.flag_id, 0);
+      if (event_definition.trigger_mode == "edge") {
+        HandleEvent(event_pool_.Acquire(event_definition.reset_id));
       }
     }
   }
-
-  // 所有条件更新都支持触发内部事件
-  EventPtr eventPtr = std::make_shared<Event>(INTERNAL_EVENT);
-  std::vector<ConditionInfo> condition_infos;
-  condition_infos.emplace_back(ConditionInfo{condition_name, value, duration});
-  eventPtr->SetMatchedConditions(condition_infos);
-  HandleEvent(eventPtr);
 }
 
-void EventHandler::TriggerStateTimeoutEvent(const State& state, int timeout) {
-  SMF_LOGD("TriggerStateTimeoutEvent: " + state + " " + std::to_string(timeout));
-  EventPtr eventPtr = std::make_shared<Event>(STATE_TIMEOUT_EVENT);
-  HandleEvent(eventPtr);
+void EventHandler::TriggerStateTimeoutEvent(StateId state, int timeout) {
+  SMF_LOG(LogLevel::DEBUG, "TriggerStateTimeoutEvent: {} {}", symbol_table_->GetStateName(state),
+          timeout);
+  HandleEvent(event_pool_.Acquire(STATE_TIMEOUT_EVENT_ID));
 }
 
 void EventHandler::PrintSatisfiedConditions(
     const std::vector<ConditionInfo>& condition_infos) const {
   for (const auto& condition_info : condition_infos) {
-    SMF_LOGD(std::string("SatisfiedCondition: condition_name: ") + condition_info.name + ", " +
-             "condition_value: " + std::to_string(condition_info.value) + ", " +
-             "condition_duration: " + std::to_string(condition_info.duration));
+    SMF_LOG(LogLevel::DEBUG,
+            "SatisfiedCondition: condition_name: {}, condition_value: {}, condition_duration: {}",
+            condition_info.name, condition_info.value, condition_info.duration);
   }
 }
 
-void EventHandler::ExecuteTransition(const State& current_state,
+void EventHandler::ExecuteTransition(StateId current_state_id,
                                      const TransitionRuleSharedPtr& rule, const EventPtr& event,
                                      const std::vector<ConditionInfo>& condition_infos,
                                      bool skip_on_transition) {
-  // 获取状态层次结构
-  std::vector<State> exitStates;
-  std::vector<State> enterStates;
-  state_manager_->GetStateHierarchy(current_state, rule->to, exitStates, enterStates);
+  const State& current_state = symbol_table_->GetStateName(current_state_id);
+  // 获取状态层次结构（缓存在状态管理器中，回调直接引用缓存）
+  const TransitionPath& path = state_manager_->GetTransitionPath(current_state_id, rule->to_id);
 
-  // 构建满足条件的信息字符串
+  // 构建满足条件的信息字符串（只用于日志，INFO 被过滤时不构建）
   std::string conditionsStr;
-  if (!condition_infos.empty()) {
+  if (!condition_infos.empty() && Logger::GetInstance().IsEnabled(LogLevel::INFO)) {
     conditionsStr = " [";
     for (size_t i = 0; i < condition_infos.size(); ++i) {
       const auto& info = condition_infos[i];
@@ -333,21 +619,25 @@ void EventHandler::ExecuteTransition(const State& current_state,
 
   // 执行状态转换
   if (state_event_handler_) {
-    const std::string logPrefix = skip_on_transition ? "Transition (resume): " : "Transition: ";
-    SMF_LOGI(logPrefix + current_state + " -> " + rule->to + " on event " + event->toString() +
-             conditionsStr);
+    SMF_LOG(LogLevel::INFO, "{}{} -> {} on event {}{}",
+            skip_on_transition ? "Transition (resume): " : "Transition: ", current_state, rule->to,
+            event->toString(), conditionsStr);
     if (!skip_on_transition) {
-      state_event_handler_->OnTransition(exitStates, event, enterStates);
+      LatencyScope scope(CallbackHistogram(state_event_handler_->HasTransitionCallback()));
+      state_event_handler_->OnTransition(path.exit_states, event, path.enter_states);
     }
-    state_event_handler_->OnExitState(exitStates);
+    LatencyScope scope(CallbackHistogram(state_event_handler_->HasExitStateCallback()));
+    state_event_handler_->OnExitState(path.exit_states);
   }
 
   // 更新当前状态
-  state_manager_->SetState(rule->to);
+  state_manager_->SetState(rule->to_id);
+  SingleWriterAdd(transitions_);
 
   // 调用状态进入处理
   if (state_event_handler_) {
-    state_event_handler_->OnEnterState(enterStates);
+    LatencyScope scope(CallbackHistogram(state_event_handler_->HasEnterStateCallback()));
+    state_event_handler_->OnEnterState(path.enter_states);
   }
 }
 
@@ -358,8 +648,7 @@ void EventHandler::GetUnsatisfiedConditions(const std::vector<ConditionSharedPtr
   unsatisfiedConditions.clear();
 
   for (const auto& cond : conditions) {
-    int value = 0;
-    condition_manager_->GetConditionValue(cond->name, value);
+    int value = condition_manager_->GetConditionValue(cond->id);
 
     if (!cond->IsValueInRange(value)) {
       unsatisfiedConditions.push_back({cond->name, value, 0});
@@ -372,11 +661,11 @@ void EventHandler::GetUnsatisfiedConditionsFromExprs(
     std::vector<ConditionInfo>& unsatisfiedConditions) {
   unsatisfiedConditions.clear();
 
-  // 收集所有条件表达式中的唯一条件名称
-  std::set<std::string> conditionNames;
+  // 收集所有条件表达式中的唯一条件
+  std::set<ConditionId> conditionIds;
   for (const auto& expr : condition_exprs) {
     for (const auto& ref : expr->conditions) {
-      conditionNames.insert(ref.name);
+      conditionIds.insert(ref.id);
     }
   }
 
@@ -384,13 +673,12 @@ void EventHandler::GetUnsatisfiedConditionsFromExprs(
   // 对于每个引用的条件，需要检查其是否真正满足
   // 由于复杂表达式的判断逻辑较复杂，这里简化处理：
   // 收集所有在表达式中的条件名，并记录其当前值
-  for (const auto& name : conditionNames) {
-    int value = 0;
-    condition_manager_->GetConditionValue(name, value);
+  for (const auto& id : conditionIds) {
+    int value = condition_manager_->GetConditionValue(id);
     // 注意：这里只记录条件的当前值，实际是否满足取决于表达式的完整计算
     // 由于表达式可能包含 AND/OR/取反逻辑，无法简单判断单个条件是否"不满足"
     // 这里记录所有条件信息供后续处理使用
-    unsatisfiedConditions.push_back({name, value, 0});
+    unsatisfiedConditions.push_back({symbol_table_->GetConditionName(id), value, 0});
   }
 }
 
@@ -0,0 +1,262 @@
+/**
+ * @file event_queue.cpp
+ * @brief Implementation of the event queues
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @details This file contains the implementation of MutexEventQueue and MpscRingEventQueue.
+ * @version 1.0.0
+ **/
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2025 xiaokui.hu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "components/event_queue.h"
+
+#include <algorithm>
+#include <iterator>
+#include <string>
+
+#include "logger.h"
+
+namespace smf {
+
+namespace {
+
+// 消费者进入休眠前的自旋次数
+constexpr int kConsumerSpinCount = 64;
+
+size_t RoundUpToPowerOfTwo(size_t value) {
+  size_t result = 2;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+}  // namespace
+
+bool MutexEventQueue::Push(const EventPtr& event) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  pending_.push_back(event);
+  cv_.notify_one();
+  return true;
+}
+
+size_t MutexEventQueue::PushBatch(const EventPtr* events, size_t count) {
+  if (count == 0) {
+    return 0;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  pending_.insert(pending_.end(), events, events + count);
+  cv_.notify_one();
+  return count;
+}
+
+bool MutexEventQueue::PopAll(std::vector<EventPtr>& events) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [this] { return closed_ || !pending_.empty(); });
+  if (closed_) {
+    return false;
+  }
+  if (events.empty()) {
+    // 与待处理缓冲区整体交换，消费者上一批用过的容量留给生产者继续使用
+    events.swap(pending_);
+  } else {
+    events.insert(events.end(), std::make_move_iterator(pending_.begin()),
+                  std::make_move_iterator(pending_.end()));
+    pending_.clear();
+  }
+  return true;
+}
+
+void MutexEventQueue::Open() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  closed_ = false;
+}
+
+void MutexEventQueue::Close() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  closed_ = true;
+  cv_.notify_all();
+}
+
+MpscRingEventQueue::MpscRingEventQueue(size_t capacity)
+    : cells_(new Cell[RoundUpToPowerOfTwo(capacity)]),
+      mask_(RoundUpToPowerOfTwo(capacity) - 1) {
+  for (size_t i = 0; i <= mask_; ++i) {
+    cells_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+MpscRingEventQueue::~MpscRingEventQueue() { Close(); }
+
+size_t MpscRingEventQueue::TryPush(const EventPtr* events, size_t count) {
+  size_t want = std::min(count, mask_ + 1);
+  size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+  for (;;) {
+    // 消费者按顺序释放槽位，区间最后一个槽位空闲即说明整个区间空闲；
+    // 否则把区间减半重试，直到只剩一个槽位
+    size_t n = want;
+    std::intptr_t diff = 0;
+    for (;;) {
+      size_t last = pos + n - 1;
+      size_t seq = cells_[last & mask_].sequence.load(std::memory_order_acquire);
+      diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(last);
+      if (diff >= 0 || n == 1) {
+        break;
+      }
+      n /= 2;
+    }
+    if (diff == 0) {
+      // 区间空闲，一次 CAS 抢占整个写区间
+      if (enqueue_pos_.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) {
+        for (size_t i = 0; i < n; ++i) {
+          Cell& cell = cells_[(pos + i) & mask_];
+          cell.event = events[i];
+          cell.sequence.store(pos + i + 1, std::memory_order_release);
+        }
+        return n;
+      }
+    } else if (diff < 0) {
+      // 槽位仍被上一圈占用，队列已满
+      return 0;
+    } else {
+      pos = enqueue_pos_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+bool MpscRingEventQueue::TryPop(EventPtr& event) {
+  Cell& cell = cells_[dequeue_pos_ & mask_];
+  size_t seq = cell.sequence.load(std::memory_order_acquire);
+  if (seq != dequeue_pos_ + 1) {
+    return false;
+  }
+  event = std::move(cell.event);
+  cell.event = nullptr;
+  // 释放槽位给下一圈的生产者
+  cell.sequence.store(dequeue_pos_ + mask_ + 1, std::memory_order_release);
+  ++dequeue_pos_;
+  return true;
+}
+
+bool MpscRingEventQueue::HasPending() const {
+  const Cell& cell = cells_[dequeue_pos_ & mask_];
+  return cell.sequence.load(std::memory_order_acquire) == dequeue_pos_ + 1;
+}
+
+bool MpscRingEventQueue::ShouldDrop() const {
+  return closed_.load(std::memory_order_acquire) ||
+         consumer_id_.load(std::memory_order_relaxed) == std::this_thread::get_id();
+}
+
+void MpscRingEventQueue::WakeConsumer() {
+  // 与消费者休眠前的 fence 配对：要么生产者看到 parked_，要么消费者看到新事件
+  // 只有把 parked_ 从 true 置为 false 的生产者负责唤醒，避免每次入队都触发系统调用
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (parked_.load(std::memory_order_relaxed) &&
+      parked_.exchange(false, std::memory_order_acq_rel)) {
+    std::lock_guard<std::mutex> lock(park_mutex_);
+    park_cv_.notify_one();
+  }
+}
+
+bool MpscRingEventQueue::Push(const EventPtr& event) { return PushBatch(&event, 1) == 1; }
+
+size_t MpscRingEventQueue::PushBatch(const EventPtr* events, size_t count) {
+  size_t pushed = 0;
+  while (pushed < count) {
+    size_t n = TryPush(events + pushed, count - pushed);
+    if (n > 0) {
+      pushed += n;
+      continue;
+    }
+    if (ShouldDrop()) {
+      size_t dropped = count - pushed;
+      dropped_.fetch_add(dropped, std::memory_order_relaxed);
+      SMF_LOGE("Event queue is full, drop " + std::to_string(dropped) +
+               " event(s), first: " + (events[pushed] ? events[pushed]->GetName() : std::string()));
+      break;
+    }
+    // 背压：确保消费者在运行，然后让出 CPU 等待空位
+    WakeConsumer();
+    std::this_thread::yield();
+  }
+  if (pushed > 0) {
+    WakeConsumer();
+  }
+  return pushed;
+}
+
+bool MpscRingEventQueue::PopAll(std::vector<EventPtr>& events) {
+  consumer_id_.store(std::this_thread::get_id(), std::memory_order_relaxed);
+  EventPtr event;
+  for (;;) {
+    if (closed_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    for (int i = 0; i < kConsumerSpinCount; ++i) {
+      if (TryPop(event)) {
+        // 取出当前已发布的全部事件，最多一圈，避免生产者持续写入时消费者无法返回
+        events.push_back(std::move(event));
+        for (size_t n = 1; n <= mask_ && TryPop(event); ++n) {
+          events.push_back(std::move(event));
+        }
+        return true;
+      }
+    }
+
+    // 每次休眠前都要重新置位 parked_：唤醒者已把它清零，若队首槽位仍未发布
+    // （后面的槽位先发布并触发了唤醒），继续休眠时必须让队首的生产者能再次唤醒
+    std::unique_lock<std::mutex> lock(park_mutex_);
+    for (;;) {
+      parked_.store(true, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (closed_.load(std::memory_order_acquire) || HasPending()) {
+        break;
+      }
+      park_cv_.wait(lock);
+    }
+    parked_.store(false, std::memory_order_relaxed);
+  }
+}
+
+void MpscRingEventQueue::Open() { closed_.store(false, std::memory_order_release); }
+
+void MpscRingEventQueue::Close() {
+  {
+    std::lock_guard<std::mutex> lock(park_mutex_);
+    closed_.store(true, std::memory_order_release);
+  }
+  park_cv_.notify_all();
+}
+
+std::unique_ptr<IEventQueue> CreateEventQueue(const StateMachineOptions& options) {
+  if (options.event_queue == EventQueueType::LOCK_FREE) {
+    return std::make_unique<MpscRingEventQueue>(options.event_queue_capacity);
+  }
+  return std::make_unique<MutexEventQueue>();
+}
+
+}  // namespace smf
@@ -42,7 +42,8 @@
 
 namespace smf {
 
-StateManager::StateManager() = default;
+StateManager::StateManager(const SymbolTable* symbol_table, TimingWheel* timer_wheel)
+    : symbol_table_(symbol_table), timer_wheel_(timer_wheel) {}
 
 StateManager::~StateManager() { Stop(); }
 
@@ -51,7 +52,12 @@ void StateManager::Start() {
     return;
   }
   running_ = true;
-  timeout_thread_ = std::thread(&StateManager::StateTimeoutLoop, this);
+  // 启动前已设置的初始状态在此登记超时定时器
+  std::lock_guard<std::mutex> lock(timeout_mutex_);
+  if (current_state_timeout_.state != INVALID_SYMBOL_ID && current_state_timeout_.timeout > 0 &&
+      timeout_timer_ == TimingWheel::INVALID_TIMER_ID) {
+    ArmStateTimeoutLocked(current_state_timeout_.expiryTime);
+  }
 }
 
 void StateManager::Stop() {
@@ -59,112 +65,163 @@ void StateManager::Stop() {
     return;
   }
   running_ = false;
-  timeout_cv_.notify_all();
-  if (timeout_thread_.joinable()) {
-    timeout_thread_.join();
+  TimingWheel::TimerId timer = TimingWheel::INVALID_TIMER_ID;
+  {
+    std::lock_guard<std::mutex> lock(timeout_mutex_);
+    ++timeout_generation_;
+    timer = timeout_timer_;
+    timeout_timer_ = TimingWheel::INVALID_TIMER_ID;
   }
+  // 撤销超时定时器，并等待可能正在执行的到期回调结束
+  timer_wheel_->Cancel(timer);
+  timer_wheel_->WaitForCallbacks();
 }
 
 bool StateManager::IsRunning() const { return running_; }
 
+bool StateManager::HasState(StateId state) const {
+  return state < states_.size() && states_[state].id != INVALID_SYMBOL_ID;
+}
+
 bool StateManager::AddStateInfo(const StateInfo& state_info) {
   if (running_) {
     SMF_LOGE("Cannot add state info while running");
     return false;
   }
+  if (state_info.id == INVALID_SYMBOL_ID) {
+    SMF_LOGE("State id is not assigned: " + state_info.name);
+    return false;
+  }
   std::lock_guard<std::mutex> lock(state_mutex_);
-  if (states_.find(state_info.name) != states_.end()) {
+  if (HasState(state_info.id)) {
     SMF_LOGE("State already exists: " + state_info.name);
     return false;
   }
 
-  states_[state_info.name] = state_info;
+  {
+    std::unique_lock<std::shared_mutex> path_lock(path_mutex_);
+    path_cache_.clear();
+  }
+  if (states_.size() <= state_info.id) {
+    states_.resize(state_info.id + 1);
+  }
+  states_[state_info.id] = state_info;
   if (!state_info.parent.empty()) {
-    auto it = states_.find(state_info.parent);
-    if (it == states_.end()) {
+    if (!HasState(state_info.parent_id)) {
       SMF_LOGE("Parent state does not exist: " + state_info.parent);
       return false;
     }
-    it->second.children.push_back(state_info.name);
+    states_[state_info.parent_id].children.push_back(state_info.name);
   }
   return true;
 }
 
-bool StateManager::SetState(const State& state) {
+bool StateManager::SetState(StateId state) {
   int stateTimeout = 0;
   {
     std::lock_guard<std::mutex> lock(state_mutex_);
-    auto it = states_.find(state);
-    if (it == states_.end()) {
-      SMF_LOGE("State does not exist: " + state);
+    if (!HasState(state)) {
+      SMF_LOGE("State does not exist: " + symbol_table_->GetStateName(state));
       return false;
     }
-    current_state_ = state;
-    stateTimeout = it->second.timeout;
+    current_state_.store(state, std::memory_order_release);
+    state_generation_.fetch_add(1, std::memory_order_release);
+    stateTimeout = states_[state].timeout;
   }
 
   // 更新状态超时信息（在 state_mutex_ 外获取 timeout_mutex_，避免嵌套锁）
+  // 上一个状态的超时定时器直接撤销
+  TimingWheel::TimerId stale = TimingWheel::INVALID_TIMER_ID;
   {
     std::lock_guard<std::mutex> timeout_lock(timeout_mutex_);
+    ++timeout_generation_;
+    stale = timeout_timer_;
+    timeout_timer_ = TimingWheel::INVALID_TIMER_ID;
     if (stateTimeout > 0) {
       auto now = std::chrono::steady_clock::now();
       current_state_timeout_.state = state;
       current_state_timeout_.timeout = stateTimeout;
       current_state_timeout_.enterTime = now;
       current_state_timeout_.expiryTime = now + std::chrono::milliseconds(stateTimeout);
-      timeout_cv_.notify_one();
-      SMF_LOGD("Set state timeout for state " + state + " with timeout " +
-               std::to_string(stateTimeout) + " ms");
+      if (running_) {
+        ArmStateTimeoutLocked(current_state_timeout_.expiryTime);
+      }
+      SMF_LOGD("Set state timeout for state " + symbol_table_->GetStateName(state) +
+               " with timeout " + std::to_string(stateTimeout) + " ms");
     } else {
-      current_state_timeout_.state.clear();
+      current_state_timeout_.state = INVALID_SYMBOL_ID;
       current_state_timeout_.timeout = 0;
     }
   }
+  if (stale != TimingWheel::INVALID_TIMER_ID) {
+    timer_wheel_->Cancel(stale);
+  }
   return true;
 }
 
-State StateManager::GetCurrentState() const {
-  std::lock_guard<std::mutex> lock(state_mutex_);
-  return current_state_;
+const State& StateManager::GetCurrentState() const {
+  return symbol_table_->GetStateName(GetCurrentStateId());
+}
+
+StateId StateManager::GetCurrentStateId() const {
+  return current_state_.load(std::memory_order_acquire);
+}
+
+std::uint64_t StateManager::GetStateGeneration() const {
+  return state_generation_.load(std::memory_order_acquire);
 }
 
-std::vector<State> StateManager::GetStateHierarchy(const State& state) const {
+std::vector<State> StateManager::GetStateHierarchy(StateId state) const {
   std::lock_guard<std::mutex> lock(state_mutex_);
   std::vector<State> hierarchy;
-  State current = state;
+  StateId current = state;
 
-  while (!current.empty()) {
-    hierarchy.push_back(current);
-    auto it = states_.find(current);
-    if (it == states_.end()) {
-      break;
-    }
-    current = it->second.parent;
+  while (HasState(current)) {
+    hierarchy.push_back(states_[current].name);
+    current = states_[current].parent_id;
   }
 
   return hierarchy;
 }
 
-void StateManager::GetStateHierarchy(const State& from, const State& to,
-                                     std::vector<State>& exit_states,
+void StateManager::GetStateHierarchy(StateId from, StateId to, std::vector<State>& exit_states,
                                      std::vector<State>& enter_states) const {
-  std::lock_guard<std::mutex> lock(state_mutex_);
-  
-  // 获取起始状态的层次结构（内部实现，不需要再次加锁）
-  auto getHierarchyInternal = [this](const State& state) -> std::vector<State> {
-    std::vector<State> hierarchy;
-    State current = state;
-    while (!current.empty()) {
+  const TransitionPath& path = GetTransitionPath(from, to);
+  exit_states = path.exit_states;
+  enter_states = path.enter_states;
+}
+
+const TransitionPath& StateManager::GetTransitionPath(StateId from, StateId to) const {
+  const std::uint64_t key = (static_cast<std::uint64_t>(from) << 32) | to;
+  {
+    std::shared_lock<std::shared_mutex> lock(path_mutex_);
+    auto it = path_cache_.find(key);
+    if (it != path_cache_.end()) {
+      return it->second;
+    }
+  }
+  // 未命中：在锁外计算，插入时若已被其他线程插入则沿用已有结果
+  TransitionPath path;
+  {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    BuildTransitionPath(from, to, path);
+  }
+  std::unique_lock<std::shared_mutex> lock(path_mutex_);
+  return path_cache_.emplace(key, std::move(path)).first->second;
+}
+
+void StateManager::BuildTransitionPath(StateId from, StateId to, TransitionPath& path) const {
+  // 获取状态的层次结构（由内向外）
+  auto getHierarchyInternal = [this](StateId state) -> std::vector<StateId> {
+    std::vector<StateId> hierarchy;
+    StateId current = state;
+    while (HasState(current)) {
       hierarchy.push_back(current);
-      auto it = states_.find(current);
-      if (it == states_.end()) {
-        break;
-      }
-      current = it->second.parent;
+      current = states_[current].parent_id;
     }
     return hierarchy;
   };
-  
+
   auto fromStates = getHierarchyInternal(from);
   auto toStates = getHierarchyInternal(to);
 
@@ -177,16 +234,16 @@ void StateManager::GetStateHierarchy(const State& from, const State& to,
   }
 
   // 添加需要退出的状态
-  exit_states.clear();
+  path.exit_states.clear();
   for (; itFrom != fromStates.rend(); ++itFrom) {
-    exit_states.push_back(*itFrom);
+    path.exit_states.push_back(states_[*itFrom].name);
   }
-  std::reverse(exit_states.begin(), exit_states.end());
+  std::reverse(path.exit_states.begin(), path.exit_states.end());
 
   // 添加需要进入的状态
-  enter_states.clear();
+  path.enter_states.clear();
   for (; itTo != toStates.rend(); ++itTo) {
-    enter_states.push_back(*itTo);
+    path.enter_states.push_back(states_[*itTo].name);
   }
 }
 
@@ -202,57 +259,40 @@ void StateManager::RegisterStateTimeoutCallback(StateTimeoutCallback callback) {
   state_timeout_callback_ = callback;
 }
 
-void StateManager::StateTimeoutLoop() {
-  while (running_) {
-    State timeoutState;
-    bool shouldTriggerTimeout = false;
-
-    {
-      std::unique_lock<std::mutex> lock(timeout_mutex_);
-
-      if (current_state_timeout_.state.empty() || current_state_timeout_.timeout <= 0) {
-        timeout_cv_.wait(lock, [this] {
-          return !running_ ||
-                 (!current_state_timeout_.state.empty() && current_state_timeout_.timeout > 0);
-        });
-
-        if (!running_) {
-          break;
-        }
-      }
+void StateManager::ArmStateTimeoutLocked(std::chrono::steady_clock::time_point expiry) {
+  const std::uint64_t generation = timeout_generation_;
+  current_state_timeout_.expiryTime = expiry;
+  timeout_timer_ = timer_wheel_->Schedule(
+      expiry, [this, generation] { OnStateTimeoutTimer(generation); });
+}
 
-      auto now = std::chrono::steady_clock::now();
-      if (now >= current_state_timeout_.expiryTime) {
-        timeoutState = current_state_timeout_.state;
-        shouldTriggerTimeout = true;
-
-        // 更新下一次超时时间，持续触发直到状态改变
-        current_state_timeout_.expiryTime =
-            now + std::chrono::milliseconds(current_state_timeout_.timeout);
-      } else {
-        auto waitTime = current_state_timeout_.expiryTime;
-        lock.unlock();
-
-        std::unique_lock<std::mutex> waitLock(timeout_mutex_);
-        timeout_cv_.wait_until(waitLock, waitTime, [this, waitTime] {
-          return !running_ || current_state_timeout_.state.empty() ||
-                 current_state_timeout_.expiryTime != waitTime;
-        });
-
-        continue;
-      }
+void StateManager::OnStateTimeoutTimer(std::uint64_t generation) {
+  auto now = std::chrono::steady_clock::now();
+  StateId timeoutState = INVALID_SYMBOL_ID;
+  int timeout = 0;
+  {
+    std::lock_guard<std::mutex> lock(timeout_mutex_);
+    if (!running_ || generation != timeout_generation_) {
+      return;
     }
+    timeout_timer_ = TimingWheel::INVALID_TIMER_ID;
+    timeoutState = current_state_timeout_.state;
+    timeout = current_state_timeout_.timeout;
+  }
+  HandleStateTimeout(timeoutState, timeout);
 
-    if (shouldTriggerTimeout) {
-      HandleStateTimeout();
-    }
+  // 持续触发直到状态改变：从本次触发时间起重新计时（回调中已切换状态时 generation 已变化）
+  std::lock_guard<std::mutex> lock(timeout_mutex_);
+  if (running_ && generation == timeout_generation_ &&
+      timeout_timer_ == TimingWheel::INVALID_TIMER_ID) {
+    ArmStateTimeoutLocked(now + std::chrono::milliseconds(timeout));
   }
 }
 
-void StateManager::HandleStateTimeout() {
-  SMF_LOGI("State timeout triggered for state: " + current_state_);
+void StateManager::HandleStateTimeout(StateId state, int timeout) {
+  SMF_LOGI("State timeout triggered for state: " + symbol_table_->GetStateName(state));
   if (state_timeout_callback_) {
-    state_timeout_callback_(current_state_, current_state_timeout_.timeout);
+    state_timeout_callback_(state, timeout);
   }
 }
 
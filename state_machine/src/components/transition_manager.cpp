@@ -39,15 +39,25 @@
 
 #include "common_define.h"
 #include "logger.h"
+#include "state_machine_metrics.h"
 
 namespace smf {
 
-TransitionManager::TransitionManager() = default;
+TransitionManager::TransitionManager(TimingWheel* timer_wheel, bool compiled)
+    : compiled_(compiled), timer_wheel_(timer_wheel) {}
 
 TransitionManager::~TransitionManager() { Stop(); }
 
 void TransitionManager::Start() {
   bool expected = false;
+  if (running_) {
+    return;
+  }
+  // 编译必须在 running_ 置位之前完成，读取方以 running_ 作为表已发布的标志
+  if (compiled_) {
+    CompileTransitions();
+  }
+  CollectConditionStates();
   if (running_.compare_exchange_strong(expected, true)) {
     SMF_LOGI("TransitionManager started");
   }
@@ -55,9 +65,19 @@ void TransitionManager::Start() {
 
 void TransitionManager::Stop() {
   bool expected = true;
-  if (running_.compare_exchange_strong(expected, false)) {
-    SMF_LOGI("TransitionManager stopped");
+  if (!running_.compare_exchange_strong(expected, false)) {
+    return;
+  }
+  {
+    std::unique_lock<std::shared_mutex> lock(pending_mutex_);
+    for (auto& pending : pending_transitions_) {
+      CancelExpiryTimer(pending);
+    }
+  }
+  if (timer_wheel_) {
+    timer_wheel_->WaitForCallbacks();
   }
+  SMF_LOGI("TransitionManager stopped");
 }
 
 bool TransitionManager::IsRunning() const { return running_; }
@@ -68,29 +88,43 @@ bool TransitionManager::AddTransition(const TransitionRuleSharedPtr& rule) {
     return false;
   }
 
+  if (rule->from_id == INVALID_SYMBOL_ID || rule->events.size() != rule->event_ids.size()) {
+    SMF_LOG(LogLevel::ERROR, "Transition rule ids are not resolved: {} -> {}", rule->from,
+            rule->to);
+    return false;
+  }
+
   // 为每个事件添加转换规则
-  for (const auto& event : rule->events) {
-    TransitionKey key{rule->from, event};
+  for (size_t i = 0; i < rule->event_ids.size(); ++i) {
+    TransitionKey key = MakeTransitionKey(rule->from_id, rule->event_ids[i]);
     {
       std::unique_lock<std::shared_mutex> lock(mutex_);
       transitions_.insert({key, rule});
-
-      std::string log_msg =
-          "Added transition rule: " + rule->from + " -> " + rule->to + " on event " + event;
-      SMF_LOGI(log_msg);
+      SMF_LOG(LogLevel::INFO, "Added transition rule: {} -> {} on event {}", rule->from, rule->to,
+              rule->events[i]);
     }
   }
   return true;
 }
 
-bool TransitionManager::FindTransition(const State& current_state, const EventPtr& event,
+bool TransitionManager::FindTransition(StateId current_state, EventId event,
                                        std::vector<TransitionRuleSharedPtr>& out_rules) {
   if (!running_) {
     SMF_LOGE("TransitionManager is not running");
     return false;
   }
 
-  TransitionKey key{current_state, event->GetName()};
+  if (event == INVALID_SYMBOL_ID) {
+    return false;
+  }
+
+  if (compiled_) {
+    TransitionRuleSpan span = FindCompiledTransitions(current_state, event);
+    out_rules.insert(out_rules.end(), span.begin(), span.end());
+    return !out_rules.empty();
+  }
+
+  TransitionKey key = MakeTransitionKey(current_state, event);
 
   {
     std::shared_lock<std::shared_mutex> lock(mutex_);
@@ -109,6 +143,11 @@ void TransitionManager::Clear() {
     return;
   }
 
+  if (compiled_) {
+    SMF_LOGE("Cannot clear transition rules in compiled mode");
+    return;
+  }
+
   {
     std::unique_lock<std::shared_mutex> lock(mutex_);
     transitions_.clear();
@@ -116,8 +155,74 @@ void TransitionManager::Clear() {
   }
 }
 
+bool TransitionManager::IsCompiled() const { return compiled_; }
+
+TransitionRuleSpan TransitionManager::FindCompiledTransitions(StateId current_state,
+                                                              EventId event) const {
+  if (!compiled_ || !running_ || current_state >= compiled_state_count_ ||
+      event >= compiled_event_count_) {
+    return {};
+  }
+  size_t index = static_cast<size_t>(current_state) * compiled_event_count_ + event;
+  const TransitionRuleSharedPtr* base = compiled_rules_.data();
+  return {base + compiled_offsets_[index], base + compiled_offsets_[index + 1]};
+}
+
+bool TransitionManager::HasConditionTransitions(StateId state) const {
+  if (!running_ || pending_count_.load(std::memory_order_acquire) > 0) {
+    return true;
+  }
+  return state < condition_states_.size() && condition_states_[state] != 0;
+}
+
+void TransitionManager::CollectConditionStates() {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  condition_states_.clear();
+  for (const auto& [key, rule] : transitions_) {
+    if ((key & 0xFFFFFFFFu) != INTERNAL_EVENT_ID) {
+      continue;
+    }
+    size_t state = static_cast<size_t>(key >> 32);
+    if (state >= condition_states_.size()) {
+      condition_states_.resize(state + 1);
+    }
+    condition_states_[state] = 1;
+  }
+}
+
+void TransitionManager::CompileTransitions() {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  compiled_state_count_ = 0;
+  compiled_event_count_ = 0;
+  for (const auto& [key, rule] : transitions_) {
+    compiled_state_count_ =
+        std::max<size_t>(compiled_state_count_, static_cast<size_t>(key >> 32) + 1);
+    compiled_event_count_ =
+        std::max<size_t>(compiled_event_count_, static_cast<size_t>(key & 0xFFFFFFFFu) + 1);
+  }
+
+  // 第一遍统计每个键的规则数，前缀和得到偏移；第二遍按遍历顺序填充
+  compiled_offsets_.assign(compiled_state_count_ * compiled_event_count_ + 1, 0);
+  for (const auto& [key, rule] : transitions_) {
+    size_t index = static_cast<size_t>(key >> 32) * compiled_event_count_ + (key & 0xFFFFFFFFu);
+    ++compiled_offsets_[index + 1];
+  }
+  for (size_t i = 1; i < compiled_offsets_.size(); ++i) {
+    compiled_offsets_[i] += compiled_offsets_[i - 1];
+  }
+  compiled_rules_.assign(transitions_.size(), nullptr);
+  std::vector<std::uint32_t> cursor(compiled_offsets_.begin(), compiled_offsets_.end() - 1);
+  for (const auto& [key, rule] : transitions_) {
+    size_t index = static_cast<size_t>(key >> 32) * compiled_event_count_ + (key & 0xFFFFFFFFu);
+    compiled_rules_[cursor[index]++] = rule;
+  }
+
+  SMF_LOG(LogLevel::INFO, "Compiled {} transition rules into a {}x{} table", compiled_rules_.size(),
+          compiled_state_count_, compiled_event_count_);
+}
+
 bool TransitionManager::AddPendingTransition(
-    const TransitionRuleSharedPtr& rule, const EventPtr& event,
+    const TransitionRuleSharedPtr& rule, EventId event_id, const EventPtr& event,
     const std::vector<ConditionInfo>& unsatisfiedConditions) {
   if (!running_) {
     SMF_LOGE("TransitionManager is not running");
@@ -134,54 +239,77 @@ bool TransitionManager::AddPendingTransition(
 
   {
     std::unique_lock<std::shared_mutex> lock(pending_mutex_);
+    EraseExpiredPendingLocked(now);
 
     // 去重：若相同规则的挂起转移已存在，则不重复添加
     for (const auto& pending : pending_transitions_) {
       if (pending.rule == rule) {
-        SMF_LOGD("Pending transition already exists, skip adding: " + rule->from + " -> " +
-                 rule->to);
+        SMF_LOG(LogLevel::DEBUG, "Pending transition already exists, skip adding: {} -> {}",
+                rule->from, rule->to);
         return false;
       }
     }
 
     PendingTransition pendingTransition{rule,
-                                        {event->GetName(), INTERNAL_EVENT},
+                                        {event_id, INTERNAL_EVENT_ID},
                                         now,
                                         expiryTime,
                                         unsatisfiedConditions,
                                         /*onTransitionInvoked=*/false,
                                         /*originalEvent=*/event};
+    // 挂起时规则条件不满足，之后只有其引用的条件变化才可能使其满足
+    if (!CollectConditionIds(rule->conditions, rule->condition_exprs,
+                             pendingTransition.conditionIds)) {
+      pendingTransition.conditionIds.clear();
+    }
+    if (timer_wheel_) {
+      // 到期后主动清理，不必等到下一次添加或查找
+      pendingTransition.expiryTimer = timer_wheel_->Schedule(
+          expiryTime, [this, rule] { OnPendingTransitionExpired(rule); });
+    }
     pending_transitions_.push_back(std::move(pendingTransition));
-
-    std::string log_msg = "Added pending transition: " + rule->from + " -> " + rule->to +
-                          " on event " + event->GetName() + " with timeout " +
-                          std::to_string(rule->timeout) + "ms";
-    SMF_LOGI(log_msg);
+    pending_count_.store(pending_transitions_.size(), std::memory_order_release);
+    SingleWriterAdd(pending_created_);
+    SMF_LOG(LogLevel::INFO, "Added pending transition: {} -> {} on event {} with timeout {}ms",
+            rule->from, rule->to, event->GetName(), rule->timeout);
   }
 
   return true;
 }
 
-bool TransitionManager::FindPendingTransition(const State& current_state, const EventPtr& event,
-                                              std::vector<TransitionRuleSharedPtr>& out_rules) {
+bool TransitionManager::FindPendingTransition(StateId current_state, EventId event,
+                                              std::vector<TransitionRuleSharedPtr>& out_rules,
+                                              const std::vector<ConditionId>& changed_conditions) {
   if (!running_) {
     SMF_LOGE("TransitionManager is not running");
     return false;
   }
 
+  auto now = std::chrono::steady_clock::now();
   {
     std::shared_lock<std::shared_mutex> lock(pending_mutex_);
     for (const auto& pending : pending_transitions_) {
-      if (pending.rule->from == current_state) {
+      // 已过期但清理定时器尚未执行的挂起转移视为不存在
+      if (pending.rule->from_id == current_state && now < pending.expiryTime) {
         // 检查事件是否匹配
         bool eventMatches = false;
         for (const auto& ruleEvent : pending.triggerEvents) {
-          if (ruleEvent == event->GetName()) {
+          if (ruleEvent == event) {
             eventMatches = true;
             break;
           }
         }
 
+        // 条件变化引发的内部事件只需重新检查依赖变化条件的挂起转移
+        if (eventMatches && event == INTERNAL_EVENT_ID && !changed_conditions.empty() &&
+            !pending.conditionIds.empty()) {
+          eventMatches = std::any_of(
+              changed_conditions.begin(), changed_conditions.end(), [&pending](ConditionId id) {
+                return std::binary_search(pending.conditionIds.begin(),
+                                          pending.conditionIds.end(), id);
+              });
+        }
+
         if (eventMatches) {
           out_rules.push_back(pending.rule);
         }
@@ -201,16 +329,54 @@ void TransitionManager::RemoveExpiredPendingTransitions() {
 
   {
     std::unique_lock<std::shared_mutex> lock(pending_mutex_);
-    auto it = std::remove_if(
-        pending_transitions_.begin(), pending_transitions_.end(),
-        [now](const PendingTransition& pending) { return now >= pending.expiryTime; });
-
-    if (it != pending_transitions_.end()) {
-      size_t removedCount = std::distance(it, pending_transitions_.end());
-      pending_transitions_.erase(it, pending_transitions_.end());
-      SMF_LOGI("Removed " + std::to_string(removedCount) + " expired pending transitions");
+    EraseExpiredPendingLocked(now);
+  }
+}
+
+size_t TransitionManager::EraseExpiredPendingLocked(std::chrono::steady_clock::time_point now) {
+  auto expired = [now](const PendingTransition& pending) { return now >= pending.expiryTime; };
+  for (auto& pending : pending_transitions_) {
+    if (expired(pending)) {
+      CancelExpiryTimer(pending);
     }
   }
+  auto it = std::remove_if(pending_transitions_.begin(), pending_transitions_.end(), expired);
+  size_t removedCount = std::distance(it, pending_transitions_.end());
+  if (removedCount == 0) {
+    return 0;
+  }
+  pending_transitions_.erase(it, pending_transitions_.end());
+  pending_count_.store(pending_transitions_.size(), std::memory_order_release);
+  SingleWriterAdd(pending_expired_, removedCount);
+  SMF_LOG(LogLevel::INFO, "Removed {} expired pending transitions", removedCount);
+  return removedCount;
+}
+
+void TransitionManager::CancelExpiryTimer(PendingTransition& pending) {
+  if (timer_wheel_ && pending.expiryTimer != TimingWheel::INVALID_TIMER_ID) {
+    timer_wheel_->Cancel(pending.expiryTimer);
+    pending.expiryTimer = TimingWheel::INVALID_TIMER_ID;
+  }
+}
+
+void TransitionManager::OnPendingTransitionExpired(const TransitionRuleSharedPtr& rule) {
+  if (!running_) {
+    return;
+  }
+  auto now = std::chrono::steady_clock::now();
+  std::unique_lock<std::shared_mutex> lock(pending_mutex_);
+  auto it = std::find_if(pending_transitions_.begin(), pending_transitions_.end(),
+                         [&rule](const PendingTransition& pending) {
+                           return pending.rule == rule;
+                         });
+  if (it == pending_transitions_.end() || now < it->expiryTime) {
+    return;
+  }
+  // 定时器已在执行，无需撤销
+  pending_transitions_.erase(it);
+  pending_count_.store(pending_transitions_.size(), std::memory_order_release);
+  SingleWriterAdd(pending_expired_);
+  SMF_LOG(LogLevel::INFO, "Pending transition expired: {} -> {}", rule->from, rule->to);
 }
 
 void TransitionManager::RemovePendingTransition(const TransitionRuleSharedPtr& rule) {
@@ -220,11 +386,17 @@ void TransitionManager::RemovePendingTransition(const TransitionRuleSharedPtr& r
 
   {
     std::unique_lock<std::shared_mutex> lock(pending_mutex_);
+    for (auto& pending : pending_transitions_) {
+      if (pending.rule == rule) {
+        CancelExpiryTimer(pending);
+      }
+    }
     pending_transitions_.erase(
         std::remove_if(pending_transitions_.begin(), pending_transitions_.end(),
                        [rule](const PendingTransition& pending) { return pending.rule == rule; }),
         pending_transitions_.end());
-    SMF_LOGI("Removed pending transition: " + rule->from + " -> " + rule->to);
+    pending_count_.store(pending_transitions_.size(), std::memory_order_release);
+    SMF_LOG(LogLevel::INFO, "Removed pending transition: {} -> {}", rule->from, rule->to);
   }
 }
 
@@ -235,7 +407,11 @@ void TransitionManager::ClearPendingTransitions() {
 
   {
     std::unique_lock<std::shared_mutex> lock(pending_mutex_);
+    for (auto& pending : pending_transitions_) {
+      CancelExpiryTimer(pending);
+    }
     pending_transitions_.clear();
+    pending_count_.store(0, std::memory_order_release);
     SMF_LOGI("Cleared all pending transitions");
   }
 }
@@ -288,4 +464,11 @@ EventPtr TransitionManager::GetPendingTransitionOriginalEvent(
   return nullptr;
 }
 
+PendingTransitionStats TransitionManager::GetPendingTransitionStats() const {
+  PendingTransitionStats stats;
+  stats.created = pending_created_.load(std::memory_order_relaxed);
+  stats.expired = pending_expired_.load(std::memory_order_relaxed);
+  return stats;
+}
+
 }  // namespace smf
\ No newline at end of file
@@ -0,0 +1,97 @@
+/**
+ * @file event_pool.cpp
+ * @brief Implementation of the per-state-machine pool of recycled internal events
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @details This file contains the implementation of the EventPool class.
+ * @version 1.0.0
+ **/
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2025 xiaokui.hu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "event_pool.h"
+
+#include <atomic>
+
+#include "symbol_table.h"
+
+namespace smf {
+
+EventPool::EventPool(const SymbolTable* symbol_table, std::size_t max_per_event)
+    : symbol_table_(symbol_table), max_per_event_(max_per_event) {}
+
+void EventPool::Reserve() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (slots_.size() < symbol_table_->GetEventCount()) {
+    slots_.resize(symbol_table_->GetEventCount());
+  }
+}
+
+EventPtr EventPool::Acquire(EventId id, const std::vector<ConditionInfo>& matched_conditions) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (id >= slots_.size()) {
+    slots_.resize(id + 1);
+  }
+  auto& slot = slots_[id];
+  for (const auto& event : slot) {
+    // use_count() 为宽松读取：读到 1 后以 acquire 栅栏与其他持有者最后一次释放同步，
+    // 之后才能改写对象
+    if (event.use_count() == 1) {
+      std::atomic_thread_fence(std::memory_order_acquire);
+      event->AssignMatchedConditions(matched_conditions);
+      ++reused_;
+      return event;
+    }
+  }
+  EventPtr event = std::make_shared<Event>(symbol_table_->GetEventName(id));
+  event->SetId(id, symbol_table_);
+  event->AssignMatchedConditions(matched_conditions);
+  ++created_;
+  if (slot.size() < max_per_event_) {
+    slot.push_back(event);
+  }
+  return event;
+}
+
+std::size_t EventPool::Size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::size_t size = 0;
+  for (const auto& slot : slots_) {
+    size += slot.size();
+  }
+  return size;
+}
+
+std::uint64_t EventPool::GetReusedCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return reused_;
+}
+
+std::uint64_t EventPool::GetCreatedCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return created_;
+}
+
+}  // namespace smf
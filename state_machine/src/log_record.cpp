@@ -0,0 +1,342 @@
+/**
+ * @file log_record.cpp
+ * @brief Implementation of deferred log record formatting
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @details This file contains the implementation of LogLineFormatter.
+ * @version 1.0.0
+ **/
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2025 xiaokui.hu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "log_record.h"
+
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+
+namespace smf {
+
+namespace {
+
+// 解码后的一个参数
+struct LogArg {
+  LogArgType type = LogArgType::INT64;
+  std::int64_t int_value = 0;
+  std::uint64_t uint_value = 0;
+  double double_value = 0;
+  bool bool_value = false;
+  char char_value = 0;
+  std::string_view string_value;
+};
+
+template <typename T>
+bool ReadValue(std::string_view* data, T* value) {
+  if (data->size() < sizeof(T)) {
+    return false;
+  }
+  std::memcpy(value, data->data(), sizeof(T));
+  data->remove_prefix(sizeof(T));
+  return true;
+}
+
+bool ReadArg(std::string_view* data, LogArg* arg) {
+  std::uint8_t tag = 0;
+  if (!ReadValue(data, &tag)) {
+    return false;
+  }
+  arg->type = static_cast<LogArgType>(tag);
+  switch (arg->type) {
+    case LogArgType::INT64:
+      return ReadValue(data, &arg->int_value);
+    case LogArgType::UINT64:
+      return ReadValue(data, &arg->uint_value);
+    case LogArgType::DOUBLE:
+      return ReadValue(data, &arg->double_value);
+    case LogArgType::BOOL:
+      return ReadValue(data, &arg->bool_value);
+    case LogArgType::CHAR:
+      return ReadValue(data, &arg->char_value);
+    case LogArgType::STRING: {
+      std::uint32_t length = 0;
+      if (!ReadValue(data, &length) || data->size() < length) {
+        return false;
+      }
+      arg->string_value = data->substr(0, length);
+      data->remove_prefix(length);
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+template <typename T>
+void AppendNumber(std::string* out, T value) {
+  char buffer[32];
+  auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+  out->append(buffer, result.ptr);
+}
+
+void AppendDouble(std::string* out, double value, const char* format) {
+  char buffer[32];
+  int length = std::snprintf(buffer, sizeof(buffer), format, value);
+  out->append(buffer, length > 0 ? static_cast<std::size_t>(length) : 0);
+}
+
+void AppendArgText(std::string* out, const LogArg& arg) {
+  switch (arg.type) {
+    case LogArgType::INT64:
+      AppendNumber(out, arg.int_value);
+      break;
+    case LogArgType::UINT64:
+      AppendNumber(out, arg.uint_value);
+      break;
+    case LogArgType::DOUBLE:
+      AppendDouble(out, arg.double_value, "%g");
+      break;
+    case LogArgType::BOOL:
+      out->append(arg.bool_value ? "true" : "false");
+      break;
+    case LogArgType::CHAR:
+      out->push_back(arg.char_value);
+      break;
+    case LogArgType::STRING:
+      out->append(arg.string_value);
+      break;
+  }
+}
+
+void AppendJsonString(std::string* out, std::string_view text) {
+  static const char kHex[] = "0123456789abcdef";
+  out->push_back('"');
+  for (char c : text) {
+    switch (c) {
+      case '"':
+        out->append("\\\"");
+        break;
+      case '\\':
+        out->append("\\\\");
+        break;
+      case '\n':
+        out->append("\\n");
+        break;
+      case '\r':
+        out->append("\\r");
+        break;
+      case '\t':
+        out->append("\\t");
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          out->append("\\u00");
+          out->push_back(kHex[(c >> 4) & 0xf]);
+          out->push_back(kHex[c & 0xf]);
+        } else {
+          out->push_back(c);
+        }
+    }
+  }
+  out->push_back('"');
+}
+
+void AppendArgJson(std::string* out, const LogArg& arg) {
+  switch (arg.type) {
+    case LogArgType::DOUBLE:
+      if (std::isfinite(arg.double_value)) {
+        AppendDouble(out, arg.double_value, "%.17g");
+      } else {
+        out->append("null");
+      }
+      break;
+    case LogArgType::CHAR:
+      AppendJsonString(out, std::string_view(&arg.char_value, 1));
+      break;
+    case LogArgType::STRING:
+      AppendJsonString(out, arg.string_value);
+      break;
+    default:
+      AppendArgText(out, arg);
+  }
+}
+
+const char* LevelName(std::uint8_t level) {
+  switch (level) {
+    case 0:
+      return "DEBUG";
+    case 1:
+      return "INFO";
+    case 2:
+      return "WARN";
+    case 3:
+      return "ERROR";
+    default:
+      return "UNKNOWN";
+  }
+}
+
+// 文本行中的级别标签（与原有文本格式一致，INFO 与 WARN 后补空格对齐）
+const char* LevelTag(std::uint8_t level, bool color) {
+  switch (level) {
+    case 0:
+      return color ? "\033[37m[DEBUG]" : "[DEBUG]";
+    case 1:
+      return color ? "\033[32m[INFO] " : "[INFO] ";
+    case 2:
+      return color ? "\033[33m[WARN] " : "[WARN] ";
+    case 3:
+      return color ? "\033[31m[ERROR]" : "[ERROR]";
+    default:
+      return "[UNKNOWN]";
+  }
+}
+
+void FormatTwoDigits(char* out, int value) {
+  out[0] = static_cast<char>('0' + value / 10);
+  out[1] = static_cast<char>('0' + value % 10);
+}
+
+void AppendMillis(std::string* out, std::int64_t timestamp_ms) {
+  int millis = static_cast<int>(timestamp_ms % 1000);
+  out->push_back(static_cast<char>('0' + millis / 100));
+  out->push_back(static_cast<char>('0' + millis / 10 % 10));
+  out->push_back(static_cast<char>('0' + millis % 10));
+}
+
+}  // namespace
+
+void LogLineFormatter::UpdateTime(std::int64_t timestamp_ms) {
+  std::int64_t second = timestamp_ms / 1000;
+  if (second == second_) {
+    return;
+  }
+  second_ = second;
+  std::time_t now_c = static_cast<std::time_t>(second);
+  std::tm local_time{};
+  localtime_r(&now_c, &local_time);
+  int year = (local_time.tm_year + 1900) % 10000;
+  FormatTwoDigits(date_, year / 100);
+  FormatTwoDigits(date_ + 2, year % 100);
+  date_[4] = '-';
+  FormatTwoDigits(date_ + 5, local_time.tm_mon + 1);
+  date_[7] = '-';
+  FormatTwoDigits(date_ + 8, local_time.tm_mday);
+  FormatTwoDigits(time_, local_time.tm_hour);
+  time_[2] = ':';
+  FormatTwoDigits(time_ + 3, local_time.tm_min);
+  time_[5] = ':';
+  FormatTwoDigits(time_ + 6, local_time.tm_sec);
+}
+
+bool LogLineFormatter::AppendMessage(std::string* out, const LogRecordView& record) {
+  if (record.format.empty()) {
+    out->append(record.data);
+    return true;
+  }
+  std::string_view data = record.data;
+  std::string_view format = record.format;
+  for (std::size_t i = 0; i < format.size(); ++i) {
+    char c = format[i];
+    if ((c == '{' || c == '}') && i + 1 < format.size() && format[i + 1] == c) {
+      out->push_back(c);
+      ++i;
+    } else if (c == '{' && i + 1 < format.size() && format[i + 1] == '}') {
+      LogArg arg;
+      if (!ReadArg(&data, &arg)) {
+        return false;
+      }
+      AppendArgText(out, arg);
+      ++i;
+    } else {
+      out->push_back(c);
+    }
+  }
+  return data.empty();
+}
+
+void LogLineFormatter::AppendText(std::string* out, const LogRecordView& record, bool color) {
+  UpdateTime(record.timestamp_ms);
+  out->push_back('[');
+  out->append(time_, sizeof(time_) - 1);
+  out->push_back('.');
+  AppendMillis(out, record.timestamp_ms);
+  out->append("] ");
+  out->append(LevelTag(record.level, color));
+  out->append(" [");
+  out->append(record.file);
+  out->push_back(':');
+  AppendNumber(out, record.line);
+  out->append(" - ");
+  out->append(record.thread);
+  out->append("] ");
+  if (!AppendMessage(out, record)) {
+    out->append(" <malformed log arguments>");
+  }
+  if (color) {
+    out->append("\033[0m");
+  }
+}
+
+void LogLineFormatter::AppendJson(std::string* out, const LogRecordView& record) {
+  UpdateTime(record.timestamp_ms);
+  out->append("{\"time\":\"");
+  out->append(date_, sizeof(date_) - 1);
+  out->push_back('T');
+  out->append(time_, sizeof(time_) - 1);
+  out->push_back('.');
+  AppendMillis(out, record.timestamp_ms);
+  out->append("\",\"level\":\"");
+  out->append(LevelName(record.level));
+  out->append("\",\"file\":");
+  AppendJsonString(out, record.file);
+  out->append(",\"line\":");
+  AppendNumber(out, record.line);
+  out->append(",\"thread\":");
+  AppendJsonString(out, record.thread);
+  out->append(",\"message\":");
+  message_.clear();
+  AppendMessage(&message_, record);
+  AppendJsonString(out, message_);
+  if (!record.format.empty()) {
+    out->append(",\"format\":");
+    AppendJsonString(out, record.format);
+    out->append(",\"args\":[");
+    std::string_view data = record.data;
+    LogArg arg;
+    bool first = true;
+    while (!data.empty() && ReadArg(&data, &arg)) {
+      if (!first) {
+        out->push_back(',');
+      }
+      first = false;
+      AppendArgJson(out, arg);
+    }
+    out->push_back(']');
+  }
+  out->push_back('}');
+}
+
+}  // namespace smf
@@ -0,0 +1,208 @@
+/**
+ * @file range_set.cpp
+ * @brief Implementation of the sorted range sets and range-membership kernels
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @details This file contains the implementation of the RangeSet and RangeSetBatch classes.
+ *          The vector kernels are selected at compile time: AVX2 when the library is built with
+ *          -mavx2 (SMF_ENABLE_AVX2), SSE2 on other x86-64 builds, and a scalar loop elsewhere.
+ * @version 1.0.0
+ **/
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2025 xiaokui.hu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "range_set.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SMF_RANGE_AVX2 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define SMF_RANGE_SSE2 1
+#endif
+
+namespace smf {
+
+namespace {
+
+// 范围数达到该值时改用二分查找，取自 range_set_bench 中线性扫描与二分查找的交点
+#if defined(SMF_RANGE_AVX2)
+constexpr std::size_t kBinarySearchThreshold = 40;
+#elif defined(SMF_RANGE_SSE2)
+constexpr std::size_t kBinarySearchThreshold = 12;
+#else
+constexpr std::size_t kBinarySearchThreshold = 8;
+#endif
+
+// 向量化扫描中，返回块内落在范围内的通道位图（每个 int 通道一位）
+#if defined(SMF_RANGE_AVX2)
+constexpr std::size_t kLanes = 8;
+
+inline unsigned InRangeLanes(const int* mins, const int* maxs, __m256i value) noexcept {
+  __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mins));
+  __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(maxs));
+  // 不在范围内：下界 > value 或 value > 上界
+  __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi32(lo, value), _mm256_cmpgt_epi32(value, hi));
+  return ~static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(outside))) & 0xFFu;
+}
+
+inline __m256i Broadcast(int value) noexcept { return _mm256_set1_epi32(value); }
+#elif defined(SMF_RANGE_SSE2)
+constexpr std::size_t kLanes = 4;
+
+inline unsigned InRangeLanes(const int* mins, const int* maxs, __m128i value) noexcept {
+  __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mins));
+  __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(maxs));
+  __m128i outside = _mm_or_si128(_mm_cmpgt_epi32(lo, value), _mm_cmpgt_epi32(value, hi));
+  return ~static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(outside))) & 0xFu;
+}
+
+inline __m128i Broadcast(int value) noexcept { return _mm_set1_epi32(value); }
+#endif
+
+}  // namespace
+
+void RangeSet::Assign(const std::vector<std::pair<int, int>>& ranges) {
+  std::vector<std::pair<int, int>> sorted;
+  sorted.reserve(ranges.size());
+  for (const auto& range : ranges) {
+    if (range.first <= range.second) {
+      sorted.push_back(range);
+    }
+  }
+  std::sort(sorted.begin(), sorted.end());
+
+  mins_.clear();
+  maxs_.clear();
+  for (const auto& range : sorted) {
+    // 与上一个范围重叠或相邻时合并
+    if (!maxs_.empty() && static_cast<long long>(range.first) <= maxs_.back() + 1LL) {
+      maxs_.back() = std::max(maxs_.back(), range.second);
+    } else {
+      mins_.push_back(range.first);
+      maxs_.push_back(range.second);
+    }
+  }
+}
+
+bool RangeSet::ContainsSorted(const int* mins, const int* maxs, std::size_t count,
+                              int value) noexcept {
+  if (count >= kBinarySearchThreshold) {
+    return ContainsBinarySearch(mins, maxs, count, value);
+  }
+  return ContainsSimd(mins, maxs, count, value);
+}
+
+bool RangeSet::ContainsScalar(const int* mins, const int* maxs, std::size_t count,
+                              int value) noexcept {
+  for (std::size_t i = 0; i < count; ++i) {
+    if (value < mins[i]) {
+      return false;
+    }
+    if (value <= maxs[i]) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool RangeSet::ContainsSimd(const int* mins, const int* maxs, std::size_t count,
+                            int value) noexcept {
+  std::size_t i = 0;
+  unsigned lanes = 0;
+#if defined(SMF_RANGE_AVX2) || defined(SMF_RANGE_SSE2)
+  // 逐块累积命中通道，循环内不提前退出，探测值随机时也没有分支预测失败
+  const auto broadcast = Broadcast(value);
+  for (; i + kLanes <= count; i += kLanes) {
+    lanes |= InRangeLanes(mins + i, maxs + i, broadcast);
+  }
+#endif
+  for (; i < count; ++i) {
+    lanes |= static_cast<unsigned>(value >= mins[i]) & static_cast<unsigned>(value <= maxs[i]);
+  }
+  return lanes != 0;
+}
+
+bool RangeSet::ContainsBinarySearch(const int* mins, const int* maxs, std::size_t count,
+                                    int value) noexcept {
+  if (count == 0) {
+    return false;
+  }
+  // 找到最后一个下界 <= value 的范围，只需再比较它的上界。
+  // 每步只移动基址不分支（编译为条件传送），探测值随机时不受分支预测失败影响
+  const int* base = mins;
+  for (std::size_t n = count; n > 1;) {
+    const std::size_t half = n / 2;
+    base = base[half] <= value ? base + half : base;
+    n -= half;
+  }
+  return *base <= value && value <= maxs[base - mins];
+}
+
+const char* RangeSet::SimdKernelName() noexcept {
+#if defined(SMF_RANGE_AVX2)
+  return "avx2";
+#elif defined(SMF_RANGE_SSE2)
+  return "sse2";
+#else
+  return "scalar";
+#endif
+}
+
+std::size_t RangeSetBatch::Add(const RangeSet& set) {
+  const auto index = static_cast<std::uint32_t>(set_count_++);
+  mins_.insert(mins_.end(), set.Mins().begin(), set.Mins().end());
+  maxs_.insert(maxs_.end(), set.Maxs().begin(), set.Maxs().end());
+  owners_.insert(owners_.end(), set.Size(), index);
+  return index;
+}
+
+void RangeSetBatch::Contains(int value, std::uint8_t* out) const noexcept {
+  if (set_count_ == 0) {
+    return;
+  }
+  std::memset(out, 0, set_count_);
+  const std::size_t count = mins_.size();
+  std::size_t i = 0;
+#if defined(SMF_RANGE_AVX2) || defined(SMF_RANGE_SSE2)
+  const auto broadcast = Broadcast(value);
+  for (; i + kLanes <= count; i += kLanes) {
+    for (unsigned lanes = InRangeLanes(&mins_[i], &maxs_[i], broadcast); lanes != 0;
+         lanes &= lanes - 1) {
+      out[owners_[i + static_cast<std::size_t>(__builtin_ctz(lanes))]] = 1;
+    }
+  }
+#endif
+  for (; i < count; ++i) {
+    if (value >= mins_[i] && value <= maxs_[i]) {
+      out[owners_[i]] = 1;
+    }
+  }
+}
+
+}  // namespace smf
@@ -0,0 +1,160 @@
+/**
+ * @file shared_executor.cpp
+ * @brief Implementation of the shared worker pool and strands
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @details This file contains the implementation of the SharedExecutor and Strand classes.
+ * @version 1.0.0
+ **/
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2025 xiaokui.hu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "shared_executor.h"
+
+#include <algorithm>
+#include <exception>
+#include <string>
+
+#include "logger.h"
+
+namespace smf {
+
+namespace {
+
+// 当前线程正在执行的 Strand
+thread_local const Strand* tls_current_strand = nullptr;
+
+}  // namespace
+
+void Strand::Post(Task task) {
+  bool need_schedule = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(std::move(task));
+    need_schedule = !scheduled_;
+    scheduled_ = true;
+  }
+  if (need_schedule) {
+    executor_->Schedule(shared_from_this());
+  }
+}
+
+void Strand::PostAt(std::chrono::steady_clock::time_point deadline, Task task) {
+  std::weak_ptr<Strand> weak = weak_from_this();
+  executor_->timers_.Schedule(deadline, [weak, task = std::move(task)] {
+    if (auto strand = weak.lock()) {
+      strand->Post(task);
+    }
+  });
+}
+
+bool Strand::RunningInThisThread() const { return tls_current_strand == this; }
+
+bool Strand::RunPending() {
+  {
+    // 与待执行队列整体交换，执行期间新投递的任务留到下一轮
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_tasks_.swap(tasks_);
+  }
+  const Strand* previous = tls_current_strand;
+  tls_current_strand = this;
+  for (auto& task : running_tasks_) {
+    try {
+      task();
+    } catch (const std::exception& e) {
+      SMF_LOGE(std::string("Strand task threw an exception: ") + e.what());
+    } catch (...) {
+      SMF_LOGE("Strand task threw an unknown exception");
+    }
+  }
+  tls_current_strand = previous;
+  running_tasks_.clear();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (tasks_.empty()) {
+    scheduled_ = false;
+    return false;
+  }
+  return true;
+}
+
+SharedExecutor::SharedExecutor(size_t threads) {
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  workers_.reserve(threads);
+  for (size_t i = 0; i < threads; ++i) {
+    workers_.emplace_back(&SharedExecutor::WorkerLoop, this);
+  }
+  timers_.Start();
+}
+
+SharedExecutor::~SharedExecutor() {
+  // 先停止定时线程，不再产生新任务；工作线程执行完就绪队列中的任务后退出
+  timers_.Stop();
+  {
+    std::lock_guard<std::mutex> lock(ready_mutex_);
+    stopping_ = true;
+  }
+  ready_cv_.notify_all();
+  for (auto& worker : workers_) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+}
+
+std::shared_ptr<Strand> SharedExecutor::CreateStrand() {
+  return std::shared_ptr<Strand>(new Strand(this));
+}
+
+void SharedExecutor::Schedule(std::shared_ptr<Strand> strand) {
+  {
+    std::lock_guard<std::mutex> lock(ready_mutex_);
+    ready_.push_back(std::move(strand));
+  }
+  ready_cv_.notify_one();
+}
+
+void SharedExecutor::WorkerLoop() {
+  for (;;) {
+    std::shared_ptr<Strand> strand;
+    {
+      std::unique_lock<std::mutex> lock(ready_mutex_);
+      ready_cv_.wait(lock, [this] { return stopping_ || !ready_.empty(); });
+      if (ready_.empty()) {
+        return;
+      }
+      strand = std::move(ready_.front());
+      ready_.pop_front();
+    }
+    // 每次只执行一批任务，仍有任务时排到队尾，避免单个繁忙的 Strand 占住工作线程
+    if (strand->RunPending()) {
+      Schedule(std::move(strand));
+    }
+  }
+}
+
+}  // namespace smf
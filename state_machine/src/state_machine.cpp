@@ -34,6 +34,7 @@
 #include "state_machine.h"
 
 #include <algorithm>
+#include <future>
 #include <stdexcept>
 #include <vector>
 
@@ -48,20 +49,37 @@
 
 namespace smf {
 
-FiniteStateMachine::FiniteStateMachine(const std::string& name)
+FiniteStateMachine::FiniteStateMachine(const std::string& name,
+                                       const StateMachineOptions& options,
+                                       std::shared_ptr<SharedExecutor> executor,
+                                       std::shared_ptr<TimingWheel> timer_wheel)
     : name_(name),
+      options_(options),
       running_(false),
       initialized_(false),
       state_event_handler_(std::make_shared<StateEventHandler>()),
-      transition_manager_(std::make_unique<TransitionManager>()),
-      state_manager_(std::make_unique<StateManager>()),
-      condition_manager_(std::make_unique<ConditionManager>()),
-      event_handler_(std::make_unique<EventHandler>(state_manager_.get(), condition_manager_.get(),
-                                                    transition_manager_.get(),
-                                                    state_event_handler_)),
-      config_loader_(std::make_unique<ConfigLoader>(state_manager_.get(), condition_manager_.get(),
-                                                    transition_manager_.get(),
-                                                    event_handler_.get())) {}
+      symbol_table_(std::make_unique<SymbolTable>()),
+      timer_wheel_(timer_wheel ? std::move(timer_wheel) : std::make_shared<TimingWheel>()),
+      transition_manager_(std::make_unique<TransitionManager>(timer_wheel_.get(),
+                                                              options.compiled_transitions)),
+      state_manager_(std::make_unique<StateManager>(symbol_table_.get(), timer_wheel_.get())),
+      // 共享线程池模式下组件同样以同步方式运行，由 Strand 保证串行
+      condition_manager_(std::make_unique<ConditionManager>(
+          symbol_table_.get(), timer_wheel_.get(), options.execution != ExecutionMode::THREADED)),
+      event_handler_(std::make_unique<EventHandler>(
+          symbol_table_.get(), state_manager_.get(), condition_manager_.get(),
+          transition_manager_.get(), state_event_handler_,
+          options.execution == ExecutionMode::THREADED ? CreateEventQueue(options) : nullptr,
+          options.execution != ExecutionMode::THREADED, options.latency_metrics)),
+      config_loader_(std::make_unique<ConfigLoader>(
+          symbol_table_.get(), state_manager_.get(), condition_manager_.get(),
+          transition_manager_.get(), event_handler_.get(), options.config_load_threads)),
+      executor_(options.execution == ExecutionMode::SHARED_POOL ? std::move(executor) : nullptr),
+      strand_(executor_ ? executor_->CreateStrand() : nullptr) {
+  if (options.execution == ExecutionMode::SHARED_POOL && !executor_) {
+    SMF_LOGE("Shared pool execution requires an executor: " + name);
+  }
+}
 
 bool FiniteStateMachine::Init(const std::string& configDir) {
   if (initialized_) {
@@ -123,25 +141,157 @@ bool FiniteStateMachine::Start() {
     SMF_LOGW("State machine already running!");
     return false;
   }
+  DispatchAndWait([this] {
+    StartComponents();
+    ArmTimer();
+  });
+  return true;
+}
+
+void FiniteStateMachine::Stop() {
+  DispatchAndWait([this] { StopComponents(); });
+}
+
+bool FiniteStateMachine::OwnsTimerThread() const {
+  return options_.execution == ExecutionMode::THREADED && !options_.shared_timer_thread;
+}
+
+void FiniteStateMachine::StartComponents() {
+  if (OwnsTimerThread()) {
+    timer_wheel_->Start();
+  }
   config_loader_->Start();
   event_handler_->Start();
   condition_manager_->Start();
   state_manager_->Start();
   transition_manager_->Start();
   running_ = true;
-  return true;
 }
 
-void FiniteStateMachine::Stop() {
+void FiniteStateMachine::StopComponents() {
   config_loader_->Stop();
   running_ = false;
   event_handler_->Stop();
   condition_manager_->Stop();
   state_manager_->Stop();
   transition_manager_->Stop();
+  if (OwnsTimerThread()) {
+    timer_wheel_->Stop();
+  }
 }
 
-void FiniteStateMachine::HandleEvent(const EventPtr& event) { event_handler_->HandleEvent(event); }
+void FiniteStateMachine::HandleEvent(const EventPtr& event) {
+  if (!strand_) {
+    event_handler_->HandleEvent(event);
+    return;
+  }
+  Dispatch([this, event] { event_handler_->HandleEvent(event); });
+}
+
+void FiniteStateMachine::HandleEvents(const EventPtr* events, size_t count) {
+  if (!strand_) {
+    event_handler_->HandleEvents(events, count);
+    return;
+  }
+  // 整批作为一个任务投递，只做一次 Strand 同步
+  Dispatch([this, batch = std::vector<EventPtr>(events, events + count)] {
+    event_handler_->HandleEvents(batch.data(), batch.size());
+  });
+}
+
+void FiniteStateMachine::Dispatch(std::function<void()> task) {
+  if (!strand_ || strand_->RunningInThisThread()) {
+    task();
+    return;
+  }
+  // 任务排队期间状态机可能被销毁，持有弱引用，执行时再确认
+  std::weak_ptr<FiniteStateMachine> weak = weak_from_this();
+  strand_->Post([weak, task = std::move(task)] {
+    auto self = weak.lock();
+    if (!self) {
+      return;
+    }
+    task();
+    self->ArmTimer();
+  });
+}
+
+void FiniteStateMachine::DispatchAndWait(const std::function<void()>& task) {
+  // 析构过程中已没有共享所有者，也就不会有本状态机的任务正在 Strand 上执行，直接运行
+  if (!strand_ || strand_->RunningInThisThread() || weak_from_this().expired()) {
+    task();
+    return;
+  }
+  std::promise<void> done;
+  std::future<void> result = done.get_future();
+  strand_->Post([&task, &done] {
+    try {
+      task();
+      done.set_value();
+    } catch (...) {
+      done.set_exception(std::current_exception());
+    }
+  });
+  result.get();
+}
+
+void FiniteStateMachine::ArmTimer() {
+  if (!strand_ || !running_) {
+    return;
+  }
+  auto deadline = GetNextDeadline();
+  if (deadline == std::chrono::steady_clock::time_point::max() || deadline >= armed_deadline_) {
+    return;
+  }
+  // 只在到期时间提前时登记；到期时间推后时，先到期的定时器触发一次空的 Poll 后重新登记
+  armed_deadline_ = deadline;
+  std::weak_ptr<FiniteStateMachine> weak = weak_from_this();
+  strand_->PostAt(deadline, [weak] {
+    auto self = weak.lock();
+    if (!self) {
+      return;
+    }
+    self->armed_deadline_ = std::chrono::steady_clock::time_point::max();
+    if (self->running_) {
+      self->PollTimers(std::chrono::steady_clock::now());
+    }
+    self->ArmTimer();
+  });
+}
+
+void FiniteStateMachine::HandleEvents(const std::vector<EventPtr>& events) {
+  HandleEvents(events.data(), events.size());
+}
+
+std::chrono::steady_clock::time_point FiniteStateMachine::Poll(
+    std::chrono::steady_clock::time_point now) {
+  if (options_.execution != ExecutionMode::INLINE) {
+    SMF_LOGW("Poll is only needed in inline execution mode, ignored");
+    return std::chrono::steady_clock::time_point::max();
+  }
+  if (!running_) {
+    return std::chrono::steady_clock::time_point::max();
+  }
+  PollTimers(now);
+  // 处理过程中可能发生状态转移或新的条件变化，重新计算下一次到期时间
+  return GetNextDeadline();
+}
+
+void FiniteStateMachine::PollTimers(std::chrono::steady_clock::time_point now) {
+  timer_wheel_->Advance(now);
+}
+
+std::chrono::steady_clock::time_point FiniteStateMachine::RunUntilIdle() {
+  auto next = Poll(std::chrono::steady_clock::now());
+  while (running_ && next <= std::chrono::steady_clock::now()) {
+    next = Poll(std::chrono::steady_clock::now());
+  }
+  return next;
+}
+
+std::chrono::steady_clock::time_point FiniteStateMachine::GetNextDeadline() const {
+  return timer_wheel_->GetNextDeadline();
+}
 
 void FiniteStateMachine::SetTransitionCallback(StateEventHandler::TransitionCallback callback) {
   if (running_) {
@@ -218,14 +368,45 @@ void FiniteStateMachine::SetStateEventHandler(std::shared_ptr<StateEventHandler>
   }
 }
 
-State FiniteStateMachine::GetCurrentState() const { return state_manager_->GetCurrentState(); }
+const State& FiniteStateMachine::GetCurrentState() const {
+  return state_manager_->GetCurrentState();
+}
+
+std::uint64_t FiniteStateMachine::GetStateGeneration() const {
+  return state_manager_->GetStateGeneration();
+}
 
 void FiniteStateMachine::SetConditionValue(const std::string& name, int value) {
-  condition_manager_->SetConditionValue(name, value);
+  if (!strand_) {
+    condition_manager_->SetConditionValue(name, value);
+    return;
+  }
+  Dispatch([this, name, value] { condition_manager_->SetConditionValue(name, value); });
+}
+
+void FiniteStateMachine::SetConditionValues(
+    const std::vector<std::pair<std::string, int>>& values) {
+  if (!strand_) {
+    condition_manager_->SetConditionValues(values);
+    return;
+  }
+  Dispatch([this, values] { condition_manager_->SetConditionValues(values); });
 }
 
 void FiniteStateMachine::GetConditionValue(const std::string& name, int& value) const {
   condition_manager_->GetConditionValue(name, value);
 }
 
+InternalEventStats FiniteStateMachine::GetInternalEventStats() const {
+  return event_handler_->GetInternalEventStats();
+}
+
+StateMachineMetrics FiniteStateMachine::GetMetrics() const {
+  StateMachineMetrics metrics;
+  event_handler_->GetMetrics(metrics);
+  metrics.condition_updates = condition_manager_->GetConditionUpdateCount();
+  metrics.pending_transitions = transition_manager_->GetPendingTransitionStats();
+  return metrics;
+}
+
 }  // namespace smf
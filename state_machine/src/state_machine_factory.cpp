@@ -40,6 +40,9 @@ namespace smf {
 std::unordered_map<std::string, std::shared_ptr<FiniteStateMachine>>
     StateMachineFactory::state_machines_;
 std::mutex StateMachineFactory::mutex_;
+std::shared_ptr<SharedExecutor> StateMachineFactory::shared_executor_;
+size_t StateMachineFactory::shared_executor_threads_ = 0;
+std::shared_ptr<TimingWheel> StateMachineFactory::shared_timing_wheel_;
 
 std::vector<std::string> StateMachineFactory::GetAllStateMachineNames() {
   std::lock_guard<std::mutex> lock(mutex_);
@@ -51,13 +54,22 @@ std::vector<std::string> StateMachineFactory::GetAllStateMachineNames() {
 }
 
 std::shared_ptr<FiniteStateMachine> StateMachineFactory::CreateStateMachine(
-    const std::string& name) {
+    const std::string& name, const StateMachineOptions& options) {
   std::lock_guard<std::mutex> lock(mutex_);
   if (state_machines_.find(name) != state_machines_.end()) {
     SMF_LOGW("State machine with name:  " + name + " already exists");
     return state_machines_[name];
   }
-  auto state_machine = std::shared_ptr<FiniteStateMachine>(new FiniteStateMachine(name));
+  std::shared_ptr<SharedExecutor> executor;
+  if (options.execution == ExecutionMode::SHARED_POOL) {
+    executor = GetSharedExecutorLocked();
+  }
+  std::shared_ptr<TimingWheel> timer_wheel;
+  if (options.execution == ExecutionMode::THREADED && options.shared_timer_thread) {
+    timer_wheel = GetSharedTimingWheelLocked();
+  }
+  auto state_machine = std::shared_ptr<FiniteStateMachine>(
+      new FiniteStateMachine(name, options, executor, timer_wheel));
   state_machines_[name] = state_machine;
   return state_machine;
 }
@@ -77,4 +89,43 @@ StateMachineFactory::GetAllStateMachines() {
   return state_machines_;
 }
 
+bool StateMachineFactory::SetSharedExecutorThreads(size_t threads) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (shared_executor_) {
+    SMF_LOGE("Shared executor already created with " +
+             std::to_string(shared_executor_->GetThreadCount()) + " threads");
+    return false;
+  }
+  shared_executor_threads_ = threads;
+  return true;
+}
+
+std::shared_ptr<SharedExecutor> StateMachineFactory::GetSharedExecutor() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return GetSharedExecutorLocked();
+}
+
+std::shared_ptr<SharedExecutor> StateMachineFactory::GetSharedExecutorLocked() {
+  if (!shared_executor_) {
+    shared_executor_ = std::make_shared<SharedExecutor>(shared_executor_threads_);
+    SMF_LOGI("Shared executor created with " +
+             std::to_string(shared_executor_->GetThreadCount()) + " threads");
+  }
+  return shared_executor_;
+}
+
+std::shared_ptr<TimingWheel> StateMachineFactory::GetSharedTimingWheel() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return GetSharedTimingWheelLocked();
+}
+
+std::shared_ptr<TimingWheel> StateMachineFactory::GetSharedTimingWheelLocked() {
+  if (!shared_timing_wheel_) {
+    shared_timing_wheel_ = std::make_shared<TimingWheel>();
+    shared_timing_wheel_->Start();
+    SMF_LOGI("Shared timing wheel created");
+  }
+  return shared_timing_wheel_;
+}
+
 }  // namespace smf
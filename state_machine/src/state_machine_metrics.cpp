@@ -0,0 +1,102 @@
+/**
+ * @file state_machine_metrics.cpp
+ * @brief Implementation of the state machine metrics primitives
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @details This file contains the implementation of the latency histogram and its snapshot.
+ * @version 1.0.0
+ **/
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2025 xiaokui.hu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "state_machine_metrics.h"
+
+#include <algorithm>
+
+namespace smf {
+
+std::size_t HistogramSnapshot::BucketIndex(std::uint64_t value) {
+  // 小于 kSubBuckets 的值各占一个桶；其余按最高位分段，取最高位之后的 kSubBucketBits 位作为段内下标
+  if (value < static_cast<std::uint64_t>(kSubBuckets)) {
+    return static_cast<std::size_t>(value);
+  }
+  int msb = 63 - __builtin_clzll(value);
+  int shift = msb - kSubBucketBits;
+  auto sub = static_cast<std::size_t>((value >> shift) & (kSubBuckets - 1));
+  return static_cast<std::size_t>(shift + 1) * kSubBuckets + sub;
+}
+
+std::uint64_t HistogramSnapshot::BucketUpperBound(std::size_t index) {
+  if (index < static_cast<std::size_t>(kSubBuckets)) {
+    return static_cast<std::uint64_t>(index);
+  }
+  std::size_t shift = index / kSubBuckets - 1;
+  auto sub = static_cast<std::uint64_t>(index % kSubBuckets);
+  return ((kSubBuckets + sub + 1) << shift) - 1;
+}
+
+double HistogramSnapshot::Mean() const {
+  return count ? static_cast<double>(sum) / static_cast<double>(count) : 0.0;
+}
+
+std::uint64_t HistogramSnapshot::Percentile(double percentile) const {
+  if (count == 0) {
+    return 0;
+  }
+  auto rank = static_cast<std::uint64_t>(percentile / 100.0 * static_cast<double>(count));
+  rank = std::min<std::uint64_t>(std::max<std::uint64_t>(rank, 1), count);
+  std::uint64_t seen = 0;
+  for (std::size_t i = 0; i < buckets.size(); ++i) {
+    seen += buckets[i];
+    if (seen >= rank) {
+      // 桶上界可能超过实际最大值，以最大值为准
+      return std::min(BucketUpperBound(i), max);
+    }
+  }
+  return max;
+}
+
+void LatencyHistogram::Record(std::int64_t nanos) {
+  auto value = static_cast<std::uint64_t>(std::max<std::int64_t>(nanos, 0));
+  SingleWriterAdd(buckets_[HistogramSnapshot::BucketIndex(value)]);
+  SingleWriterAdd(sum_, value);
+  if (value > max_.load(std::memory_order_relaxed)) {
+    max_.store(value, std::memory_order_relaxed);
+  }
+}
+
+void LatencyHistogram::Snapshot(HistogramSnapshot& snapshot) const {
+  // 样本数取各桶之和，与桶分布保持一致
+  snapshot.count = 0;
+  for (std::size_t i = 0; i < buckets_.size(); ++i) {
+    snapshot.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+    snapshot.count += snapshot.buckets[i];
+  }
+  snapshot.sum = sum_.load(std::memory_order_relaxed);
+  snapshot.max = max_.load(std::memory_order_relaxed);
+}
+
+}  // namespace smf
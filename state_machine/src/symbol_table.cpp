@@ -0,0 +1,110 @@
+/**
+ * @file symbol_table.cpp
+ * @brief Implementation of the symbol table
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @details This file contains the implementation of the SymbolTable class, which maps state,
+ *          event and condition names to dense integer IDs.
+ * @version 1.0.0
+ **/
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2025 xiaokui.hu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "symbol_table.h"
+
+#include "logger.h"
+
+namespace smf {
+
+namespace {
+const std::string kEmptyName;
+}  // namespace
+
+SymbolTable::SymbolTable() {
+  // 内部事件使用固定 ID，所有状态机保持一致
+  events_.Intern(INTERNAL_EVENT);
+  events_.Intern(STATE_TIMEOUT_EVENT);
+}
+
+SymbolId SymbolTable::Namespace::Intern(const std::string& name) {
+  auto it = ids_.find(name);
+  if (it != ids_.end()) {
+    return it->second;
+  }
+  SymbolId id = static_cast<SymbolId>(names_.size());
+  names_.push_back(name);
+  ids_.emplace(name, id);
+  return id;
+}
+
+SymbolId SymbolTable::Namespace::Find(const std::string& name) const {
+  auto it = ids_.find(name);
+  return it == ids_.end() ? INVALID_SYMBOL_ID : it->second;
+}
+
+const std::string& SymbolTable::Namespace::GetName(SymbolId id) const {
+  return id < names_.size() ? names_[id] : kEmptyName;
+}
+
+SymbolId SymbolTable::Intern(Namespace& ns, const std::string& name, const char* kind) {
+  if (frozen_) {
+    SymbolId id = ns.Find(name);
+    if (id == INVALID_SYMBOL_ID) {
+      SMF_LOGE(std::string("Cannot intern ") + kind + " '" + name + "': symbol table is frozen");
+    }
+    return id;
+  }
+  return ns.Intern(name);
+}
+
+StateId SymbolTable::InternState(const std::string& name) {
+  return Intern(states_, name, "state");
+}
+
+EventId SymbolTable::InternEvent(const std::string& name) {
+  return Intern(events_, name, "event");
+}
+
+ConditionId SymbolTable::InternCondition(const std::string& name) {
+  return Intern(conditions_, name, "condition");
+}
+
+StateId SymbolTable::FindState(const std::string& name) const { return states_.Find(name); }
+
+EventId SymbolTable::FindEvent(const std::string& name) const { return events_.Find(name); }
+
+ConditionId SymbolTable::FindCondition(const std::string& name) const {
+  return conditions_.Find(name);
+}
+
+const std::string& SymbolTable::GetStateName(StateId id) const { return states_.GetName(id); }
+
+const std::string& SymbolTable::GetEventName(EventId id) const { return events_.GetName(id); }
+
+const std::string& SymbolTable::GetConditionName(ConditionId id) const {
+  return conditions_.GetName(id);
+}
+
+}  // namespace smf
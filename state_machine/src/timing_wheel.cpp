@@ -0,0 +1,408 @@
+/**
+ * @file timing_wheel.cpp
+ * @brief Implementation of the hierarchical timing wheel
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @details This file contains the implementation of the TimingWheel class.
+ * @version 1.0.0
+ **/
+
+/**
+ * MIT License
+ *
+ * Copyright (c) 2025 xiaokui.hu
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "timing_wheel.h"
+
+#include <algorithm>
+#include <exception>
+#include <limits>
+#include <string>
+
+#include "logger.h"
+
+namespace smf {
+
+namespace {
+
+// 从 from 号槽位开始（含）环形查找第一个被占用的槽位，返回相对 from 的偏移；bits 不能为 0
+std::uint64_t FirstOccupied(std::uint64_t bits, std::uint64_t from) {
+  std::uint64_t rotated = from == 0 ? bits : (bits >> from) | (bits << (64 - from));
+  return static_cast<std::uint64_t>(__builtin_ctzll(rotated));
+}
+
+}  // namespace
+
+TimingWheel::TimingWheel(Clock::duration tick)
+    : tick_(tick > Clock::duration::zero() ? tick : Clock::duration(1)),
+      origin_(Clock::now()) {
+  for (auto& level : slots_) {
+    std::fill(std::begin(level), std::end(level), kNil);
+  }
+}
+
+TimingWheel::~TimingWheel() { Stop(); }
+
+std::uint64_t TimingWheel::CeilTick(Clock::time_point deadline) const {
+  if (deadline <= origin_) {
+    return 0;
+  }
+  auto elapsed = static_cast<std::uint64_t>((deadline - origin_).count());
+  auto tick = static_cast<std::uint64_t>(tick_.count());
+  return elapsed / tick + (elapsed % tick != 0 ? 1 : 0);
+}
+
+std::uint64_t TimingWheel::FloorTick(Clock::time_point now) const {
+  if (now <= origin_) {
+    return 0;
+  }
+  return static_cast<std::uint64_t>((now - origin_).count()) /
+         static_cast<std::uint64_t>(tick_.count());
+}
+
+TimingWheel::Clock::time_point TimingWheel::TickTime(std::uint64_t tick) const {
+  // 超出时钟表示范围的 tick 视为永不到期
+  if (tick >= FloorTick(Clock::time_point::max())) {
+    return Clock::time_point::max();
+  }
+  return origin_ + tick_ * static_cast<Clock::rep>(tick);
+}
+
+std::uint32_t TimingWheel::AllocNode() {
+  if (!free_nodes_.empty()) {
+    std::uint32_t index = free_nodes_.back();
+    free_nodes_.pop_back();
+    return index;
+  }
+  nodes_.emplace_back();
+  return static_cast<std::uint32_t>(nodes_.size() - 1);
+}
+
+void TimingWheel::FreeNode(std::uint32_t index) {
+  Node& node = nodes_[index];
+  node.callback = nullptr;
+  node.state = NodeState::FREE;
+  // 代数递增使旧 ID 失效，跳过 0 以保证 ID 不等于 INVALID_TIMER_ID
+  if (++node.generation == 0) {
+    node.generation = 1;
+  }
+  free_nodes_.push_back(index);
+}
+
+std::uint32_t& TimingWheel::Head(int level, std::uint32_t slot) {
+  return level == kDueLevel ? due_head_ : slots_[level][slot];
+}
+
+void TimingWheel::Link(std::uint32_t index) {
+  Node& node = nodes_[index];
+  int level = kDueLevel;
+  std::uint32_t slot = 0;
+  if (node.expiry_tick > now_tick_) {
+    const std::uint64_t delta = node.expiry_tick - now_tick_;
+    level = kLevels - 1;
+    // 超出范围时放入最高层当前槽位（即最远的一圈），下放时按真实到期 tick 重新放置
+    slot = static_cast<std::uint32_t>((now_tick_ >> (kSlotBits * level)) & kSlotMask);
+    for (int l = 0; l < kLevels; ++l) {
+      if (delta < (std::uint64_t{1} << (kSlotBits * (l + 1)))) {
+        level = l;
+        slot = static_cast<std::uint32_t>((node.expiry_tick >> (kSlotBits * l)) & kSlotMask);
+        break;
+      }
+    }
+  }
+  std::uint32_t& head = Head(level, slot);
+  node.state = NodeState::LINKED;
+  node.level = static_cast<std::int8_t>(level);
+  node.slot = static_cast<std::uint8_t>(slot);
+  node.prev = kNil;
+  node.next = head;
+  if (head != kNil) {
+    nodes_[head].prev = index;
+  }
+  head = index;
+  if (level != kDueLevel) {
+    occupied_[level] |= std::uint64_t{1} << slot;
+  }
+}
+
+void TimingWheel::Unlink(std::uint32_t index) {
+  Node& node = nodes_[index];
+  std::uint32_t& head = Head(node.level, node.slot);
+  if (node.prev != kNil) {
+    nodes_[node.prev].next = node.next;
+  } else {
+    head = node.next;
+  }
+  if (node.next != kNil) {
+    nodes_[node.next].prev = node.prev;
+  }
+  if (head == kNil && node.level != kDueLevel) {
+    occupied_[node.level] &= ~(std::uint64_t{1} << node.slot);
+  }
+  node.prev = kNil;
+  node.next = kNil;
+}
+
+void TimingWheel::Cascade() {
+  for (int level = 1; level < kLevels; ++level) {
+    auto slot = static_cast<std::uint32_t>((now_tick_ >> (kSlotBits * level)) & kSlotMask);
+    std::uint32_t index = slots_[level][slot];
+    slots_[level][slot] = kNil;
+    occupied_[level] &= ~(std::uint64_t{1} << slot);
+    while (index != kNil) {
+      std::uint32_t next = nodes_[index].next;
+      Link(index);
+      index = next;
+    }
+    // 本层未转完一整圈时更高层无需下放
+    if (slot != 0) {
+      break;
+    }
+  }
+}
+
+void TimingWheel::CollectSlot(int level, std::uint32_t slot, std::vector<TimerId>& firing) {
+  std::uint32_t& head = Head(level, slot);
+  for (std::uint32_t index = head; index != kNil; index = nodes_[index].next) {
+    nodes_[index].state = NodeState::FIRING;
+    firing.push_back(MakeId(index, nodes_[index].generation));
+    --size_;
+  }
+  head = kNil;
+  if (level != kDueLevel) {
+    occupied_[level] &= ~(std::uint64_t{1} << slot);
+  }
+}
+
+TimingWheel::TimerId TimingWheel::Schedule(Clock::time_point deadline, Callback callback) {
+  TimerId id = INVALID_TIMER_ID;
+  bool wake = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::uint32_t index = AllocNode();
+    Node& node = nodes_[index];
+    node.callback = std::move(callback);
+    node.expiry_tick = CeilTick(deadline);
+    node.sequence = next_sequence_++;
+    Link(index);
+    ++size_;
+    id = MakeId(index, node.generation);
+    // 只有新定时器早于定时线程当前的等待时间时才需要唤醒
+    wake = running_ && TickTime(node.expiry_tick) < sleep_until_;
+  }
+  if (wake) {
+    wake_cv_.notify_one();
+  }
+  return id;
+}
+
+bool TimingWheel::Cancel(TimerId id) {
+  const std::uint64_t index = (id & 0xFFFFFFFFu) - 1;
+  const auto generation = static_cast<std::uint32_t>(id >> 32);
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (id == INVALID_TIMER_ID || index >= nodes_.size() ||
+      nodes_[index].generation != generation) {
+    return false;
+  }
+  auto i = static_cast<std::uint32_t>(index);
+  switch (nodes_[i].state) {
+    case NodeState::LINKED:
+      Unlink(i);
+      --size_;
+      FreeNode(i);
+      return true;
+    case NodeState::FIRING:
+      // 已被 Advance 收集但尚未执行：释放节点后执行时按代数不匹配跳过
+      FreeNode(i);
+      return true;
+    default:
+      return false;
+  }
+}
+
+void TimingWheel::WaitForCallbacks() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (running_id_ == INVALID_TIMER_ID || running_thread_ == std::this_thread::get_id()) {
+    return;
+  }
+  // 只等待调用时正在执行的那个回调，避免回调连续执行时一直等不到空闲
+  const TimerId current = running_id_;
+  callback_cv_.wait(lock, [this, current] { return running_id_ != current; });
+}
+
+TimingWheel::Clock::time_point TimingWheel::Advance(Clock::time_point now) {
+  std::lock_guard<std::mutex> advance_lock(advance_mutex_);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    firing_.clear();
+    CollectSlot(kDueLevel, 0, firing_);
+    const std::uint64_t target = FloorTick(now);
+    while (now_tick_ < target) {
+      if (size_ == 0) {
+        now_tick_ = target;
+        break;
+      }
+      // 下一个需要处理的 tick：第 0 层下一个非空槽位或下一次下放，取较早者
+      std::uint64_t next = (now_tick_ | kSlotMask) + 1;
+      if (occupied_[0] != 0) {
+        next = std::min(next, now_tick_ + 1 + FirstOccupied(occupied_[0],
+                                                              (now_tick_ + 1) & kSlotMask));
+      }
+      if (next > target) {
+        now_tick_ = target;
+        break;
+      }
+      now_tick_ = next;
+      if ((now_tick_ & kSlotMask) == 0) {
+        // 下放的定时器恰好在本 tick 到期时进入到期链表
+        Cascade();
+        CollectSlot(kDueLevel, 0, firing_);
+      }
+      CollectSlot(0, static_cast<std::uint32_t>(now_tick_ & kSlotMask), firing_);
+    }
+    // 槽位内链表为后进先出，按到期 tick 与登记顺序排序，同一 tick 的回调按登记顺序执行
+    std::sort(firing_.begin(), firing_.end(), [this](TimerId lhs, TimerId rhs) {
+      const Node& a = nodes_[(lhs & 0xFFFFFFFFu) - 1];
+      const Node& b = nodes_[(rhs & 0xFFFFFFFFu) - 1];
+      return a.expiry_tick != b.expiry_tick ? a.expiry_tick < b.expiry_tick
+                                            : a.sequence < b.sequence;
+    });
+  }
+
+  for (TimerId id : firing_) {
+    Callback callback;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto index = static_cast<std::uint32_t>((id & 0xFFFFFFFFu) - 1);
+      Node& node = nodes_[index];
+      if (node.generation != static_cast<std::uint32_t>(id >> 32) ||
+          node.state != NodeState::FIRING) {
+        continue;  // 收集后被撤销
+      }
+      callback = std::move(node.callback);
+      FreeNode(index);
+      running_id_ = id;
+      running_thread_ = std::this_thread::get_id();
+    }
+    try {
+      callback();
+    } catch (const std::exception& e) {
+      SMF_LOGE(std::string("Timer callback threw an exception: ") + e.what());
+    } catch (...) {
+      SMF_LOGE("Timer callback threw an unknown exception");
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      running_id_ = INVALID_TIMER_ID;
+      running_thread_ = std::thread::id();
+    }
+    callback_cv_.notify_all();
+  }
+  firing_.clear();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  return GetNextDeadlineLocked();
+}
+
+TimingWheel::Clock::time_point TimingWheel::GetNextDeadline() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return GetNextDeadlineLocked();
+}
+
+TimingWheel::Clock::time_point TimingWheel::GetNextDeadlineLocked() const {
+  if (due_head_ != kNil) {
+    return TickTime(now_tick_);
+  }
+  // 每层按时间顺序的第一个非空槽位中含有该层最早的定时器；下层的定时器不一定早于上层，
+  // 因此逐层比较
+  std::uint64_t earliest = std::numeric_limits<std::uint64_t>::max();
+  for (int level = 0; level < kLevels; ++level) {
+    if (occupied_[level] == 0) {
+      continue;
+    }
+    const std::uint64_t from = ((now_tick_ >> (kSlotBits * level)) + 1) & kSlotMask;
+    const std::uint64_t slot = (from + FirstOccupied(occupied_[level], from)) & kSlotMask;
+    for (std::uint32_t index = slots_[level][slot]; index != kNil; index = nodes_[index].next) {
+      earliest = std::min(earliest, nodes_[index].expiry_tick);
+    }
+  }
+  return earliest == std::numeric_limits<std::uint64_t>::max() ? Clock::time_point::max()
+                                                               : TickTime(earliest);
+}
+
+size_t TimingWheel::Size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return size_;
+}
+
+void TimingWheel::Start() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (running_ || thread_.joinable()) {
+    return;
+  }
+  running_ = true;
+  thread_ = std::thread(&TimingWheel::ThreadLoop, this);
+}
+
+void TimingWheel::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+  }
+  wake_cv_.notify_all();
+  if (!thread_.joinable()) {
+    return;
+  }
+  if (thread_.get_id() == std::this_thread::get_id()) {
+    // 在到期回调中停止：定时线程在回调返回后自行退出，由析构或下一次 Stop 回收
+    SMF_LOGW("TimingWheel stopped from its own timer thread");
+    return;
+  }
+  thread_.join();
+}
+
+bool TimingWheel::IsRunning() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return running_;
+}
+
+void TimingWheel::ThreadLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (running_) {
+    auto next = GetNextDeadlineLocked();
+    if (Clock::now() < next) {
+      sleep_until_ = next;
+      if (next == Clock::time_point::max()) {
+        wake_cv_.wait(lock);
+      } else {
+        wake_cv_.wait_until(lock, next);
+      }
+      sleep_until_ = Clock::time_point::max();
+      continue;
+    }
+    lock.unlock();
+    Advance(Clock::now());
+    lock.lock();
+  }
+}
+
+}  // namespace smf
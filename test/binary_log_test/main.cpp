@@ -0,0 +1,251 @@
+/**
+ * @file main.cpp
+ * @brief Unit test for the binary log mode of Logger.
+ * @details Verifies that:
+ *          1) BinaryLogRing hands out exactly the bytes written, split into two segments when the
+ *             readable region wraps, drops records when full and truncates oversized messages.
+ *          2) Messages logged in binary mode from several threads through SMF_LOG* and Logger::Log
+ *             reach the log file and decode to text with their level, call site and thread.
+ *          3) SMF_LOG records carry only their encoded arguments and decode with the format
+ *             string of their call site, as text lines and as JSON lines.
+ *          4) Call sites that share a file name and line number but not the full path or the
+ *             format string get their own IDs, so each record decodes with its own format.
+ *          5) Every rotated binary log file starts with a file header and its own call-site
+ *             records, and the decoder rejects data that is not a binary log.
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @version 1.0.0
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "binary_log.h"
+#include "logger.h"
+
+using namespace smf;
+
+namespace {
+
+#define ASSERT_TRUE(cond, msg)                                                                 \
+  do {                                                                                         \
+    if (!(cond)) {                                                                             \
+      std::cerr << "[ASSERT FAILED] " << (msg) << " (" << __FILE__ << ":" << __LINE__ << ")"   \
+                << std::endl;                                                                  \
+      std::exit(1);                                                                            \
+    } else {                                                                                   \
+      std::cout << "[ASSERT OK   ] " << (msg) << std::endl;                                    \
+    }                                                                                          \
+  } while (0)
+
+const std::string kLogFile = "binary_log_test.blog";
+
+BinaryLogRecordHeader MessageHeader(std::uint32_t site_id) {
+  BinaryLogRecordHeader header{};
+  header.type = static_cast<std::uint16_t>(BinaryLogRecordType::MESSAGE);
+  header.site_id = site_id;
+  return header;
+}
+
+// 读出并释放环形缓冲区中的全部字节
+std::string DrainRing(BinaryLogRing& ring, int* segments) {
+  struct iovec iov[2];
+  std::uint64_t end = 0;
+  *segments = ring.Peek(iov, &end);
+  std::string bytes;
+  for (int i = 0; i < *segments; ++i) {
+    bytes.append(static_cast<const char*>(iov[i].iov_base), iov[i].iov_len);
+  }
+  ring.Consume(end);
+  return bytes;
+}
+
+std::string Decode(const std::string& file, bool* ok, bool json = false) {
+  std::ifstream in(file, std::ios::binary);
+  std::ostringstream out;
+  *ok = static_cast<bool>(in) && DecodeBinaryLog(in, out, json);
+  return out.str();
+}
+
+int CountOccurrences(const std::string& text, const std::string& needle) {
+  int count = 0;
+  for (size_t pos = text.find(needle); pos != std::string::npos;
+       pos = text.find(needle, pos + needle.size())) {
+    ++count;
+  }
+  return count;
+}
+
+void TestRing() {
+  BinaryLogRing ring(1024, 7);
+  ASSERT_TRUE(ring.GetCapacity() == 1024 && ring.GetThreadIndex() == 7 && ring.IsEmpty(),
+              "ring: capacity and thread index");
+
+  // 每条记录 24 + 100 字节，写满后再释放，使后续记录跨越缓冲区末尾
+  const std::string payload(100, 'x');
+  int written = 0;
+  while (ring.TryWrite(MessageHeader(1), payload.data(), payload.size())) {
+    ++written;
+  }
+  ASSERT_TRUE(written == 1024 / 124 && ring.GetDropped() == 1, "ring: full ring drops records");
+  int segments = 0;
+  std::string bytes = DrainRing(ring, &segments);
+  ASSERT_TRUE(segments == 1 && bytes.size() == static_cast<size_t>(written) * 124 && ring.IsEmpty(),
+              "ring: contiguous region read in one segment");
+
+  const std::string wrapped(300, 'y');
+  ASSERT_TRUE(ring.TryWrite(MessageHeader(2), wrapped.data(), wrapped.size()),
+              "ring: record written across the end");
+  bytes = DrainRing(ring, &segments);
+  BinaryLogRecordHeader header;
+  std::memcpy(&header, bytes.data(), sizeof(header));
+  ASSERT_TRUE(segments == 2 && header.size == 324 && header.site_id == 2 &&
+                  bytes.substr(sizeof(header)) == wrapped,
+              "ring: wrapped record read back in two segments");
+
+  const std::string oversized(4096, 'z');
+  ASSERT_TRUE(ring.TryWrite(MessageHeader(3), oversized.data(), oversized.size()),
+              "ring: oversized message accepted");
+  bytes = DrainRing(ring, &segments);
+  ASSERT_TRUE(bytes.size() == 512, "ring: oversized message truncated to half the ring");
+}
+
+void TestBinaryLogging() {
+  std::remove(kLogFile.c_str());
+  Logger& logger = Logger::GetInstance();
+  logger.SetBinaryRingSize(1024 * 1024);
+  logger.SetLogFileRolling(0, 0);
+  SMF_LOGGER_SET_FILE(kLogFile);
+  SMF_LOGGER_SET_MODE(LogMode::BINARY);
+  SMF_LOGGER_INIT(LogLevel::INFO);
+
+  constexpr int kThreads = 4;
+  constexpr int kMessages = 1000;
+  SMF_LOGD("filtered debug message");
+  SMF_LOGI("main thread message");
+  logger.Log(LogLevel::ERROR, "some/dir/direct.cpp", 42, "direct message");
+  const std::string state = "IDLE";
+  SMF_LOG(LogLevel::INFO, "structured {} -> {} after {}ms ({})", state, "RUNNING", 150u, true);
+  SMF_LOG(LogLevel::DEBUG, "filtered structured {}", state);
+
+  // 同名文件的同一行：先注册不带格式串的调用点，再注册带格式串的调用点
+  const LogCallSite plain_site{"same.cpp", 10, logger.RegisterCallSite("lib/same.cpp", 10)};
+  const LogCallSite args_site{"same.cpp", 10,
+                              logger.RegisterCallSite("app/same.cpp", 10, "value {}"),
+                              "value {}"};
+  const LogCallSite other_site{"same.cpp", 10,
+                               logger.RegisterCallSite("app/same.cpp", 10, "other {} {}"),
+                               "other {} {}"};
+  ASSERT_TRUE(plain_site.id != args_site.id && args_site.id != other_site.id &&
+                  plain_site.id != other_site.id &&
+                  logger.RegisterCallSite("app/same.cpp", 10, "value {}") == args_site.id,
+              "call sites: same file name and line keep distinct IDs per path and format");
+  logger.Log(LogLevel::INFO, plain_site, "plain collision message");
+  logger.LogFormat(LogLevel::INFO, args_site, "value {}", 42);
+  logger.LogFormat(LogLevel::INFO, other_site, "other {} {}", "x", 2.5);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([t] {
+      for (int i = 0; i < kMessages; ++i) {
+        SMF_LOGW("worker " + std::to_string(t) + " message " + std::to_string(i));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  logger.Flush();
+  ASSERT_TRUE(logger.GetDroppedRecords() == 0, "logging: no record dropped");
+
+  bool ok = false;
+  std::string text = Decode(kLogFile, &ok);
+  ASSERT_TRUE(ok, "logging: log file decodes");
+  ASSERT_TRUE(CountOccurrences(text, "[WARN] ") == kThreads * kMessages,
+              "logging: every worker message decoded");
+  for (int t = 0; t < kThreads; ++t) {
+    ASSERT_TRUE(text.find("] worker " + std::to_string(t) + " message " +
+                          std::to_string(kMessages - 1) + "\n") != std::string::npos,
+                "logging: last message of worker " + std::to_string(t));
+  }
+  ASSERT_TRUE(text.find("[INFO]  [main.cpp:") != std::string::npos &&
+                  text.find("- T0] main thread message\n") != std::string::npos,
+              "logging: level, call site and thread index of SMF_LOGI");
+  ASSERT_TRUE(text.find("[ERROR] [direct.cpp:42 - T0] direct message\n") != std::string::npos,
+              "logging: Logger::Log without a macro call site");
+  ASSERT_TRUE(text.find("filtered debug message") == std::string::npos &&
+                  text.find("filtered structured") == std::string::npos,
+              "logging: filtered level not written");
+  ASSERT_TRUE(text.find("- T0] structured IDLE -> RUNNING after 150ms (true)\n") !=
+                  std::string::npos,
+              "logging: SMF_LOG record formatted with its call-site format string");
+
+  ASSERT_TRUE(text.find("[same.cpp:10 - T0] plain collision message\n") != std::string::npos &&
+                  text.find("[same.cpp:10 - T0] value 42\n") != std::string::npos &&
+                  text.find("[same.cpp:10 - T0] other x 2.5\n") != std::string::npos,
+              "call sites: colliding sites decode with their own format strings");
+
+  std::string json = Decode(kLogFile, &ok, true);
+  ASSERT_TRUE(ok && CountOccurrences(json, "{\"time\":") == kThreads * kMessages + 6,
+              "json: one JSON line per record");
+  const std::string structured =
+      R"json("thread":"T0","message":"structured IDLE -> RUNNING after 150ms (true)",)json"
+      R"json("format":"structured {} -> {} after {}ms ({})",)json"
+      R"json("args":["IDLE","RUNNING",150,true]})json";
+  ASSERT_TRUE(json.find(structured) != std::string::npos,
+              "json: SMF_LOG record with format and typed args");
+}
+
+void TestRotation() {
+  Logger& logger = Logger::GetInstance();
+  for (int i = 1; i <= 2; ++i) {
+    std::remove((kLogFile + "." + std::to_string(i)).c_str());
+  }
+  logger.SetLogFileRolling(4096, 2);
+  for (int round = 0; round < 20; ++round) {
+    for (int i = 0; i < 20; ++i) {
+      SMF_LOGI("rotation round " + std::to_string(round) + " message " + std::to_string(i));
+    }
+    logger.Flush();
+  }
+
+  bool ok = false;
+  std::string current = Decode(kLogFile, &ok);
+  ASSERT_TRUE(ok && current.find("rotation round 19 message 19\n") != std::string::npos,
+              "rotation: current file holds the latest messages");
+  for (int i = 1; i <= 2; ++i) {
+    std::string backup = Decode(kLogFile + "." + std::to_string(i), &ok);
+    ASSERT_TRUE(ok && backup.find("[INFO]  [main.cpp:") != std::string::npos,
+                "rotation: backup " + std::to_string(i) + " decodes with its own call sites");
+  }
+  std::ifstream in(kLogFile + ".3");
+  ASSERT_TRUE(!in, "rotation: at most two backups kept");
+
+  std::istringstream garbage("this is not a binary log file");
+  std::ostringstream out;
+  ASSERT_TRUE(!DecodeBinaryLog(garbage, out), "decoder: rejects text input");
+}
+
+}  // namespace
+
+int main() {
+  std::cout << "=== Binary Log Unit Test ===" << std::endl;
+
+  TestRing();
+  TestBinaryLogging();
+  TestRotation();
+
+  SMF_LOGGER_SET_MODE(LogMode::TEXT);
+  SMF_LOGGER_SET_FILE("");
+  for (int i = 0; i <= 2; ++i) {
+    std::remove((i == 0 ? kLogFile : kLogFile + "." + std::to_string(i)).c_str());
+  }
+  std::cout << "=== All binary log tests passed ===" << std::endl;
+  return 0;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file main.cpp
+ * @brief Unit test for the compiled (dense table) transition lookup mode.
+ * @details Runs the same configuration and the same event sequence on two state machines,
+ *          one with the default hash-map lookup and one created with
+ *          StateMachineOptions::compiled_transitions, and verifies that:
+ *          1) Both machines walk through exactly the expected sequence of states.
+ *          2) Multiple rules registered for the same (state, event) key are all visible in
+ *             compiled mode, so the condition-guarded alternatives still select correctly.
+ *          3) Unknown events and condition-driven (internal event) transitions behave the
+ *             same in both modes.
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @version 1.0.0
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logger.h"
+#include "state_machine.h"
+#include "state_machine_factory.h"
+
+using namespace smf;
+
+namespace {
+
+struct Recorder {
+  std::mutex mutex;
+  std::vector<State> entered;  // 每次进入的最内层状态
+
+  void OnEnter(const std::vector<State>& states) {
+    if (states.empty()) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    entered.push_back(states.back());
+  }
+
+  std::vector<State> Snapshot() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entered;
+  }
+};
+
+#define ASSERT_TRUE(cond, msg)                                                                 \
+  do {                                                                                         \
+    if (!(cond)) {                                                                             \
+      std::cerr << "[ASSERT FAILED] " << (msg) << " (" << __FILE__ << ":" << __LINE__ << ")"   \
+                << std::endl;                                                                  \
+      std::exit(1);                                                                            \
+    } else {                                                                                   \
+      SMF_LOGI(std::string("[ASSERT OK   ] ") + (msg));                                        \
+    }                                                                                          \
+  } while (0)
+
+std::string Join(const std::vector<State>& states) {
+  std::string s;
+  for (const auto& state : states) {
+    s += state + " ";
+  }
+  return s;
+}
+
+void Settle() { std::this_thread::sleep_for(std::chrono::milliseconds(100)); }
+
+// 按固定顺序驱动状态机，返回进入状态序列
+std::vector<State> Drive(const std::string& name, const StateMachineOptions& options) {
+  auto sm = StateMachineFactory::CreateStateMachine(name, options);
+  ASSERT_TRUE(sm != nullptr, name + ": state machine created");
+
+  Recorder recorder;
+  sm->SetEnterStateCallback(
+      [&recorder](const std::vector<State>& states) { recorder.OnEnter(states); });
+  ASSERT_TRUE(sm->Init("../../test/compiled_transition_test/config"), name + ": init");
+  ASSERT_TRUE(sm->Start(), name + ": start");
+  Settle();
+
+  sm->HandleEvent(std::make_shared<Event>("start"));
+  Settle();
+  ASSERT_TRUE(sm->GetCurrentState() == "running", name + ": start -> running");
+
+  // turbo 为 0：同一 (running, boost) 键下的两条规则中只有 paused 满足
+  sm->HandleEvent(std::make_shared<Event>("boost"));
+  Settle();
+  ASSERT_TRUE(sm->GetCurrentState() == "paused", name + ": boost without turbo -> paused");
+
+  sm->HandleEvent(std::make_shared<Event>("resume"));
+  Settle();
+  ASSERT_TRUE(sm->GetCurrentState() == "running", name + ": resume -> running");
+
+  sm->SetConditionValue("turbo", 1);
+  Settle();
+  sm->HandleEvent(std::make_shared<Event>("boost"));
+  Settle();
+  ASSERT_TRUE(sm->GetCurrentState() == "boosted", name + ": boost with turbo -> boosted");
+
+  // 未定义的事件不触发转移
+  sm->HandleEvent(std::make_shared<Event>("bogus"));
+  Settle();
+  ASSERT_TRUE(sm->GetCurrentState() == "boosted", name + ": unknown event ignored");
+
+  // 无事件的条件转移经由内部事件查找
+  sm->SetConditionValue("overheat", 1);
+  Settle();
+  ASSERT_TRUE(sm->GetCurrentState() == "idle", name + ": overheat -> idle");
+
+  sm->Stop();
+  return recorder.Snapshot();
+}
+
+}  // namespace
+
+int main() {
+  SMF_LOGI("=== Compiled Transition Table Unit Test ===");
+
+  std::vector<State> dynamic = Drive("DynamicLookup", StateMachineOptions());
+
+  StateMachineOptions compiled_options;
+  compiled_options.compiled_transitions = true;
+  std::vector<State> compiled = Drive("CompiledLookup", compiled_options);
+
+  const std::vector<State> expected = {"running", "paused", "running", "boosted", "idle"};
+  SMF_LOGI("dynamic : " + Join(dynamic));
+  SMF_LOGI("compiled: " + Join(compiled));
+  ASSERT_TRUE(dynamic == expected, "dynamic lookup entered the expected states");
+  ASSERT_TRUE(compiled == expected, "compiled lookup entered the expected states");
+
+  SMF_LOGI("=== All compiled transition tests passed ===");
+  return 0;
+}
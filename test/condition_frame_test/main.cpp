@@ -0,0 +1,173 @@
+/**
+ * @file main.cpp
+ * @brief Unit test for bulk condition updates (SetConditionValues).
+ * @details Verifies that:
+ *          1) A frame of updates is applied before any event definition is re-evaluated, so a
+ *             definition that only holds for an intermediate combination never fires, while
+ *             the same values set one by one do fire it.
+ *          2) A frame produces a single INTERNAL_EVENT that carries every updated condition,
+ *             and unknown condition names in the frame are ignored. The event is elided while
+ *             no transition listens for condition changes.
+ *          3) A pending transition waiting on one condition of a frame resumes.
+ *          4) The same holds when conditions are processed on the condition thread.
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @version 1.0.0
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logger.h"
+#include "state_machine.h"
+#include "state_machine_factory.h"
+
+using namespace smf;
+
+namespace {
+
+#define ASSERT_TRUE(cond, msg)                                                                 \
+  do {                                                                                         \
+    if (!(cond)) {                                                                             \
+      std::cerr << "[ASSERT FAILED] " << (msg) << " (" << __FILE__ << ":" << __LINE__ << ")"   \
+                << std::endl;                                                                  \
+      std::exit(1);                                                                            \
+    } else {                                                                                   \
+      SMF_LOGI(std::string("[ASSERT OK   ] ") + (msg));                                        \
+    }                                                                                          \
+  } while (0)
+
+using Clock = std::chrono::steady_clock;
+using std::chrono::milliseconds;
+
+const char* const kConfig = "../../test/condition_frame_test/config";
+
+// 记录处理过的事件；帧内条件（speed）引起的内部事件单独计数，并记录其携带的条件数
+struct Recorder {
+  std::mutex mutex;
+  std::map<std::string, int> fired;
+  int speed_internal_events{0};
+  size_t last_internal_conditions{0};
+
+  void Attach(FiniteStateMachine& sm) {
+    sm.SetPreEventCallback([this](const State&, const EventPtr& event) {
+      std::lock_guard<std::mutex> lock(mutex);
+      ++fired[event->GetName()];
+      if (event->GetName() == INTERNAL_EVENT) {
+        for (const auto& info : event->GetMatchedConditions()) {
+          if (info.name == "speed") {
+            ++speed_internal_events;
+            last_internal_conditions = event->GetMatchedConditions().size();
+          }
+        }
+      }
+      return true;
+    });
+  }
+
+  int Fired(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return fired[name];
+  }
+
+  int SpeedInternalEvents() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return speed_internal_events;
+  }
+};
+
+template <typename Pred>
+bool WaitFor(Pred pred, milliseconds timeout = milliseconds(3000)) {
+  auto deadline = Clock::now() + timeout;
+  while (!pred()) {
+    if (Clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(milliseconds(5));
+  }
+  return true;
+}
+
+void TestInlineFrame() {
+  StateMachineOptions options;
+  options.execution = ExecutionMode::INLINE;
+  auto sm = StateMachineFactory::CreateStateMachine("FrameInline", options);
+  Recorder recorder;
+  recorder.Attach(*sm);
+  ASSERT_TRUE(sm->Init(kConfig) && sm->Start(), "inline: start");
+
+  sm->SetConditionValues({{"speed", 15}, {"gear", 3}, {"door", 0}, {"no_such_condition", 1}});
+  ASSERT_TRUE(sm->GetCurrentState() == "ready" && recorder.Fired("ready_event") == 1,
+              "inline: frame satisfies the event definition once");
+  ASSERT_TRUE(recorder.Fired("glitch") == 0,
+              "inline: intermediate values of the frame are never evaluated");
+  // idle 与 ready 都没有条件转移，也没有挂起转移：整帧的一个内部事件与 ready_event 标志条件的
+  // 内部事件都被省略
+  InternalEventStats stats = sm->GetInternalEventStats();
+  ASSERT_TRUE(recorder.SpeedInternalEvents() == 0 && stats.skipped == 2 && stats.posted == 0,
+              "inline: the frame's single internal event is elided without listeners");
+
+  // 挂起转移等待帧内的 load 条件
+  sm->HandleEvent(std::make_shared<Event>("finish"));
+  ASSERT_TRUE(sm->GetCurrentState() == "ready", "inline: finish waits for load");
+  sm->SetConditionValues({{"speed", 16}, {"load", 7}, {"no_such_condition", 1}});
+  ASSERT_TRUE(sm->GetCurrentState() == "done" && recorder.SpeedInternalEvents() == 1 &&
+                  recorder.last_internal_conditions == 2,
+              "inline: pending transition resumes on one internal event carrying the frame");
+  sm->Stop();
+}
+
+void TestInlineSingleUpdates() {
+  StateMachineOptions options;
+  options.execution = ExecutionMode::INLINE;
+  auto sm = StateMachineFactory::CreateStateMachine("SingleInline", options);
+  Recorder recorder;
+  recorder.Attach(*sm);
+  ASSERT_TRUE(sm->Init(kConfig) && sm->Start(), "single: start");
+
+  // 逐个更新时每次更新都会重新检查，speed 先到时 glitch 会被短暂满足
+  sm->SetConditionValue("speed", 15);
+  sm->SetConditionValue("gear", 3);
+  sm->SetConditionValue("door", 0);
+  ASSERT_TRUE(sm->GetCurrentState() == "ready" && recorder.Fired("glitch") == 1,
+              "single: one-by-one updates expose the intermediate combination");
+  InternalEventStats stats = sm->GetInternalEventStats();
+  ASSERT_TRUE(stats.posted + stats.skipped > 3,
+              "single: every update produces its own internal event");
+  sm->Stop();
+}
+
+void TestThreadedFrame() {
+  auto sm = StateMachineFactory::CreateStateMachine("FrameThreaded");
+  Recorder recorder;
+  recorder.Attach(*sm);
+  ASSERT_TRUE(sm->Init(kConfig) && sm->Start(), "threaded: start");
+
+  sm->SetConditionValues({{"speed", 12}, {"gear", 3}, {"door", 0}});
+  ASSERT_TRUE(WaitFor([&] { return sm->GetCurrentState() == "ready"; }),
+              "threaded: frame reaches ready");
+  // 内部事件在 ready_event 之后入队（或在没有待处理事件时被省略），等它处理完再检查计数
+  std::this_thread::sleep_for(milliseconds(50));
+  ASSERT_TRUE(recorder.Fired("glitch") == 0 && recorder.SpeedInternalEvents() <= 1,
+              "threaded: no intermediate evaluation and at most one internal event");
+  sm->Stop();
+}
+
+}  // namespace
+
+int main() {
+  SMF_LOGI("=== Condition Frame Unit Test ===");
+
+  TestInlineFrame();
+  TestInlineSingleUpdates();
+  TestThreadedFrame();
+
+  SMF_LOGI("=== All condition frame tests passed ===");
+  return 0;
+}
@@ -0,0 +1,202 @@
+/**
+ * @file main.cpp
+ * @brief Unit test for compiled condition expressions.
+ * @details Verifies that:
+ *          1) CompileConditionExpr resolves operators to enums and sorts and merges each
+ *             condition's ranges, including overlapping, adjacent and inverted ranges.
+ *          2) Compiling fails for an undefined condition or an unknown operator.
+ *          3) For random expressions and values, the compiled program and the interpreter agree
+ *             on the result and on the matched condition infos, with and without durations.
+ *          4) A state machine loaded from test/condition_expr_test compiles its expressions.
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @version 1.0.0
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "components/condition_manager.h"
+#include "logger.h"
+#include "state_machine.h"
+#include "state_machine_factory.h"
+#include "symbol_table.h"
+#include "timing_wheel.h"
+
+using namespace smf;
+
+namespace {
+
+#define ASSERT_TRUE(cond, msg)                                                                 \
+  do {                                                                                         \
+    if (!(cond)) {                                                                             \
+      std::cerr << "[ASSERT FAILED] " << (msg) << " (" << __FILE__ << ":" << __LINE__ << ")"   \
+                << std::endl;                                                                  \
+      std::exit(1);                                                                            \
+    } else {                                                                                   \
+      SMF_LOGI(std::string("[ASSERT OK   ] ") + (msg));                                        \
+    }                                                                                          \
+  } while (0)
+
+constexpr int kConditionCount = 16;
+constexpr int kExprCount = 200;
+constexpr int kRounds = 200;
+
+ConditionSharedPtr MakeCondition(SymbolTable& symbols, const std::string& name,
+                                 std::vector<std::pair<int, int>> ranges, int duration = 0) {
+  auto cond = std::make_shared<Condition>();
+  cond->name = name;
+  cond->range_values = std::move(ranges);
+  cond->duration = duration;
+  cond->id = symbols.InternCondition(name);
+  return cond;
+}
+
+ConditionRef Ref(const SymbolTable& symbols, const std::string& name, bool negated = false) {
+  return {name, negated, symbols.FindCondition(name)};
+}
+
+bool SameInfos(const std::vector<ConditionInfo>& a, const std::vector<ConditionInfo>& b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); ++i) {
+    // 持续时间按各自读取的时钟计算，只比较名称与值
+    if (a[i].name != b[i].name || a[i].value != b[i].value) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void TestCompile() {
+  SymbolTable symbols;
+  TimingWheel timers;
+  ConditionManager manager(&symbols, &timers, /*inline_execution=*/true);
+  manager.AddCondition(MakeCondition(symbols, "a", {{30, 40}, {1, 5}, {6, 8}, {3, 4}, {9, 2}}));
+  // 同一条件的后续定义不影响表达式（与解释执行一致，使用第一个定义）
+  manager.AddCondition(MakeCondition(symbols, "a", {{100, 200}}));
+  manager.AddCondition(MakeCondition(symbols, "b", {{0, 0}}, 20));
+  symbols.InternCondition("undefined");
+
+  ConditionExpr expr;
+  expr.conditions = {Ref(symbols, "a"), Ref(symbols, "b", true)};
+  expr.operators = {"OR"};
+  ASSERT_TRUE(manager.CompileConditionExpr(expr), "compile: expression compiled");
+  const auto& program = expr.program;
+  ASSERT_TRUE(program.terms.size() == 2 && program.terms[1].op == LogicOp::OR &&
+                  program.terms[1].negated,
+              "compile: operator and negation resolved");
+  const std::vector<int> mins = {1, 30, 0};
+  const std::vector<int> maxs = {8, 40, 0};
+  ASSERT_TRUE(program.range_mins == mins && program.range_maxs == maxs,
+              "compile: ranges sorted, merged, inverted dropped");
+  ASSERT_TRUE(program.terms[0].range_end - program.terms[0].range_begin == 2 &&
+                  program.terms[1].duration == 20 && program.needs_clock,
+              "compile: per-term ranges and duration");
+  ASSERT_TRUE(program.InRange(program.terms[0], 7) && !program.InRange(program.terms[0], 9) &&
+                  !program.InRange(program.terms[0], 100),
+              "compile: range membership");
+
+  ConditionExpr undefined;
+  undefined.conditions = {Ref(symbols, "a"), Ref(symbols, "undefined")};
+  undefined.operators = {"AND"};
+  ASSERT_TRUE(!manager.CompileConditionExpr(undefined) && undefined.program.Empty(),
+              "compile: undefined condition rejected");
+  ConditionExpr bad_op;
+  bad_op.conditions = {Ref(symbols, "a"), Ref(symbols, "b")};
+  bad_op.operators = {"XOR"};
+  ASSERT_TRUE(!manager.CompileConditionExpr(bad_op) && bad_op.program.Empty(),
+              "compile: unknown operator rejected");
+}
+
+void TestMatchesInterpreter() {
+  SymbolTable symbols;
+  TimingWheel timers;
+  ConditionManager manager(&symbols, &timers, /*inline_execution=*/true);
+  std::mt19937 rng(20261016);
+  std::vector<std::string> names;
+  for (int i = 0; i < kConditionCount; ++i) {
+    std::vector<std::pair<int, int>> ranges;
+    for (int r = 0, n = 1 + static_cast<int>(rng() % 6); r < n; ++r) {
+      int low = static_cast<int>(rng() % 100);
+      int high = low + static_cast<int>(rng() % 15) - 2;  // 偶尔出现 low > high 的无效范围
+      ranges.emplace_back(low, high);
+    }
+    names.push_back("c" + std::to_string(i));
+    manager.AddCondition(MakeCondition(symbols, names.back(), ranges, i % 4 == 0 ? 30 : 0));
+  }
+
+  std::vector<ConditionExprSharedPtr> interpreted;
+  std::vector<ConditionExprSharedPtr> compiled;
+  bool all_compiled = true;
+  for (int e = 0; e < kExprCount; ++e) {
+    auto expr = std::make_shared<ConditionExpr>();
+    for (int t = 0, n = 1 + static_cast<int>(rng() % 5); t < n; ++t) {
+      expr->conditions.push_back(Ref(symbols, names[rng() % names.size()], rng() % 3 == 0));
+      if (t > 0) {
+        expr->operators.push_back(rng() % 2 == 0 ? "AND" : "OR");
+      }
+    }
+    interpreted.push_back(std::make_shared<ConditionExpr>(*expr));
+    all_compiled = all_compiled && manager.CompileConditionExpr(*expr);
+    compiled.push_back(expr);
+  }
+  ASSERT_TRUE(all_compiled, "random: every expression compiled");
+  manager.Start();
+
+  int mismatches = 0;
+  int satisfied = 0;
+  std::vector<ConditionInfo> expected;
+  std::vector<ConditionInfo> actual;
+  for (int round = 0; round < kRounds; ++round) {
+    for (const auto& name : names) {
+      manager.SetConditionValue(name, static_cast<int>(rng() % 110));
+    }
+    // 最后几轮等待持续时间条件满足
+    if (round >= kRounds - 3) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    for (size_t e = 0; e < compiled.size(); ++e) {
+      bool want = manager.CheckConditionExprs({interpreted[e]}, expected);
+      bool got = manager.CheckConditionExprs({compiled[e]}, actual);
+      satisfied += want ? 1 : 0;
+      if (want != got || !SameInfos(expected, actual)) {
+        ++mismatches;
+      }
+    }
+  }
+  manager.Stop();
+  ASSERT_TRUE(satisfied > 0 && satisfied < kRounds * kExprCount,
+              "random: expressions are both satisfied and unsatisfied");
+  ASSERT_TRUE(mismatches == 0, "random: compiled program matches the interpreter (" +
+                                   std::to_string(mismatches) + " mismatches)");
+}
+
+void TestStateMachine() {
+  StateMachineOptions options;
+  options.execution = ExecutionMode::INLINE;
+  auto sm = StateMachineFactory::CreateStateMachine("CompiledExprs", options);
+  ASSERT_TRUE(sm->Init("../../test/condition_expr_test/config") && sm->Start(),
+              "fsm: condition_expr_test config loads with compiled expressions");
+  sm->Stop();
+}
+
+}  // namespace
+
+int main() {
+  SMF_LOGI("=== Condition Program Unit Test ===");
+
+  TestCompile();
+  TestMatchesInterpreter();
+  TestStateMachine();
+
+  SMF_LOGI("=== All condition program tests passed ===");
+  return 0;
+}
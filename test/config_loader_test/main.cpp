@@ -0,0 +1,156 @@
+/**
+ * @file main.cpp
+ * @brief Unit test for the parallel loading of event and transition config files.
+ * @details Generates a configuration with hundreds of transition files and a few dozen event
+ *          files, loads it with StateMachineOptions::config_load_threads set to 1 and to 4, and
+ *          verifies that:
+ *          1) Every transition and event definition is registered in both modes, so the same
+ *             event sequence walks the whole chain and condition-generated events still fire.
+ *          2) Guarded alternatives on the same (state, event) key keep working, i.e. all rules
+ *             of a key are registered after the files are parsed on worker threads.
+ *          3) A malformed JSON file, an invalid transition file or an invalid event file makes
+ *             Init() fail in both modes, as with serial loading.
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @version 1.0.0
+ */
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "logger.h"
+#include "state_machine.h"
+#include "state_machine_factory.h"
+
+using namespace smf;
+
+namespace {
+
+#define ASSERT_TRUE(cond, msg)                                                                 \
+  do {                                                                                         \
+    if (!(cond)) {                                                                             \
+      std::cerr << "[ASSERT FAILED] " << (msg) << " (" << __FILE__ << ":" << __LINE__ << ")"   \
+                << std::endl;                                                                  \
+      std::exit(1);                                                                            \
+    } else {                                                                                   \
+      std::cout << "[ASSERT OK   ] " << (msg) << std::endl;                                    \
+    }                                                                                          \
+  } while (0)
+
+namespace fs = std::filesystem;
+
+constexpr int kChainStates = 200;
+constexpr int kEventDefinitions = 32;
+
+void WriteFile(const fs::path& path, const std::string& content) {
+  std::ofstream out(path);
+  out << content;
+}
+
+std::string StateName(int index) { return "s" + std::to_string(index); }
+
+// 状态链 s0 -> s1 -> ... 由事件 next 推进，每个状态另有一条条件不满足的守卫规则指向 trap；
+// 链尾由条件 c_7 生成的事件 ev_7 转移到 done
+fs::path WriteChainConfig(const std::string& name) {
+  fs::path dir = fs::temp_directory_path() / name;
+  fs::remove_all(dir);
+  fs::create_directories(dir / "trans_config");
+  fs::create_directories(dir / "event_generate_config");
+
+  std::string states = "{\n  \"states\": [\n";
+  for (int i = 0; i <= kChainStates; ++i) {
+    states += "    { \"name\": \"" + StateName(i) + "\" },\n";
+  }
+  states += "    { \"name\": \"trap\" },\n    { \"name\": \"done\" }\n  ],\n";
+  states += "  \"initial_state\": \"s0\"\n}\n";
+  WriteFile(dir / "state_config.json", states);
+
+  for (int i = 0; i < kChainStates; ++i) {
+    WriteFile(dir / "trans_config" / ("next_" + std::to_string(i) + ".json"),
+              "{ \"from\": \"" + StateName(i) + "\", \"to\": \"" + StateName(i + 1) +
+                  "\", \"event\": \"next\" }\n");
+    WriteFile(dir / "trans_config" / ("guard_" + std::to_string(i) + ".json"),
+              "{ \"from\": \"" + StateName(i) +
+                  "\", \"to\": \"trap\", \"event\": \"next\", "
+                  "\"conditions\": [{ \"name\": \"armed\", \"range\": [1, 1] }] }\n");
+  }
+  WriteFile(dir / "trans_config" / "finish.json",
+            "{ \"from\": \"" + StateName(kChainStates) +
+                "\", \"to\": \"done\", \"event\": \"ev_7\" }\n");
+
+  for (int j = 0; j < kEventDefinitions; ++j) {
+    const std::string index = std::to_string(j);
+    WriteFile(dir / "event_generate_config" / ("ev_" + index + ".json"),
+              "{ \"name\": \"ev_" + index + "\", \"trigger_mode\": \"edge\", "
+              "\"conditions\": [{ \"name\": \"c_" + index + "\", \"range\": [1, 1] }] }\n");
+  }
+  return dir;
+}
+
+std::shared_ptr<FiniteStateMachine> CreateMachine(const std::string& name, size_t threads) {
+  StateMachineOptions options;
+  options.execution = ExecutionMode::INLINE;
+  options.config_load_threads = threads;
+  return StateMachineFactory::CreateStateMachine(name, options);
+}
+
+void TestChain(const fs::path& dir, size_t threads) {
+  const std::string label = std::to_string(threads) + " load threads";
+  auto sm = CreateMachine("ConfigLoaderChain" + std::to_string(threads), threads);
+  ASSERT_TRUE(sm != nullptr, label + ": state machine created");
+  ASSERT_TRUE(sm->Init(dir.string()), label + ": init");
+  ASSERT_TRUE(sm->Start(), label + ": start");
+
+  for (int i = 0; i < kChainStates; ++i) {
+    sm->HandleEvent(std::make_shared<Event>("next"));
+  }
+  ASSERT_TRUE(sm->GetCurrentState() == StateName(kChainStates),
+              label + ": every chain transition registered, no guard rule taken");
+
+  // 事件定义由条件生成事件，验证事件配置同样全部注册
+  sm->SetConditionValue("c_7", 1);
+  ASSERT_TRUE(sm->GetCurrentState() == "done", label + ": event definition from config fires");
+  sm->Stop();
+}
+
+void TestInvalidFiles(const fs::path& dir, size_t threads) {
+  const std::string label = std::to_string(threads) + " load threads";
+  const fs::path trans = dir / "trans_config";
+  const fs::path events = dir / "event_generate_config";
+
+  WriteFile(trans / "zz_malformed.json", "{ \"from\": \"s0\", ");
+  auto sm = CreateMachine("ConfigLoaderMalformed" + std::to_string(threads), threads);
+  ASSERT_TRUE(!sm->Init(dir.string()), label + ": malformed transition file fails init");
+  fs::remove(trans / "zz_malformed.json");
+
+  WriteFile(trans / "zz_invalid.json", "{ \"from\": \"s0\", \"event\": \"next\" }\n");
+  sm = CreateMachine("ConfigLoaderInvalid" + std::to_string(threads), threads);
+  ASSERT_TRUE(!sm->Init(dir.string()), label + ": transition file without 'to' fails init");
+  fs::remove(trans / "zz_invalid.json");
+
+  WriteFile(events / "zz_invalid.json", "{ \"name\": \"bad\", \"trigger_mode\": \"pulse\" }\n");
+  sm = CreateMachine("ConfigLoaderInvalidEvent" + std::to_string(threads), threads);
+  ASSERT_TRUE(!sm->Init(dir.string()), label + ": invalid event file fails init");
+  fs::remove(events / "zz_invalid.json");
+}
+
+}  // namespace
+
+int main() {
+  std::cout << "=== Config Loader Unit Test ===" << std::endl;
+  SMF_LOGGER_INIT(LogLevel::ERROR);
+
+  const fs::path dir = WriteChainConfig("smf_config_loader_test");
+  for (size_t threads : {1, 4}) {
+    TestChain(dir, threads);
+    TestInvalidFiles(dir, threads);
+  }
+  fs::remove_all(dir);
+
+  std::cout << "=== All config loader tests passed ===" << std::endl;
+  return 0;
+}
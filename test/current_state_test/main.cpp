@@ -0,0 +1,156 @@
+/**
+ * @file main.cpp
+ * @brief Unit test for the lock-free current state read path.
+ * @details Verifies that:
+ *          1) GetCurrentState returns the interned state name, so repeated reads of the same
+ *             state hand out the same string object.
+ *          2) The state generation advances by exactly one per state change.
+ *          3) Monitoring threads polling GetCurrentState and GetStateGeneration while the
+ *             machine keeps switching states always observe a valid state and a non-decreasing
+ *             generation, and never allocate (counted by a replacement operator new).
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @version 1.0.0
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logger.h"
+#include "state_machine.h"
+#include "state_machine_factory.h"
+
+namespace {
+
+thread_local std::uint64_t t_allocations = 0;
+
+void* CountedAlloc(std::size_t size) {
+  ++t_allocations;
+  void* ptr = std::malloc(size == 0 ? 1 : size);
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+}  // namespace
+
+void* operator new(std::size_t size) { return CountedAlloc(size); }
+void* operator new[](std::size_t size) { return CountedAlloc(size); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+using namespace smf;
+
+namespace {
+
+#define ASSERT_TRUE(cond, msg)                                                                 \
+  do {                                                                                         \
+    if (!(cond)) {                                                                             \
+      std::cerr << "[ASSERT FAILED] " << (msg) << " (" << __FILE__ << ":" << __LINE__ << ")"   \
+                << std::endl;                                                                  \
+      std::exit(1);                                                                            \
+    } else {                                                                                   \
+      SMF_LOGI(std::string("[ASSERT OK   ] ") + (msg));                                        \
+    }                                                                                          \
+  } while (0)
+
+constexpr int kPollers = 4;
+constexpr int kCycles = 2000;
+
+struct PollResult {
+  std::uint64_t polls{0};
+  std::uint64_t allocations{0};
+  bool valid{true};
+  bool monotonic{true};
+};
+
+void Poll(const FiniteStateMachine& sm, const std::atomic_bool& done, PollResult& result) {
+  std::uint64_t start = t_allocations;
+  std::uint64_t last_generation = 0;
+  while (!done.load(std::memory_order_acquire)) {
+    std::uint64_t generation = sm.GetStateGeneration();
+    const State& state = sm.GetCurrentState();
+    result.valid = result.valid && (state == "running" || state == "paused");
+    result.monotonic = result.monotonic && generation >= last_generation;
+    last_generation = generation;
+    ++result.polls;
+  }
+  result.allocations = t_allocations - start;
+}
+
+void TestCurrentState() {
+  StateMachineOptions options;
+  options.execution = ExecutionMode::INLINE;
+  auto sm = StateMachineFactory::CreateStateMachine("CurrentState", options);
+  ASSERT_TRUE(sm->Init("../../test/compiled_transition_test/config") && sm->Start(),
+              "fsm: start");
+  sm->SetConditionValue("turbo", 0);
+
+  std::uint64_t initial = sm->GetStateGeneration();
+  const State& idle = sm->GetCurrentState();
+  ASSERT_TRUE(idle == "idle" && &idle == &sm->GetCurrentState(),
+              "read: the interned name is returned without a copy");
+  sm->HandleEvent(std::make_shared<Event>("start"));
+  ASSERT_TRUE(sm->GetCurrentState() == "running" && sm->GetStateGeneration() == initial + 1,
+              "read: a transition advances the generation by one");
+  sm->HandleEvent(std::make_shared<Event>("resume"));
+  ASSERT_TRUE(sm->GetStateGeneration() == initial + 1,
+              "read: an unhandled event leaves the generation unchanged");
+
+  // 事件线程（本线程）不断在 running 与 paused 之间切换，监控线程同时轮询
+  std::atomic_bool done{false};
+  std::vector<PollResult> results(kPollers);
+  std::vector<std::thread> pollers;
+  for (int i = 0; i < kPollers; ++i) {
+    pollers.emplace_back(Poll, std::cref(*sm), std::cref(done), std::ref(results[i]));
+  }
+  auto pause = std::make_shared<Event>("pause");
+  auto resume = std::make_shared<Event>("resume");
+  for (int i = 0; i < kCycles; ++i) {
+    sm->HandleEvent(pause);
+    sm->HandleEvent(resume);
+  }
+  done.store(true, std::memory_order_release);
+  for (auto& poller : pollers) {
+    poller.join();
+  }
+
+  bool valid = true;
+  bool monotonic = true;
+  std::uint64_t polls = 0;
+  std::uint64_t allocations = 0;
+  for (const auto& result : results) {
+    valid = valid && result.valid;
+    monotonic = monotonic && result.monotonic;
+    polls += result.polls;
+    allocations += result.allocations;
+  }
+  ASSERT_TRUE(sm->GetStateGeneration() == initial + 1 + 2 * kCycles,
+              "poll: every state change counted once");
+  ASSERT_TRUE(polls > 0 && valid, "poll: pollers always observe a valid state (" +
+                                      std::to_string(polls) + " polls)");
+  ASSERT_TRUE(monotonic, "poll: the generation never goes backwards");
+  ASSERT_TRUE(allocations == 0, "poll: polling allocates nothing (" +
+                                    std::to_string(allocations) + " allocations)");
+  sm->Stop();
+}
+
+}  // namespace
+
+int main() {
+  SMF_LOGI("=== Current State Read Unit Test ===");
+
+  TestCurrentState();
+
+  SMF_LOGI("=== All current state read tests passed ===");
+  return 0;
+}
@@ -0,0 +1,90 @@
+/**
+ * @file main.cpp
+ * @brief Unit test for the condition-to-dependent index used on condition updates.
+ * @details Drives an inline state machine and verifies that:
+ *          1) An edge-triggered event fires once when its conditions become satisfied and its
+ *             _RESET event fires once when they stop being satisfied.
+ *          2) A satisfied level-triggered event fires again on updates of its own condition,
+ *             but not on updates of unrelated conditions.
+ *          3) A pending transition ignores updates of conditions it does not reference and
+ *             resumes as soon as the condition it waits for is satisfied.
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @version 1.0.0
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include "logger.h"
+#include "state_machine.h"
+#include "state_machine_factory.h"
+
+using namespace smf;
+
+namespace {
+
+#define ASSERT_TRUE(cond, msg)                                                                 \
+  do {                                                                                         \
+    if (!(cond)) {                                                                             \
+      std::cerr << "[ASSERT FAILED] " << (msg) << " (" << __FILE__ << ":" << __LINE__ << ")"   \
+                << std::endl;                                                                  \
+      std::exit(1);                                                                            \
+    } else {                                                                                   \
+      SMF_LOGI(std::string("[ASSERT OK   ] ") + (msg));                                        \
+    }                                                                                          \
+  } while (0)
+
+}  // namespace
+
+int main() {
+  SMF_LOGI("=== Condition Dependency Index Unit Test ===");
+
+  StateMachineOptions options;
+  options.execution = ExecutionMode::INLINE;
+  auto sm = StateMachineFactory::CreateStateMachine("DependencyIndex", options);
+
+  // 同步执行模式下事件在调用线程上处理，计数可直接读取
+  std::map<std::string, int> fired;
+  sm->SetPreEventCallback([&](const State&, const EventPtr& event) {
+    ++fired[event->GetName()];
+    return true;
+  });
+  ASSERT_TRUE(sm->Init("../../test/dependency_index_test/config") && sm->Start(), "start");
+
+  // 边缘触发：满足时触发一次，保持满足时不再触发
+  sm->SetConditionValue("temp", 95);
+  ASSERT_TRUE(fired["hot"] == 1 && sm->GetCurrentState() == "armed", "edge event fires once");
+  sm->SetConditionValue("temp", 96);
+  ASSERT_TRUE(fired["hot"] == 1, "edge event does not fire again while satisfied");
+
+  // 水平触发：自身条件更新时再次触发，无关条件更新不触发
+  sm->SetConditionValue("humidity", 85);
+  ASSERT_TRUE(fired["wet"] == 1, "level event fires when satisfied");
+  sm->SetConditionValue("humidity", 90);
+  ASSERT_TRUE(fired["wet"] == 2, "level event fires again on its own condition update");
+  sm->SetConditionValue("temp", 97);
+  sm->SetConditionValue("pressure", 1);
+  ASSERT_TRUE(fired["wet"] == 2, "level event ignores unrelated condition updates");
+
+  // 挂起转移只在其引用的条件变化时重新检查
+  sm->HandleEvent(std::make_shared<Event>("check"));
+  ASSERT_TRUE(sm->GetCurrentState() == "armed", "check waits for pressure as a pending transition");
+  sm->SetConditionValue("temp", 98);
+  sm->SetConditionValue("humidity", 91);
+  ASSERT_TRUE(sm->GetCurrentState() == "armed", "unrelated updates leave the transition pending");
+  sm->SetConditionValue("pressure", 5);
+  ASSERT_TRUE(sm->GetCurrentState() == "checked", "pending transition resumes on its condition");
+
+  // 条件不再满足时边缘触发复位事件
+  sm->SetConditionValue("temp", 10);
+  ASSERT_TRUE(fired["hot_RESET"] == 1 && fired["hot"] == 1, "edge reset event fires once");
+  sm->SetConditionValue("temp", 11);
+  ASSERT_TRUE(fired["hot_RESET"] == 1, "edge reset event does not repeat");
+
+  sm->Stop();
+  SMF_LOGI("=== All condition dependency index tests passed ===");
+  return 0;
+}
@@ -0,0 +1,157 @@
+/**
+ * @file main.cpp
+ * @brief Unit test for the internal event pool.
+ * @details Verifies that:
+ *          1) EventPool hands out events with the name and ID of the requested event ID and
+ *             the given matched conditions, and reuses an event once only the pool owns it.
+ *          2) An event still referenced elsewhere is never reused, and at most max_per_event
+ *             events are cached per event ID.
+ *          3) Once warmed up, an inline state machine handles condition updates that fire
+ *             event definitions, their _RESET events and internal events without a single heap
+ *             allocation on the calling thread (counted by a replacement operator new).
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @version 1.0.0
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "event_pool.h"
+#include "logger.h"
+#include "state_machine.h"
+#include "state_machine_factory.h"
+#include "symbol_table.h"
+
+namespace {
+
+thread_local std::uint64_t t_allocations = 0;
+
+void* CountedAlloc(std::size_t size) {
+  ++t_allocations;
+  void* ptr = std::malloc(size == 0 ? 1 : size);
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+}  // namespace
+
+void* operator new(std::size_t size) { return CountedAlloc(size); }
+void* operator new[](std::size_t size) { return CountedAlloc(size); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+using namespace smf;
+
+namespace {
+
+#define ASSERT_TRUE(cond, msg)                                                                 \
+  do {                                                                                         \
+    if (!(cond)) {                                                                             \
+      std::cerr << "[ASSERT FAILED] " << (msg) << " (" << __FILE__ << ":" << __LINE__ << ")"   \
+                << std::endl;                                                                  \
+      std::exit(1);                                                                            \
+    } else {                                                                                   \
+      SMF_LOGI(std::string("[ASSERT OK   ] ") + (msg));                                        \
+    }                                                                                          \
+  } while (0)
+
+constexpr int kWarmupUpdates = 100;
+constexpr int kUpdates = 1000;
+
+void TestPool() {
+  SymbolTable symbols;
+  EventId alarm = symbols.InternEvent("alarm_with_a_long_name");
+  symbols.Freeze();
+  EventPool pool(&symbols, /*max_per_event=*/2);
+  pool.Reserve();
+
+  std::vector<ConditionInfo> two = {{"temperature_sensor", 90, 0}, {"pressure", 3, 20}};
+  EventPtr first = pool.Acquire(alarm, two);
+  ASSERT_TRUE(first->GetName() == "alarm_with_a_long_name" && first->GetId(&symbols) == alarm &&
+                  first->GetMatchedConditions() == two,
+              "pool: event carries name, ID and matched conditions");
+
+  EventPtr second = pool.Acquire(alarm);
+  ASSERT_TRUE(second != first && second->GetMatchedConditions().empty(),
+              "pool: a referenced event is not reused");
+
+  Event* first_raw = first.get();
+  first.reset();
+  std::vector<ConditionInfo> one = {{"humidity", 40, 0}};
+  EventPtr reused = pool.Acquire(alarm, one);
+  ASSERT_TRUE(reused.get() == first_raw && reused->GetMatchedConditions() == one &&
+                  pool.GetReusedCount() == 1,
+              "pool: a released event is reused with overwritten conditions");
+
+  EventPtr third = pool.Acquire(alarm);
+  ASSERT_TRUE(pool.Size() == 2 && pool.GetCreatedCount() == 3,
+              "pool: at most max_per_event events are cached per ID");
+  third.reset();
+  EventPtr uncached = pool.Acquire(alarm);
+  ASSERT_TRUE(pool.Size() == 2 && pool.GetCreatedCount() == 4,
+              "pool: events beyond the cap are allocated and released");
+
+  EventPtr timeout = pool.Acquire(STATE_TIMEOUT_EVENT_ID);
+  ASSERT_TRUE(timeout->GetName() == STATE_TIMEOUT_EVENT &&
+                  timeout->GetId(&symbols) == STATE_TIMEOUT_EVENT_ID,
+              "pool: built-in event IDs are supported");
+}
+
+void TestSteadyStateAllocations() {
+  StateMachineOptions options;
+  options.execution = ExecutionMode::INLINE;
+  auto sm = StateMachineFactory::CreateStateMachine("EventPool", options);
+  std::map<std::string, int> fired;
+  sm->SetPreEventCallback([&](const State&, const EventPtr& event) {
+    ++fired[event->GetName()];
+    return true;
+  });
+  ASSERT_TRUE(sm->Init("../../test/internal_event_test/config") && sm->Start(), "fsm: start");
+  sm->HandleEvent(std::make_shared<Event>("go"));
+  ASSERT_TRUE(sm->GetCurrentState() == "busy", "fsm: busy listens for condition changes");
+
+  // level 在 9 与 1 之间切换：alarm 与 alarm_RESET 交替触发，每次更新都生成内部事件
+  const std::string level = "level";
+  for (int i = 0; i < kWarmupUpdates; ++i) {
+    sm->SetConditionValue(level, i % 2 == 0 ? 9 : 1);
+  }
+  // 计数器的键已在预热阶段插入，计数本身不再分配
+  std::map<std::string, int> before = fired;
+  std::uint64_t start = t_allocations;
+  for (int i = 0; i < kUpdates; ++i) {
+    sm->SetConditionValue(level, i % 2 == 0 ? 9 : 1);
+  }
+  std::uint64_t allocations = t_allocations - start;
+  InternalEventStats stats = sm->GetInternalEventStats();
+  sm->Stop();
+
+  ASSERT_TRUE(fired["alarm"] - before["alarm"] == kUpdates / 2 &&
+                  fired["alarm_RESET"] - before["alarm_RESET"] == kUpdates / 2 &&
+                  fired[INTERNAL_EVENT] - before[INTERNAL_EVENT] >= kUpdates && stats.posted > 0,
+              "fsm: updates fire definitions, resets and internal events");
+  ASSERT_TRUE(sm->GetCurrentState() == "busy", "fsm: no transition taken");
+  ASSERT_TRUE(allocations == 0, "fsm: steady-state event processing allocates nothing (" +
+                                    std::to_string(allocations) + " allocations)");
+}
+
+}  // namespace
+
+int main() {
+  SMF_LOGI("=== Event Pool Unit Test ===");
+
+  TestPool();
+  TestSteadyStateAllocations();
+
+  SMF_LOGI("=== All event pool tests passed ===");
+  return 0;
+}
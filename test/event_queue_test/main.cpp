@@ -0,0 +1,254 @@
+/**
+ * @file main.cpp
+ * @brief Unit test for the event queue implementations.
+ * @details Verifies for both MutexEventQueue and MpscRingEventQueue that:
+ *          1) Events from many concurrent producers, pushed one by one or in batches, are all
+ *             delivered exactly once and in per-producer FIFO order.
+ *          2) Close() wakes a consumer parked in PopAll().
+ *          For MpscRingEventQueue additionally:
+ *          3) A full ring applies backpressure to producers instead of losing events.
+ *          4) A push from the consumer thread into a full ring is dropped and counted
+ *             instead of deadlocking.
+ *          5) A batch larger than the ring is delivered completely and in order.
+ *          Finally, state machines on both queues process a batch from HandleEvents() in order.
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @version 1.0.0
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "components/event_queue.h"
+#include "logger.h"
+#include "state_machine.h"
+#include "state_machine_factory.h"
+
+using namespace smf;
+
+namespace {
+
+#define ASSERT_TRUE(cond, msg)                                                                 \
+  do {                                                                                         \
+    if (!(cond)) {                                                                             \
+      std::cerr << "[ASSERT FAILED] " << (msg) << " (" << __FILE__ << ":" << __LINE__ << ")"   \
+                << std::endl;                                                                  \
+      std::exit(1);                                                                            \
+    } else {                                                                                   \
+      SMF_LOGI(std::string("[ASSERT OK   ] ") + (msg));                                        \
+    }                                                                                          \
+  } while (0)
+
+constexpr int kProducers = 8;
+constexpr int kEventsPerProducer = 20000;
+constexpr int kBatchSize = 100;
+
+// 逐个取出事件的消费者：内部用 PopAll 批量取，再按顺序返回
+class Consumer {
+ public:
+  explicit Consumer(IEventQueue& queue) : queue_(queue) {}
+
+  bool Pop(EventPtr& event) {
+    if (index_ == batch_.size()) {
+      batch_.clear();
+      index_ = 0;
+      if (!queue_.PopAll(batch_)) {
+        return false;
+      }
+    }
+    event = batch_[index_++];
+    return true;
+  }
+
+ private:
+  IEventQueue& queue_;
+  std::vector<EventPtr> batch_;
+  size_t index_{0};
+};
+
+// 事件名编码 "生产者:序号"，用于校验每个生产者的 FIFO 顺序
+void TestManyProducers(const std::string& name, IEventQueue& queue, bool batched) {
+  queue.Open();
+  std::vector<std::thread> producers;
+  for (int p = 0; p < kProducers; ++p) {
+    producers.emplace_back([&queue, p, batched] {
+      std::vector<EventPtr> batch;
+      for (int i = 0; i < kEventsPerProducer; ++i) {
+        auto event = std::make_shared<Event>(std::to_string(p) + ":" + std::to_string(i));
+        if (!batched) {
+          queue.Push(event);
+          continue;
+        }
+        batch.push_back(event);
+        if (batch.size() == kBatchSize || i + 1 == kEventsPerProducer) {
+          queue.PushBatch(batch.data(), batch.size());
+          batch.clear();
+        }
+      }
+    });
+  }
+
+  Consumer consumer(queue);
+  std::vector<int> next(kProducers, 0);
+  bool ordered = true;
+  EventPtr event;
+  for (int received = 0; received < kProducers * kEventsPerProducer; ++received) {
+    if (!consumer.Pop(event)) {
+      ordered = false;
+      break;
+    }
+    const std::string& text = event->GetName();
+    size_t colon = text.find(':');
+    int p = std::stoi(text.substr(0, colon));
+    int i = std::stoi(text.substr(colon + 1));
+    if (next[p] != i) {
+      ordered = false;
+    }
+    next[p] = i + 1;
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+
+  bool complete = true;
+  for (int p = 0; p < kProducers; ++p) {
+    complete = complete && next[p] == kEventsPerProducer;
+  }
+  ASSERT_TRUE(ordered, name + ": per-producer FIFO order preserved");
+  ASSERT_TRUE(complete, name + ": every event delivered exactly once");
+  ASSERT_TRUE(queue.GetDroppedCount() == 0, name + ": no event dropped");
+}
+
+void TestCloseWakesConsumer(const std::string& name, IEventQueue& queue) {
+  queue.Open();
+  std::atomic_bool returned{false};
+  std::thread consumer([&] {
+    std::vector<EventPtr> events;
+    bool popped = queue.PopAll(events);
+    returned = !popped;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  queue.Close();
+  consumer.join();
+  ASSERT_TRUE(returned.load(), name + ": Close() wakes a parked consumer");
+}
+
+void TestBackpressure() {
+  MpscRingEventQueue queue(8);
+  queue.Open();
+  ASSERT_TRUE(queue.Capacity() == 8, "ring: capacity is a power of two");
+
+  // 生产者写入超过容量的事件，消费者延迟启动，生产者应等待而不是丢弃
+  constexpr int kTotal = 64;
+  std::thread producer([&queue] {
+    for (int i = 0; i < kTotal; ++i) {
+      queue.Push(std::make_shared<Event>(std::to_string(i)));
+    }
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  Consumer consumer(queue);
+  bool ordered = true;
+  EventPtr event;
+  for (int i = 0; i < kTotal; ++i) {
+    if (!consumer.Pop(event) || event->GetName() != std::to_string(i)) {
+      ordered = false;
+      break;
+    }
+  }
+  producer.join();
+  ASSERT_TRUE(ordered, "ring: full ring blocks producer, all events delivered in order");
+  ASSERT_TRUE(queue.GetDroppedCount() == 0, "ring: backpressure drops nothing");
+}
+
+void TestConsumerSelfPush() {
+  MpscRingEventQueue queue(4);
+  queue.Open();
+  for (int i = 0; i < 4; ++i) {
+    queue.Push(std::make_shared<Event>("fill"));
+  }
+  // 消费线程取空队列后再向队列投递超过容量的一批事件，多出的部分应丢弃而不是死锁
+  std::vector<EventPtr> events;
+  ASSERT_TRUE(queue.PopAll(events) && events.size() == 4, "ring: consumer drains all events");
+  std::vector<EventPtr> refill(5, std::make_shared<Event>("refill"));
+  ASSERT_TRUE(queue.PushBatch(refill.data(), refill.size()) == 4,
+              "ring: consumer batch fills the freed slots");
+  ASSERT_TRUE(!queue.Push(std::make_shared<Event>("overflow")),
+              "ring: consumer push into full ring is rejected");
+  ASSERT_TRUE(queue.GetDroppedCount() == 2, "ring: dropped events are counted");
+}
+
+void TestBatchLargerThanRing() {
+  MpscRingEventQueue queue(8);
+  queue.Open();
+  constexpr int kTotal = 50;
+  std::vector<EventPtr> batch;
+  for (int i = 0; i < kTotal; ++i) {
+    batch.push_back(std::make_shared<Event>(std::to_string(i)));
+  }
+  size_t pushed = 0;
+  std::thread producer([&] { pushed = queue.PushBatch(batch.data(), batch.size()); });
+  Consumer consumer(queue);
+  bool ordered = true;
+  EventPtr event;
+  for (int i = 0; i < kTotal; ++i) {
+    if (!consumer.Pop(event) || event->GetName() != std::to_string(i)) {
+      ordered = false;
+      break;
+    }
+  }
+  producer.join();
+  ASSERT_TRUE(ordered && pushed == kTotal, "ring: batch larger than the ring delivered in order");
+}
+
+void TestStateMachine(const std::string& name, EventQueueType type) {
+  StateMachineOptions options;
+  options.event_queue = type;
+  options.event_queue_capacity = 64;
+  auto sm = StateMachineFactory::CreateStateMachine(name, options);
+  ASSERT_TRUE(sm->Init("../../test/compiled_transition_test/config"), name + ": init");
+  ASSERT_TRUE(sm->Start(), name + ": start");
+  sm->HandleEvent(std::make_shared<Event>("start"));
+  sm->HandleEvent(std::make_shared<Event>("pause"));
+  sm->HandleEvent(std::make_shared<Event>("resume"));
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  ASSERT_TRUE(sm->GetCurrentState() == "running", name + ": single events processed");
+
+  // 一批事件按顺序处理：running -> paused -> running -> paused
+  std::vector<EventPtr> batch = {std::make_shared<Event>("pause"),
+                                 std::make_shared<Event>("resume"),
+                                 std::make_shared<Event>("pause")};
+  sm->HandleEvents(batch);
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  ASSERT_TRUE(sm->GetCurrentState() == "paused", name + ": batch processed in order");
+  sm->Stop();
+}
+
+}  // namespace
+
+int main() {
+  SMF_LOGI("=== Event Queue Unit Test ===");
+
+  MutexEventQueue mutex_queue;
+  TestManyProducers("mutex", mutex_queue, false);
+  TestManyProducers("mutex batched", mutex_queue, true);
+  TestCloseWakesConsumer("mutex", mutex_queue);
+
+  MpscRingEventQueue ring_queue(256);
+  TestManyProducers("ring", ring_queue, false);
+  TestManyProducers("ring batched", ring_queue, true);
+  TestCloseWakesConsumer("ring", ring_queue);
+
+  TestBackpressure();
+  TestConsumerSelfPush();
+  TestBatchLargerThanRing();
+  TestStateMachine("mutex fsm", EventQueueType::MUTEX);
+  TestStateMachine("lock-free fsm", EventQueueType::LOCK_FREE);
+
+  SMF_LOGI("=== All event queue tests passed ===");
+  return 0;
+}
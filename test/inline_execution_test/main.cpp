@@ -0,0 +1,145 @@
+/**
+ * @file main.cpp
+ * @brief Unit test for the single-threaded inline execution mode.
+ * @details Drives a state machine created with ExecutionMode::INLINE and verifies that:
+ *          1) Start() creates no background threads.
+ *          2) HandleEvent() and SetConditionValue() finish their transitions before returning,
+ *             and every callback runs on the caller's thread.
+ *          3) Duration conditions and state timeouts fire only from Poll(), and
+ *             GetNextDeadline() reports when the next one is due.
+ *          4) An event posted from inside a callback runs after the current event completes
+ *             (run-to-completion), not nested inside it.
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @version 1.0.0
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <dirent.h>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logger.h"
+#include "state_machine.h"
+#include "state_machine_factory.h"
+
+using namespace smf;
+
+namespace {
+
+#define ASSERT_TRUE(cond, msg)                                                                 \
+  do {                                                                                         \
+    if (!(cond)) {                                                                             \
+      std::cerr << "[ASSERT FAILED] " << (msg) << " (" << __FILE__ << ":" << __LINE__ << ")"   \
+                << std::endl;                                                                  \
+      std::exit(1);                                                                            \
+    } else {                                                                                   \
+      SMF_LOGI(std::string("[ASSERT OK   ] ") + (msg));                                        \
+    }                                                                                          \
+  } while (0)
+
+using Clock = std::chrono::steady_clock;
+// 定时器登记在 1 ms tick 的时间轮上，到期时间按 tick 向上取整
+constexpr auto kTick = std::chrono::milliseconds(1);
+
+// 当前进程的线程数（读取 /proc/self/task，不可用时返回 -1）
+int CountThreads() {
+  DIR* dir = opendir("/proc/self/task");
+  if (dir == nullptr) {
+    return -1;
+  }
+  int count = 0;
+  while (struct dirent* entry = readdir(dir)) {
+    if (entry->d_name[0] != '.') {
+      ++count;
+    }
+  }
+  closedir(dir);
+  return count;
+}
+
+void SleepUntil(Clock::time_point deadline) {
+  std::this_thread::sleep_until(deadline + std::chrono::milliseconds(1));
+}
+
+}  // namespace
+
+int main() {
+  SMF_LOGI("=== Inline Execution Mode Unit Test ===");
+
+  StateMachineOptions options;
+  options.execution = ExecutionMode::INLINE;
+  auto sm = StateMachineFactory::CreateStateMachine("InlineExecution", options);
+  ASSERT_TRUE(sm != nullptr, "state machine created");
+
+  const std::thread::id caller = std::this_thread::get_id();
+  bool all_on_caller = true;
+  bool abort_on_heating = false;
+  std::vector<std::string> trace;
+  sm->SetEnterStateCallback([&](const std::vector<State>& states) {
+    all_on_caller = all_on_caller && std::this_thread::get_id() == caller;
+    trace.push_back("enter " + states.back());
+    if (abort_on_heating && states.back() == "heating") {
+      abort_on_heating = false;
+      sm->HandleEvent(std::make_shared<Event>("abort"));
+    }
+    trace.push_back("done " + states.back());
+  });
+  ASSERT_TRUE(sm->Init("../../test/inline_execution_test/config"), "init");
+
+  const int threads_before = CountThreads();
+  ASSERT_TRUE(sm->Start(), "start");
+  ASSERT_TRUE(threads_before < 0 || CountThreads() == threads_before,
+              "start creates no background threads");
+
+  // 事件在调用线程上同步处理，返回时转移已完成
+  sm->HandleEvent(std::make_shared<Event>("start"));
+  ASSERT_TRUE(sm->GetCurrentState() == "heating", "HandleEvent transitions before returning");
+  ASSERT_TRUE(sm->GetNextDeadline() == Clock::time_point::max(), "no timer armed yet");
+
+  // 持续时间条件只登记定时器，到期前 Poll 不触发
+  auto set_time = Clock::now();
+  sm->SetConditionValue("temp", 95);
+  Clock::time_point deadline = sm->GetNextDeadline();
+  ASSERT_TRUE(deadline >= set_time + std::chrono::milliseconds(100) &&
+                  deadline <= Clock::now() + std::chrono::milliseconds(100) + kTick,
+              "duration condition arms a deadline 100 ms out");
+  ASSERT_TRUE(sm->Poll(Clock::now()) == deadline, "Poll before the deadline returns it again");
+  ASSERT_TRUE(sm->GetCurrentState() == "heating", "duration condition not yet satisfied");
+
+  // 到期后 Poll 生成 hot 事件并同步完成转移，下一个到期时间为 ready 的状态超时
+  SleepUntil(deadline);
+  auto poll_time = Clock::now();
+  deadline = sm->Poll(poll_time);
+  ASSERT_TRUE(sm->GetCurrentState() == "ready", "Poll fires the duration condition -> ready");
+  ASSERT_TRUE(deadline >= poll_time + std::chrono::milliseconds(150) &&
+                  deadline <= Clock::now() + std::chrono::milliseconds(150) + kTick,
+              "ready arms its 150 ms state timeout");
+
+  SleepUntil(deadline);
+  deadline = sm->RunUntilIdle();
+  ASSERT_TRUE(sm->GetCurrentState() == "cooldown", "RunUntilIdle fires the state timeout");
+  ASSERT_TRUE(deadline == Clock::time_point::max(), "no timer left after leaving ready");
+
+  // 无事件的条件转移经由内部事件同步处理
+  sm->SetConditionValue("temp", 10);
+  ASSERT_TRUE(sm->GetCurrentState() == "idle", "SetConditionValue transitions before returning");
+
+  // 回调中投递的事件在当前事件处理完后才处理
+  trace.clear();
+  abort_on_heating = true;
+  sm->HandleEvent(std::make_shared<Event>("start"));
+  const std::vector<std::string> expected = {"enter heating", "done heating", "enter idle",
+                                             "done idle"};
+  ASSERT_TRUE(trace == expected, "event posted from a callback runs to completion afterwards");
+  ASSERT_TRUE(sm->GetCurrentState() == "idle", "posted abort event processed before returning");
+
+  ASSERT_TRUE(all_on_caller, "every callback ran on the caller's thread");
+
+  sm->Stop();
+  SMF_LOGI("=== All inline execution tests passed ===");
+  return 0;
+}
@@ -0,0 +1,200 @@
+/**
+ * @file main.cpp
+ * @brief Unit test for internal event coalescing and elision.
+ * @details Verifies that:
+ *          1) A condition change is not turned into an INTERNAL_EVENT while no event is
+ *             waiting and the current state has neither condition-only nor pending transitions.
+ *          2) It is posted as soon as the current state has a condition-only transition or a
+ *             transition is pending, and the pending transition still resumes.
+ *          3) Condition changes made while an INTERNAL_EVENT is queued and nothing was queued
+ *             after it are merged into that event, which then carries one entry per condition
+ *             holding its latest value, however often the condition changed.
+ *          4) A change made after another event was queued gets its own INTERNAL_EVENT, so it
+ *             is processed after that event.
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @version 1.0.0
+ */
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logger.h"
+#include "state_machine.h"
+#include "state_machine_factory.h"
+
+using namespace smf;
+
+namespace {
+
+#define ASSERT_TRUE(cond, msg)                                                                 \
+  do {                                                                                         \
+    if (!(cond)) {                                                                             \
+      std::cerr << "[ASSERT FAILED] " << (msg) << " (" << __FILE__ << ":" << __LINE__ << ")"   \
+                << std::endl;                                                                  \
+      std::exit(1);                                                                            \
+    } else {                                                                                   \
+      SMF_LOGI(std::string("[ASSERT OK   ] ") + (msg));                                        \
+    }                                                                                          \
+  } while (0)
+
+using Clock = std::chrono::steady_clock;
+using std::chrono::milliseconds;
+
+const char* const kConfig = "../../test/internal_event_test/config";
+
+// 记录处理过的内部事件携带的条件；处理 "block" 事件时阻塞事件线程直到 Release()
+struct Recorder {
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool blocked{false};
+  bool released{false};
+  std::vector<std::vector<ConditionInfo>> internal_events;
+
+  void Attach(FiniteStateMachine& sm) {
+    sm.SetPreEventCallback([this](const State&, const EventPtr& event) {
+      std::unique_lock<std::mutex> lock(mutex);
+      if (event->GetName() == INTERNAL_EVENT) {
+        internal_events.push_back(event->GetMatchedConditions());
+      } else if (event->GetName() == "block") {
+        blocked = true;
+        released = false;
+        cv.notify_all();
+        cv.wait(lock, [this] { return released; });
+        blocked = false;
+      }
+      return true;
+    });
+  }
+
+  bool WaitBlocked() {
+    std::unique_lock<std::mutex> lock(mutex);
+    return cv.wait_for(lock, std::chrono::seconds(3), [this] { return blocked; });
+  }
+
+  void Release() {
+    std::lock_guard<std::mutex> lock(mutex);
+    released = true;
+    cv.notify_all();
+  }
+
+  std::vector<std::vector<ConditionInfo>> InternalEvents() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return internal_events;
+  }
+};
+
+template <typename Pred>
+bool WaitFor(Pred pred, milliseconds timeout = milliseconds(3000)) {
+  auto deadline = Clock::now() + timeout;
+  while (!pred()) {
+    if (Clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(milliseconds(5));
+  }
+  return true;
+}
+
+// 条件变化已由条件线程交给事件处理器（投递、合并或省略）的次数
+std::uint64_t Handled(const InternalEventStats& stats) {
+  return stats.posted + stats.coalesced + stats.skipped;
+}
+
+void TestElision() {
+  StateMachineOptions options;
+  options.execution = ExecutionMode::INLINE;
+  auto sm = StateMachineFactory::CreateStateMachine("InternalElision", options);
+  Recorder recorder;
+  recorder.Attach(*sm);
+  ASSERT_TRUE(sm->Init(kConfig) && sm->Start(), "inline: start");
+
+  // idle 没有条件转移，也没有挂起转移
+  sm->SetConditionValue("level", 1);
+  InternalEventStats stats = sm->GetInternalEventStats();
+  ASSERT_TRUE(stats.skipped == 1 && stats.posted == 0 && recorder.InternalEvents().empty(),
+              "inline: change without listeners is elided");
+
+  // 挂起转移等待 load：条件变化需要投递
+  sm->HandleEvent(std::make_shared<Event>("finish"));
+  sm->SetConditionValue("level", 2);
+  stats = sm->GetInternalEventStats();
+  ASSERT_TRUE(stats.posted == 1 && recorder.InternalEvents().size() == 1,
+              "inline: pending transition receives the change");
+  sm->SetConditionValue("load", 7);
+  ASSERT_TRUE(sm->GetCurrentState() == "done", "inline: pending transition resumes");
+
+  // done 没有任何转移
+  sm->SetConditionValue("level", 3);
+  stats = sm->GetInternalEventStats();
+  ASSERT_TRUE(stats.skipped == 2 && stats.posted == 2, "inline: elided again after the transition");
+  sm->Stop();
+}
+
+void TestCoalescing() {
+  auto sm = StateMachineFactory::CreateStateMachine("InternalCoalescing");
+  Recorder recorder;
+  recorder.Attach(*sm);
+  ASSERT_TRUE(sm->Init(kConfig) && sm->Start(), "threaded: start");
+  sm->HandleEvent(std::make_shared<Event>("go"));
+  ASSERT_TRUE(WaitFor([&] { return sm->GetCurrentState() == "busy"; }), "threaded: busy");
+
+  // 事件线程阻塞期间的条件变化合并到同一个内部事件，同一条件多次变化只保留最新值
+  sm->HandleEvent(std::make_shared<Event>("block"));
+  ASSERT_TRUE(recorder.WaitBlocked(), "threaded: event thread blocked");
+  std::uint64_t base = Handled(sm->GetInternalEventStats());
+  sm->SetConditionValue("level", 1);
+  sm->SetConditionValue("load", 2);
+  sm->SetConditionValue("level", 3);
+  sm->SetConditionValue("level", 4);
+  ASSERT_TRUE(WaitFor([&] { return Handled(sm->GetInternalEventStats()) == base + 4; }),
+              "threaded: four changes handled");
+  InternalEventStats stats = sm->GetInternalEventStats();
+  ASSERT_TRUE(stats.coalesced == 3, "threaded: three changes merged into the queued event");
+  recorder.Release();
+  ASSERT_TRUE(WaitFor([&] { return !recorder.InternalEvents().empty(); }),
+              "threaded: internal event processed");
+  std::this_thread::sleep_for(milliseconds(50));
+  std::vector<std::vector<ConditionInfo>> internal_events = recorder.InternalEvents();
+  ASSERT_TRUE(internal_events.size() == 1, "threaded: one internal event for the merged changes");
+  const std::vector<ConditionInfo>& merged = internal_events[0];
+  ASSERT_TRUE(merged.size() == 2 && merged[0].name == "level" && merged[0].value == 4 &&
+                  merged[1].name == "load" && merged[1].value == 2,
+              "threaded: one entry per condition holding its latest value");
+
+  // 其他事件排在内部事件之后时，新的变化不再合并
+  sm->HandleEvent(std::make_shared<Event>("block"));
+  ASSERT_TRUE(recorder.WaitBlocked(), "threaded: event thread blocked again");
+  stats = sm->GetInternalEventStats();
+  sm->SetConditionValue("level", 4);
+  ASSERT_TRUE(WaitFor([&] { return sm->GetInternalEventStats().posted == stats.posted + 1; }),
+              "threaded: change posted");
+  sm->HandleEvent(std::make_shared<Event>("noop"));
+  sm->SetConditionValue("level", 5);
+  ASSERT_TRUE(WaitFor([&] { return sm->GetInternalEventStats().posted == stats.posted + 2; }),
+              "threaded: change after another event is posted separately");
+  ASSERT_TRUE(sm->GetInternalEventStats().coalesced == stats.coalesced,
+              "threaded: nothing merged across another event");
+  recorder.Release();
+  ASSERT_TRUE(WaitFor([&] { return sm->GetCurrentState() == "done"; }),
+              "threaded: condition-only transition fires");
+  sm->Stop();
+}
+
+}  // namespace
+
+int main() {
+  SMF_LOGI("=== Internal Event Coalescing Unit Test ===");
+
+  TestElision();
+  TestCoalescing();
+
+  SMF_LOGI("=== All internal event coalescing tests passed ===");
+  return 0;
+}
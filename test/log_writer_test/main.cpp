@@ -0,0 +1,229 @@
+/**
+ * @file main.cpp
+ * @brief Unit test for the buffered text log writer of Logger.
+ * @details Verifies that:
+ *          1) Without buffering every line logged from several threads reaches the log file
+ *             shortly after it is logged.
+ *          2) With a size threshold and a long interval, lines stay buffered until the threshold
+ *             is reached, and a short interval writes a small number of lines on its own.
+ *          3) Rotation driven by the in-memory file size keeps every line across the current file
+ *             and its backups, and Shutdown writes lines that are still buffered.
+ *          4) Lines built from the cached per-second time prefix keep the text format, and the
+ *             file name of a call site is taken from __FILE__ at compile time.
+ *          5) SMF_LOG records are formatted from their typed arguments on the background thread,
+ *             as text lines or as JSON lines with the format string and the typed arguments.
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @version 1.0.0
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logger.h"
+
+using namespace smf;
+
+namespace {
+
+#define ASSERT_TRUE(cond, msg)                                                                 \
+  do {                                                                                         \
+    if (!(cond)) {                                                                             \
+      std::cerr << "[ASSERT FAILED] " << (msg) << " (" << __FILE__ << ":" << __LINE__ << ")"   \
+                << std::endl;                                                                  \
+      std::exit(1);                                                                            \
+    } else {                                                                                   \
+      std::cout << "[ASSERT OK   ] " << (msg) << std::endl;                                    \
+    }                                                                                          \
+  } while (0)
+
+const std::string kLogFile = "log_writer_test.log";
+
+constexpr bool SameText(const char* a, const char* b) {
+  while (*a != '\0' && *a == *b) {
+    ++a;
+    ++b;
+  }
+  return *a == *b;
+}
+
+static_assert(LogFormatArgCount("a {} b {}") == 2 && LogFormatArgCount("{{}} {}") == 1 &&
+                  LogFormatArgCount("no args") == 0 && LogFormatArgCount("bad {0}") == -1 &&
+                  LogFormatArgCount("bad }") == -1,
+              "SMF_LOG format strings are checked at compile time");
+
+static_assert(SameText(LogFileName("/a/b/logger_user.cpp"), "logger_user.cpp") &&
+                  SameText(LogFileName("c:\\src\\win.cpp"), "win.cpp") &&
+                  SameText(LogFileName("plain.cpp"), "plain.cpp"),
+              "LogFileName is evaluated at compile time");
+
+void RemoveLogFiles() {
+  std::remove(kLogFile.c_str());
+  for (int i = 1; i <= 3; ++i) {
+    std::remove((kLogFile + "." + std::to_string(i)).c_str());
+  }
+}
+
+int CountLines(const std::string& file, const std::string& needle) {
+  std::ifstream in(file);
+  std::string line;
+  int count = 0;
+  while (std::getline(in, line)) {
+    if (line.find(needle) != std::string::npos) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+int CountAllFiles(const std::string& needle) {
+  int count = CountLines(kLogFile, needle);
+  for (int i = 1; i <= 3; ++i) {
+    count += CountLines(kLogFile + "." + std::to_string(i), needle);
+  }
+  return count;
+}
+
+// 等待文件中出现 expected 行，最多等待 timeout_ms 毫秒
+bool WaitForLines(const std::string& needle, int expected, int timeout_ms) {
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+  while (std::chrono::steady_clock::now() < deadline) {
+    if (CountAllFiles(needle) == expected) {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return CountAllFiles(needle) == expected;
+}
+
+void TestUnbuffered() {
+  constexpr int kThreads = 4;
+  constexpr int kLines = 500;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([t] {
+      for (int i = 0; i < kLines; ++i) {
+        SMF_LOGI("unbuffered " + std::to_string(t) + " line " + std::to_string(i));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_TRUE(WaitForLines("] unbuffered ", kThreads * kLines, 2000),
+              "unbuffered: every line written");
+}
+
+void TestLineFormat() {
+  std::ifstream in(kLogFile);
+  std::string line;
+  ASSERT_TRUE(static_cast<bool>(std::getline(in, line)), "format: first line read");
+  const std::regex format(
+      "\\[[0-2][0-9]:[0-5][0-9]:[0-6][0-9]\\.[0-9]{3}\\] \x1b\\[32m\\[INFO\\]  "
+      "\\[main\\.cpp:[0-9]+ - [0-9]+\\] unbuffered [0-9]+ line [0-9]+\x1b\\[0m");
+  ASSERT_TRUE(std::regex_match(line, format), "format: line matches the text format: " + line);
+}
+
+void TestBuffered() {
+  SMF_LOGGER_SET_BUFFERING(64 * 1024, 60 * 1000);
+  for (int i = 0; i < 10; ++i) {
+    SMF_LOGI("small batch line " + std::to_string(i));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  ASSERT_TRUE(CountAllFiles("] small batch line ") == 0, "buffered: lines below threshold held");
+
+  // 超过 64KB 后整个缓冲区（包括之前的 10 行）写入
+  const std::string padding(200, 'p');
+  for (int i = 0; i < 400; ++i) {
+    SMF_LOGI("large batch line " + std::to_string(i) + " " + padding);
+  }
+  ASSERT_TRUE(WaitForLines("] small batch line ", 10, 2000), "buffered: size threshold writes");
+
+  SMF_LOGGER_SET_BUFFERING(0, 50);
+  SMF_LOGI("interval line");
+  ASSERT_TRUE(WaitForLines("] interval line", 1, 2000), "buffered: interval writes");
+}
+
+enum class Color { RED = 3 };
+
+void TestStructured() {
+  const std::string name = "cond";
+  SMF_LOG(LogLevel::INFO, "structured {} {} {} {} {} {} {} {{}}", 42, -7, 2.5, true, 'x', name,
+          Color::RED);
+  SMF_LOG(LogLevel::DEBUG, "filtered structured {}", name);
+  ASSERT_TRUE(WaitForLines("] structured 42 -7 2.5 true x cond 3 {}", 1, 2000),
+              "structured: text line formatted from typed arguments");
+  ASSERT_TRUE(CountAllFiles("filtered structured") == 0, "structured: filtered level not written");
+
+  Logger::GetInstance().SetLogFileFormat(LogFileFormat::JSON);
+  SMF_LOG(LogLevel::WARN, "json {} \"{}\" {}", 7u, "say \"hi\"\n", false);
+  SMF_LOGE("json plain message");
+  ASSERT_TRUE(WaitForLines(R"("level":"ERROR")", 1, 2000), "json: lines written");
+  const std::regex json_prefix(
+      R"(\{"time":"[0-9]{4}-[0-9]{2}-[0-9]{2}T[0-9]{2}:[0-9]{2}:[0-9]{2}\.[0-9]{3}",)"
+      R"("level":"WARN","file":"main\.cpp","line":[0-9]+,"thread":"[0-9]+",.*)");
+  const std::string json_fields =
+      R"("message":"json 7 \"say \"hi\"\n\" false","format":"json {} \"{}\" {}",)"
+      R"("args":[7,"say \"hi\"\n",false]})";
+  std::ifstream in(kLogFile);
+  std::string line;
+  bool structured_found = false;
+  bool plain_found = false;
+  while (std::getline(in, line)) {
+    structured_found = structured_found || (std::regex_match(line, json_prefix) &&
+                                            line.find(json_fields) != std::string::npos);
+    plain_found = plain_found || (line.find(R"("level":"ERROR")") != std::string::npos &&
+                                  line.find(R"("message":"json plain message"})") !=
+                                      std::string::npos);
+  }
+  ASSERT_TRUE(structured_found, "json: structured record with format and typed args");
+  ASSERT_TRUE(plain_found, "json: plain message without format and args");
+  Logger::GetInstance().SetLogFileFormat(LogFileFormat::TEXT);
+}
+
+void TestRotationAndShutdown() {
+  SMF_LOGGER_SET_ROLLING(16 * 1024, 3);
+  SMF_LOGGER_SET_BUFFERING(4 * 1024, 20);
+  const std::string padding(100, 'r');
+  for (int i = 0; i < 300; ++i) {
+    SMF_LOGI("rotation line " + std::to_string(i) + " " + padding);
+  }
+  ASSERT_TRUE(WaitForLines("] rotation line ", 300, 2000), "rotation: every line kept");
+  std::ifstream backup(kLogFile + ".1");
+  ASSERT_TRUE(static_cast<bool>(backup), "rotation: backup created");
+
+  SMF_LOGGER_SET_BUFFERING(1024 * 1024, 60 * 1000);
+  for (int i = 0; i < 5; ++i) {
+    SMF_LOGI("shutdown line " + std::to_string(i));
+  }
+  Logger::GetInstance().Shutdown();
+  ASSERT_TRUE(CountAllFiles("] shutdown line ") == 5, "shutdown: buffered lines written");
+}
+
+}  // namespace
+
+int main() {
+  std::cout << "=== Log Writer Unit Test ===" << std::endl;
+  RemoveLogFiles();
+  SMF_LOGGER_INIT(LogLevel::INFO);
+  SMF_LOGGER_SET_ROLLING(0, 0);
+  SMF_LOGGER_SET_FILE(kLogFile);
+
+  TestUnbuffered();
+  TestLineFormat();
+  TestBuffered();
+  TestStructured();
+  TestRotationAndShutdown();
+
+  RemoveLogFiles();
+  std::cout << "=== All log writer tests passed ===" << std::endl;
+  return 0;
+}
@@ -0,0 +1,215 @@
+/**
+ * @file main.cpp
+ * @brief Unit test for the state machine metrics snapshot.
+ * @details Verifies that:
+ *          1) HistogramSnapshot buckets samples with a relative error of at most 1/8 and
+ *             reports count, mean, max and percentiles.
+ *          2) An inline state machine counts enqueued and processed events, the queue depth
+ *             high-water mark, condition updates, transitions, and pending transitions created,
+ *             consumed and expired.
+ *          3) With latency_metrics enabled, every processed event records its enqueue-to-process
+ *             latency and every callback that is set records its duration; events dropped
+ *             because a callback threw are counted.
+ *          4) A threaded state machine without latency_metrics counts events from several
+ *             producers and records no latency samples.
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @version 1.0.0
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logger.h"
+#include "state_machine.h"
+#include "state_machine_factory.h"
+
+using namespace smf;
+
+namespace {
+
+#define ASSERT_TRUE(cond, msg)                                                                 \
+  do {                                                                                         \
+    if (!(cond)) {                                                                             \
+      std::cerr << "[ASSERT FAILED] " << (msg) << " (" << __FILE__ << ":" << __LINE__ << ")"   \
+                << std::endl;                                                                  \
+      std::exit(1);                                                                            \
+    } else {                                                                                   \
+      SMF_LOGI(std::string("[ASSERT OK   ] ") + (msg));                                        \
+    }                                                                                          \
+  } while (0)
+
+constexpr const char* kConfig = "../../test/metrics_test/config";
+constexpr int kProducers = 4;
+constexpr int kEventsPerProducer = 2000;
+
+void TestHistogram() {
+  LatencyHistogram histogram;
+  HistogramSnapshot empty;
+  histogram.Snapshot(empty);
+  ASSERT_TRUE(empty.count == 0 && empty.Percentile(50) == 0 && empty.Mean() == 0.0,
+              "histogram: empty snapshot");
+
+  for (int value = 1; value <= 1000; ++value) {
+    histogram.Record(value);
+  }
+  histogram.Record(-5);
+  HistogramSnapshot snapshot;
+  histogram.Snapshot(snapshot);
+  ASSERT_TRUE(snapshot.count == 1001 && snapshot.max == 1000 && snapshot.sum == 500500,
+              "histogram: count, sum and max (negative samples recorded as 0)");
+  std::uint64_t p50 = snapshot.Percentile(50);
+  std::uint64_t p99 = snapshot.Percentile(99);
+  ASSERT_TRUE(p50 >= 500 && p50 <= 500 + 500 / 8 && p99 >= 990 && p99 <= 1000,
+              "histogram: percentiles within one bucket (p50 " + std::to_string(p50) + ", p99 " +
+                  std::to_string(p99) + ")");
+  ASSERT_TRUE(snapshot.Percentile(100) == 1000, "histogram: p100 is the maximum");
+  for (std::uint64_t value : {0ULL, 7ULL, 8ULL, 1000ULL, 123456789ULL}) {
+    std::size_t index = HistogramSnapshot::BucketIndex(value);
+    std::uint64_t upper = HistogramSnapshot::BucketUpperBound(index);
+    ASSERT_TRUE(upper >= value && upper - value <= value / 8,
+                "histogram: bucket of " + std::to_string(value) + " ends at " +
+                    std::to_string(upper));
+  }
+}
+
+void TestInlineMetrics() {
+  StateMachineOptions options;
+  options.execution = ExecutionMode::INLINE;
+  options.latency_metrics = true;
+  auto sm = StateMachineFactory::CreateStateMachine("MetricsInline", options);
+  sm->SetPreEventCallback([](const State&, const EventPtr& event) {
+    if (event->GetName() == "boom") {
+      throw std::runtime_error("boom");
+    }
+    return true;
+  });
+  // 进入状态的回调耗时至少 1ms，应出现在回调耗时直方图的最大值中
+  sm->SetEnterStateCallback(
+      [](const std::vector<State>&) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); });
+  ASSERT_TRUE(sm->Init(kConfig) && sm->Start(), "inline: start");
+
+  StateMachineMetrics metrics = sm->GetMetrics();
+  ASSERT_TRUE(metrics.events_enqueued == 0 && metrics.events_processed == 0 &&
+                  metrics.transitions == 0 && metrics.queue_latency.count == 0,
+              "inline: a new machine reports zero");
+
+  // temp 未满足：start 创建挂起转移，超时后被清理
+  sm->SetConditionValue("temp", 0);
+  sm->HandleEvent(std::make_shared<Event>("start"));
+  metrics = sm->GetMetrics();
+  ASSERT_TRUE(metrics.pending_transitions.created == 1 && metrics.transitions == 0 &&
+                  sm->GetCurrentState() == "idle",
+              "inline: an unsatisfied rule with a timeout creates a pending transition");
+  std::this_thread::sleep_for(std::chrono::milliseconds(80));
+  sm->RunUntilIdle();
+  metrics = sm->GetMetrics();
+  ASSERT_TRUE(metrics.pending_transitions.expired == 1, "inline: the pending transition expired");
+
+  // 再次挂起，条件满足后由内部事件消费
+  sm->HandleEvent(std::make_shared<Event>("start"));
+  sm->SetConditionValue("temp", 50);
+  sm->HandleEvent(std::make_shared<Event>("stop"));
+  metrics = sm->GetMetrics();
+  ASSERT_TRUE(sm->GetCurrentState() == "idle" && metrics.transitions == 2 &&
+                  metrics.pending_transitions.created == 2 &&
+                  metrics.pending_transitions.expired == 1,
+              "inline: a consumed pending transition counts as a transition, not an expiry");
+  ASSERT_TRUE(metrics.condition_updates == 2, "inline: condition updates counted (" +
+                                                  std::to_string(metrics.condition_updates) + ")");
+  ASSERT_TRUE(metrics.events_enqueued == metrics.events_processed &&
+                  metrics.events_processed >= 4 && metrics.events_dropped == 0 &&
+                  metrics.queue_depth_high_water >= 1,
+              "inline: every enqueued event processed (" +
+                  std::to_string(metrics.events_processed) + ")");
+  ASSERT_TRUE(metrics.internal_events.posted == metrics.events_processed - 3,
+              "inline: internal event statistics are included");
+  ASSERT_TRUE(metrics.queue_latency.count == metrics.events_processed,
+              "latency: one queue latency sample per processed event");
+  // 只设置了 OnPreEvent 与 OnEnterState：每个事件一次、每次转移一次，未设置的回调不计时
+  ASSERT_TRUE(metrics.callback_duration.count ==
+                      metrics.events_processed + metrics.transitions &&
+                  metrics.callback_duration.max >= 1000000,
+              "latency: durations of the callbacks that are set recorded (max " +
+                  std::to_string(metrics.callback_duration.max) + " ns)");
+
+  // OnPreEvent 抛出异常：该事件与同批其后的事件被丢弃
+  std::vector<EventPtr> batch = {std::make_shared<Event>("boom"),
+                                 std::make_shared<Event>("start")};
+  bool thrown = false;
+  try {
+    sm->HandleEvents(batch.data(), batch.size());
+  } catch (const std::runtime_error&) {
+    thrown = true;
+  }
+  StateMachineMetrics after = sm->GetMetrics();
+  ASSERT_TRUE(thrown && after.events_dropped == 2 &&
+                  after.events_enqueued == after.events_processed + after.events_dropped &&
+                  sm->GetCurrentState() == "idle",
+              "inline: events discarded after a callback throws are counted as dropped");
+  sm->Stop();
+}
+
+void TestThreadedMetrics() {
+  auto sm = StateMachineFactory::CreateStateMachine("MetricsThreaded");
+  ASSERT_TRUE(sm->Init(kConfig) && sm->Start(), "threaded: start");
+
+  // 条件更新由条件线程异步应用
+  sm->SetConditionValue("temp", 50);
+  while (sm->GetMetrics().condition_updates < 1) {
+    std::this_thread::yield();
+  }
+  // 各生产者并发投递 stop（在 idle 下不处理）
+  std::vector<std::thread> producers;
+  for (int p = 0; p < kProducers; ++p) {
+    producers.emplace_back([&sm] {
+      auto stop = std::make_shared<Event>("stop");
+      for (int i = 0; i < kEventsPerProducer; ++i) {
+        sm->HandleEvent(stop);
+      }
+    });
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  const int expected = kProducers * kEventsPerProducer;
+  // 处理计数在 OnPostEvent 之后更新，直接等待计数
+  StateMachineMetrics metrics = sm->GetMetrics();
+  while (metrics.events_processed < static_cast<std::uint64_t>(expected)) {
+    std::this_thread::yield();
+    metrics = sm->GetMetrics();
+  }
+  ASSERT_TRUE(metrics.events_enqueued >= static_cast<std::uint64_t>(expected) &&
+                  metrics.events_processed >= static_cast<std::uint64_t>(expected) &&
+                  metrics.events_dropped == 0,
+              "threaded: events from every producer counted (" +
+                  std::to_string(metrics.events_processed) + ")");
+  ASSERT_TRUE(metrics.queue_depth_high_water >= 1 &&
+                  metrics.queue_depth_high_water <= metrics.events_enqueued,
+              "threaded: queue depth high-water mark recorded (" +
+                  std::to_string(metrics.queue_depth_high_water) + ")");
+  ASSERT_TRUE(metrics.condition_updates == 1 && metrics.transitions == 0,
+              "threaded: condition updates and transitions counted");
+  ASSERT_TRUE(metrics.queue_latency.count == 0 && metrics.callback_duration.count == 0,
+              "threaded: no latency samples without latency_metrics");
+  sm->Stop();
+}
+
+}  // namespace
+
+int main() {
+  SMF_LOGI("=== State Machine Metrics Unit Test ===");
+
+  TestHistogram();
+  TestInlineMetrics();
+  TestThreadedMetrics();
+
+  SMF_LOGI("=== All state machine metrics tests passed ===");
+  return 0;
+}
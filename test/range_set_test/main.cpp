@@ -0,0 +1,152 @@
+/**
+ * @file main.cpp
+ * @brief Unit test for sorted range sets and the range-membership kernels.
+ * @details Verifies that:
+ *          1) RangeSet sorts and merges overlapping and adjacent ranges and drops inverted ones,
+ *             including ranges that touch INT_MIN and INT_MAX.
+ *          2) The scalar, vector and binary-search kernels and Condition::IsValueInRange agree
+ *             with a pair-by-pair comparison for random range sets of 0 to 200 ranges.
+ *          3) RangeSetBatch gives the same result as testing each set on its own.
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @version 1.0.0
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common_define.h"
+#include "logger.h"
+#include "range_set.h"
+
+using namespace smf;
+
+namespace {
+
+#define ASSERT_TRUE(cond, msg)                                                                 \
+  do {                                                                                         \
+    if (!(cond)) {                                                                             \
+      std::cerr << "[ASSERT FAILED] " << (msg) << " (" << __FILE__ << ":" << __LINE__ << ")"   \
+                << std::endl;                                                                  \
+      std::exit(1);                                                                            \
+    } else {                                                                                   \
+      SMF_LOGI(std::string("[ASSERT OK   ] ") + (msg));                                        \
+    }                                                                                          \
+  } while (0)
+
+constexpr int kMin = std::numeric_limits<int>::min();
+constexpr int kMax = std::numeric_limits<int>::max();
+constexpr int kSetCount = 400;
+constexpr int kProbesPerSet = 500;
+
+using Ranges = std::vector<std::pair<int, int>>;
+
+// 逐个比较的参考实现
+bool Reference(const Ranges& ranges, int value) {
+  for (const auto& range : ranges) {
+    if (value >= range.first && value <= range.second) {
+      return true;
+    }
+  }
+  return false;
+}
+
+Ranges RandomRanges(std::mt19937& rng, int count) {
+  Ranges ranges;
+  for (int i = 0; i < count; ++i) {
+    int low = static_cast<int>(rng() % 10000);
+    int high = low + static_cast<int>(rng() % 60) - 5;  // 偶尔出现 low > high 的无效范围
+    ranges.emplace_back(low, high);
+  }
+  return ranges;
+}
+
+void TestAssign() {
+  RangeSet set({{30, 40}, {1, 5}, {6, 8}, {3, 4}, {9, 2}, {41, 41}, {50, 60}});
+  ASSERT_TRUE((set.Mins() == std::vector<int>{1, 30, 50}) &&
+                  (set.Maxs() == std::vector<int>{8, 41, 60}),
+              "assign: sorted, merged overlapping and adjacent, dropped inverted");
+
+  RangeSet extremes({{kMin, kMin + 1}, {kMax - 1, kMax}, {0, 0}});
+  ASSERT_TRUE(extremes.Size() == 3 && extremes.Contains(kMin) && extremes.Contains(kMax) &&
+                  !extremes.Contains(kMin + 2) && !extremes.Contains(kMax - 2),
+              "assign: INT_MIN and INT_MAX bounds");
+  RangeSet full({{kMin, -1}, {0, kMax}});
+  ASSERT_TRUE(full.Size() == 1 && full.Contains(kMin) && full.Contains(kMax),
+              "assign: adjacent ranges covering every value merge into one");
+
+  ASSERT_TRUE(RangeSet().Empty() && !RangeSet().Contains(0) && RangeSet({{5, 1}}).Empty(),
+              "assign: empty and all-inverted sets contain nothing");
+}
+
+void TestKernels() {
+  SMF_LOGI(std::string("vector kernel: ") + RangeSet::SimdKernelName());
+  std::mt19937 rng(20261016);
+  int mismatches = 0;
+  int hits = 0;
+  for (int s = 0; s < kSetCount; ++s) {
+    Ranges ranges = RandomRanges(rng, s % 201);
+    RangeSet set(ranges);
+    Condition cond;
+    cond.range_values = ranges;
+    cond.CompileRanges();
+    const int* mins = set.Mins().data();
+    const int* maxs = set.Maxs().data();
+    for (int p = 0; p < kProbesPerSet; ++p) {
+      int value = static_cast<int>(rng() % 10100) - 50;
+      bool want = Reference(ranges, value);
+      hits += want ? 1 : 0;
+      if (set.Contains(value) != want || cond.IsValueInRange(value) != want ||
+          RangeSet::ContainsScalar(mins, maxs, set.Size(), value) != want ||
+          RangeSet::ContainsSimd(mins, maxs, set.Size(), value) != want ||
+          RangeSet::ContainsBinarySearch(mins, maxs, set.Size(), value) != want) {
+        ++mismatches;
+      }
+    }
+  }
+  ASSERT_TRUE(hits > 0 && hits < kSetCount * kProbesPerSet, "kernels: probes hit and miss");
+  ASSERT_TRUE(mismatches == 0, "kernels: every kernel matches the reference (" +
+                                   std::to_string(mismatches) + " mismatches)");
+}
+
+void TestBatch() {
+  std::mt19937 rng(7);
+  std::vector<Ranges> sets;
+  RangeSetBatch batch;
+  bool indexed = true;
+  for (int s = 0; s < 37; ++s) {
+    sets.push_back(RandomRanges(rng, s % 9));
+    indexed = indexed && batch.Add(RangeSet(sets.back())) == static_cast<std::size_t>(s);
+  }
+  ASSERT_TRUE(indexed && batch.Size() == sets.size(), "batch: add returns the set index");
+  std::vector<std::uint8_t> out(batch.Size(), 2);
+  int mismatches = 0;
+  for (int p = 0; p < 5000; ++p) {
+    int value = static_cast<int>(rng() % 10100) - 50;
+    batch.Contains(value, out.data());
+    for (size_t s = 0; s < sets.size(); ++s) {
+      if ((out[s] != 0) != Reference(sets[s], value) || out[s] > 1) {
+        ++mismatches;
+      }
+    }
+  }
+  ASSERT_TRUE(mismatches == 0, "batch: matches testing each set on its own (" +
+                                   std::to_string(mismatches) + " mismatches)");
+}
+
+}  // namespace
+
+int main() {
+  SMF_LOGI("=== Range Set Unit Test ===");
+
+  TestAssign();
+  TestKernels();
+  TestBatch();
+
+  SMF_LOGI("=== All range set tests passed ===");
+  return 0;
+}
@@ -0,0 +1,284 @@
+/**
+ * @file main.cpp
+ * @brief Unit test for the shared executor and the SHARED_POOL execution mode.
+ * @details Verifies that:
+ *          1) Tasks posted to one strand from many threads run one at a time and in
+ *             per-producer order.
+ *          2) A strand blocked in a task does not stall other strands.
+ *          3) PostAt() runs a task after its deadline, and drops it when the strand is gone.
+ *          4) Many state machines created with ExecutionMode::SHARED_POOL share the factory's
+ *             worker threads, keep their events ordered, never run callbacks concurrently,
+ *             and have duration conditions and state timeouts driven by the pool.
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @version 1.0.0
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <dirent.h>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logger.h"
+#include "shared_executor.h"
+#include "state_machine.h"
+#include "state_machine_factory.h"
+
+using namespace smf;
+
+namespace {
+
+#define ASSERT_TRUE(cond, msg)                                                                 \
+  do {                                                                                         \
+    if (!(cond)) {                                                                             \
+      std::cerr << "[ASSERT FAILED] " << (msg) << " (" << __FILE__ << ":" << __LINE__ << ")"   \
+                << std::endl;                                                                  \
+      std::exit(1);                                                                            \
+    } else {                                                                                   \
+      SMF_LOGI(std::string("[ASSERT OK   ] ") + (msg));                                        \
+    }                                                                                          \
+  } while (0)
+
+constexpr size_t kPoolThreads = 4;
+constexpr int kMachines = 64;
+constexpr int kToggles = 10;
+
+// 当前进程的线程数（读取 /proc/self/task，不可用时返回 -1）
+int CountThreads() {
+  DIR* dir = opendir("/proc/self/task");
+  if (dir == nullptr) {
+    return -1;
+  }
+  int count = 0;
+  while (struct dirent* entry = readdir(dir)) {
+    if (entry->d_name[0] != '.') {
+      ++count;
+    }
+  }
+  closedir(dir);
+  return count;
+}
+
+// 在 timeout 内轮询等待 pred 成立
+template <typename Pred>
+bool WaitFor(Pred pred, std::chrono::milliseconds timeout = std::chrono::milliseconds(3000)) {
+  auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (!pred()) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  return true;
+}
+
+void TestStrandOrdering() {
+  constexpr int kProducers = 4;
+  constexpr int kTasksPerProducer = 5000;
+  SharedExecutor executor(kPoolThreads);
+  auto strand = executor.CreateStrand();
+
+  // 任务在 Strand 上串行执行，以下状态只在任务中访问
+  std::vector<int> next(kProducers, 0);
+  bool ordered = true;
+  std::atomic<int> in_flight{0};
+  std::atomic<bool> overlapped{false};
+  std::atomic<int> done{0};
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < kProducers; ++p) {
+    producers.emplace_back([&, p] {
+      for (int i = 0; i < kTasksPerProducer; ++i) {
+        strand->Post([&, p, i] {
+          if (in_flight.fetch_add(1) != 0) {
+            overlapped = true;
+          }
+          ordered = ordered && next[p] == i;
+          next[p] = i + 1;
+          in_flight.fetch_sub(1);
+          done.fetch_add(1, std::memory_order_release);
+        });
+      }
+    });
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  ASSERT_TRUE(WaitFor([&] { return done.load(std::memory_order_acquire) ==
+                                   kProducers * kTasksPerProducer; }),
+              "strand: every posted task ran");
+  ASSERT_TRUE(!overlapped.load(), "strand: tasks never overlap");
+  ASSERT_TRUE(ordered, "strand: per-producer order preserved");
+}
+
+void TestStrandsIndependent() {
+  SharedExecutor executor(2);
+  auto blocked = executor.CreateStrand();
+  auto other = executor.CreateStrand();
+  std::atomic<bool> released{false};
+  std::atomic<bool> finished{false};
+  // blocked 的任务等待 other 的任务放行，只有两个 Strand 互不阻塞时才能完成
+  blocked->Post([&] {
+    while (!released.load()) {
+      std::this_thread::yield();
+    }
+    finished = true;
+  });
+  other->Post([&] { released = true; });
+  ASSERT_TRUE(WaitFor([&] { return finished.load(); }),
+              "executor: a blocked strand does not stall other strands");
+}
+
+void TestPostAt() {
+  SharedExecutor executor(1);
+  auto strand = executor.CreateStrand();
+  std::atomic<bool> fired{false};
+  auto start = std::chrono::steady_clock::now();
+  std::chrono::steady_clock::time_point fired_at;
+  strand->PostAt(start + std::chrono::milliseconds(50), [&] {
+    fired_at = std::chrono::steady_clock::now();
+    fired = true;
+  });
+  ASSERT_TRUE(WaitFor([&] { return fired.load(); }), "timer: PostAt task ran");
+  ASSERT_TRUE(fired_at >= start + std::chrono::milliseconds(50), "timer: not before deadline");
+
+  std::atomic<bool> dropped_fired{false};
+  auto doomed = executor.CreateStrand();
+  doomed->PostAt(std::chrono::steady_clock::now() + std::chrono::milliseconds(20),
+                 [&] { dropped_fired = true; });
+  doomed.reset();
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  ASSERT_TRUE(!dropped_fired.load(), "timer: task of a destroyed strand is dropped");
+}
+
+struct MachineProbe {
+  std::vector<std::string> entered;  // 仅在该状态机的 Strand 上写入
+  std::atomic<size_t> entered_count{0};  // 写入 entered 后发布，供主线程同步读取
+  std::atomic<int> in_callback{0};
+  std::atomic<bool> overlapped{false};
+  std::atomic<bool> on_caller{false};
+};
+
+void TestPooledMachines() {
+  ASSERT_TRUE(StateMachineFactory::SetSharedExecutorThreads(kPoolThreads),
+              "fsm: pool size set before first use");
+  const int threads_before = CountThreads();
+  const std::thread::id caller = std::this_thread::get_id();
+
+  std::vector<std::shared_ptr<FiniteStateMachine>> machines;
+  std::vector<std::unique_ptr<MachineProbe>> probes;
+  StateMachineOptions options;
+  options.execution = ExecutionMode::SHARED_POOL;
+  bool all_started = true;
+  for (int m = 0; m < kMachines; ++m) {
+    const std::string name = "pooled_" + std::to_string(m);
+    auto sm = StateMachineFactory::CreateStateMachine(name, options);
+    auto probe = std::make_unique<MachineProbe>();
+    MachineProbe* p = probe.get();
+    sm->SetEnterStateCallback([p, caller](const std::vector<State>& states) {
+      if (p->in_callback.fetch_add(1) != 0) {
+        p->overlapped = true;
+      }
+      if (std::this_thread::get_id() == caller) {
+        p->on_caller = true;
+      }
+      p->entered.push_back(states.back());
+      p->in_callback.fetch_sub(1);
+      p->entered_count.store(p->entered.size(), std::memory_order_release);
+    });
+    all_started = all_started && sm->Init("../../test/inline_execution_test/config") &&
+                  sm->Start();
+    machines.push_back(sm);
+    probes.push_back(std::move(probe));
+  }
+  ASSERT_TRUE(all_started,
+              "fsm: " + std::to_string(kMachines) + " machines initialized and started");
+  ASSERT_TRUE(StateMachineFactory::GetSharedExecutor()->GetThreadCount() == kPoolThreads,
+              "fsm: pool has the configured size");
+  ASSERT_TRUE(!StateMachineFactory::SetSharedExecutorThreads(8),
+              "fsm: pool size cannot change after creation");
+  const int threads_after = CountThreads();
+  ASSERT_TRUE(threads_before < 0 ||
+                  threads_after - threads_before <= static_cast<int>(kPoolThreads) + 1,
+              "fsm: " + std::to_string(kMachines) + " machines use only the pool threads (" +
+                  std::to_string(threads_after - threads_before) + " new threads)");
+
+  // 每台状态机交替投递 start/abort，最终停在 heating
+  for (int i = 0; i < kToggles; ++i) {
+    for (auto& sm : machines) {
+      sm->HandleEvent(std::make_shared<Event>("start"));
+      sm->HandleEvent(std::make_shared<Event>("abort"));
+    }
+  }
+  for (auto& sm : machines) {
+    sm->HandleEvent(std::make_shared<Event>("start"));
+  }
+  std::vector<std::string> expected;
+  for (int i = 0; i < kToggles; ++i) {
+    expected.push_back("heating");
+    expected.push_back("idle");
+  }
+  expected.push_back("heating");
+  ASSERT_TRUE(WaitFor([&] {
+                for (auto& probe : probes) {
+                  if (probe->entered_count.load(std::memory_order_acquire) < expected.size()) {
+                    return false;
+                  }
+                }
+                return true;
+              }),
+              "fsm: every machine processed its events");
+  bool ordered = true;
+  bool overlapped = false;
+  bool on_caller = false;
+  for (auto& probe : probes) {
+    ordered = ordered && probe->entered == expected;
+    overlapped = overlapped || probe->overlapped.load();
+    on_caller = on_caller || probe->on_caller.load();
+  }
+  ASSERT_TRUE(ordered, "fsm: events of each machine processed in order");
+  ASSERT_TRUE(!overlapped, "fsm: callbacks of one machine never overlap");
+  ASSERT_TRUE(!on_caller, "fsm: callbacks run on pool threads");
+
+  // 持续时间条件与状态超时由线程池的定时线程推进：heating -> ready -> cooldown
+  for (auto& sm : machines) {
+    sm->SetConditionValue("temp", 95);
+  }
+  ASSERT_TRUE(WaitFor([&] {
+                for (auto& sm : machines) {
+                  if (sm->GetCurrentState() != "cooldown") {
+                    return false;
+                  }
+                }
+                return true;
+              }),
+              "fsm: pool timers fire duration conditions and state timeouts");
+
+  for (auto& sm : machines) {
+    sm->Stop();
+  }
+  size_t entered_after_stop = probes.front()->entered_count.load(std::memory_order_acquire);
+  machines.front()->HandleEvent(std::make_shared<Event>("bogus"));
+  machines.front()->SetConditionValue("temp", 10);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  ASSERT_TRUE(probes.front()->entered_count.load(std::memory_order_acquire) == entered_after_stop,
+              "fsm: no transition after Stop()");
+}
+
+}  // namespace
+
+int main() {
+  SMF_LOGI("=== Shared Executor Unit Test ===");
+
+  TestStrandOrdering();
+  TestStrandsIndependent();
+  TestPostAt();
+  TestPooledMachines();
+
+  SMF_LOGI("=== All shared executor tests passed ===");
+  return 0;
+}
@@ -0,0 +1,310 @@
+/**
+ * @file main.cpp
+ * @brief Unit test for the hierarchical timing wheel.
+ * @details Verifies that:
+ *          1) Timers fire in deadline order, timers due on the same tick in scheduling order.
+ *          2) Cancel() stops a timer that has not run yet, including one collected by the same
+ *             Advance() but not yet executed, and fails for a timer that already ran.
+ *          3) Timers far enough out to live in the upper levels, or beyond the wheel's range,
+ *             cascade down and fire on the first Advance() at or after their deadline.
+ *          4) The wheel's own timer thread fires timers without an external driver.
+ *          5) Re-setting a duration condition cancels the stale timer instead of leaving it armed.
+ *          6) THREADED state machines with shared_timer_thread share the factory's wheel and
+ *             still drive duration conditions and state timeouts.
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @version 1.0.0
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <dirent.h>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logger.h"
+#include "state_machine.h"
+#include "state_machine_factory.h"
+#include "timing_wheel.h"
+
+using namespace smf;
+
+namespace {
+
+#define ASSERT_TRUE(cond, msg)                                                                 \
+  do {                                                                                         \
+    if (!(cond)) {                                                                             \
+      std::cerr << "[ASSERT FAILED] " << (msg) << " (" << __FILE__ << ":" << __LINE__ << ")"   \
+                << std::endl;                                                                  \
+      std::exit(1);                                                                            \
+    } else {                                                                                   \
+      SMF_LOGI(std::string("[ASSERT OK   ] ") + (msg));                                        \
+    }                                                                                          \
+  } while (0)
+
+using Clock = TimingWheel::Clock;
+using std::chrono::milliseconds;
+
+constexpr int kMachines = 16;
+
+// 当前进程的线程数（读取 /proc/self/task，不可用时返回 -1）
+int CountThreads() {
+  DIR* dir = opendir("/proc/self/task");
+  if (dir == nullptr) {
+    return -1;
+  }
+  int count = 0;
+  while (struct dirent* entry = readdir(dir)) {
+    if (entry->d_name[0] != '.') {
+      ++count;
+    }
+  }
+  closedir(dir);
+  return count;
+}
+
+// 在 timeout 内轮询等待 pred 成立
+template <typename Pred>
+bool WaitFor(Pred pred, milliseconds timeout = milliseconds(3000)) {
+  auto deadline = Clock::now() + timeout;
+  while (!pred()) {
+    if (Clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(milliseconds(5));
+  }
+  return true;
+}
+
+// 从 first 开始的状态机是否都处于 state
+bool AllIn(const std::vector<std::shared_ptr<FiniteStateMachine>>& machines, size_t first,
+           const std::string& state) {
+  for (size_t m = first; m < machines.size(); ++m) {
+    if (machines[m]->GetCurrentState() != state) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void TestOrdering() {
+  TimingWheel wheel;
+  const Clock::time_point base = Clock::now();
+  std::vector<std::string> fired;
+  wheel.Schedule(base + milliseconds(5), [&] { fired.push_back("5"); });
+  wheel.Schedule(base + milliseconds(3), [&] { fired.push_back("3a"); });
+  wheel.Schedule(base + milliseconds(3), [&] { fired.push_back("3b"); });
+  wheel.Schedule(base + milliseconds(1), [&] { fired.push_back("1"); });
+  wheel.Schedule(base - milliseconds(1), [&] { fired.push_back("past"); });
+  ASSERT_TRUE(wheel.Size() == 5, "order: five timers armed");
+  ASSERT_TRUE(wheel.GetNextDeadline() <= base, "order: an expired timer is due immediately");
+
+  wheel.Advance(base);
+  ASSERT_TRUE(fired == std::vector<std::string>{"past"}, "order: only the expired timer fires");
+  Clock::time_point next = wheel.Advance(base + milliseconds(10));
+  const std::vector<std::string> expected = {"past", "1", "3a", "3b", "5"};
+  ASSERT_TRUE(fired == expected, "order: deadline order, same tick in scheduling order");
+  ASSERT_TRUE(next == Clock::time_point::max() && wheel.Size() == 0, "order: wheel is empty");
+}
+
+void TestCancel() {
+  TimingWheel wheel;
+  const Clock::time_point base = Clock::now();
+  int fired = 0;
+  TimingWheel::TimerId kept = wheel.Schedule(base + milliseconds(10), [&] { ++fired; });
+  TimingWheel::TimerId cancelled = wheel.Schedule(base + milliseconds(10), [&] { fired += 100; });
+  ASSERT_TRUE(wheel.Cancel(cancelled), "cancel: armed timer cancelled");
+  ASSERT_TRUE(!wheel.Cancel(cancelled), "cancel: second cancel fails");
+  ASSERT_TRUE(wheel.Size() == 1, "cancel: cancelled timer leaves the wheel");
+  wheel.Advance(base + milliseconds(20));
+  ASSERT_TRUE(fired == 1, "cancel: only the kept timer fired");
+  ASSERT_TRUE(!wheel.Cancel(kept), "cancel: a timer that already ran cannot be cancelled");
+  ASSERT_TRUE(!wheel.Cancel(TimingWheel::INVALID_TIMER_ID), "cancel: invalid id rejected");
+
+  // 同一次推进收集到的定时器，前一个回调撤销后一个，后一个不再执行
+  TimingWheel::TimerId second = TimingWheel::INVALID_TIMER_ID;
+  bool second_cancelled = false;
+  wheel.Schedule(base + milliseconds(30), [&] { second_cancelled = wheel.Cancel(second); });
+  second = wheel.Schedule(base + milliseconds(31), [&] { fired += 100; });
+  wheel.Advance(base + milliseconds(40));
+  ASSERT_TRUE(second_cancelled && fired == 1,
+              "cancel: a callback cancels a timer collected by the same advance");
+
+  // 节点复用后旧 ID 失效，不会撤销新定时器
+  TimingWheel::TimerId reused = wheel.Schedule(base + milliseconds(50), [&] { ++fired; });
+  ASSERT_TRUE(!wheel.Cancel(second), "cancel: stale id does not cancel a reused node");
+  wheel.Advance(base + milliseconds(60));
+  ASSERT_TRUE(fired == 2 && !wheel.Cancel(reused), "cancel: reused node fires normally");
+}
+
+void TestCascade() {
+  TimingWheel wheel;
+  const Clock::time_point base = Clock::now();
+  // 覆盖第 0~3 层与超出范围的定时器，以及随机分布的定时器
+  std::vector<milliseconds> offsets = {milliseconds(1),      milliseconds(63),
+                                       milliseconds(64),     milliseconds(70),
+                                       milliseconds(4095),   milliseconds(4096),
+                                       milliseconds(5000),   milliseconds(262143),
+                                       milliseconds(262144), milliseconds(300000),
+                                       milliseconds(16777216), milliseconds(18000000)};
+  std::mt19937 rng(20261016);
+  std::uniform_int_distribution<int> random_offset(0, 20000000);
+  for (int i = 0; i < 2000; ++i) {
+    offsets.emplace_back(random_offset(rng));
+  }
+
+  std::vector<Clock::time_point> fired_at(offsets.size());
+  Clock::time_point now = base;
+  for (size_t i = 0; i < offsets.size(); ++i) {
+    wheel.Schedule(base + offsets[i], [&fired_at, &now, i] { fired_at[i] = now; });
+  }
+  ASSERT_TRUE(wheel.Size() == offsets.size(), "cascade: every timer armed");
+
+  // 以不规则步长推进约 5.6 小时，记录每个定时器在哪一次推进中触发
+  std::uniform_int_distribution<int> random_step(1, 3000);
+  Clock::time_point previous = base;
+  bool next_deadline_ok = true;
+  while (wheel.Size() > 0 && now < base + milliseconds(20000000)) {
+    previous = now;
+    now += milliseconds(random_step(rng));
+    Clock::time_point next = wheel.Advance(now);
+    next_deadline_ok = next_deadline_ok && next > now && next == wheel.GetNextDeadline();
+    for (size_t i = 0; i < offsets.size(); ++i) {
+      // 到期时间按 tick 向上取整，超过到期时间一个 tick 后的第一次推进必须触发
+      if (fired_at[i] == now && base + offsets[i] + milliseconds(1) <= previous) {
+        next_deadline_ok = false;
+      }
+    }
+  }
+  bool all_fired = true;
+  bool on_time = true;
+  for (size_t i = 0; i < offsets.size(); ++i) {
+    all_fired = all_fired && fired_at[i] != Clock::time_point();
+    on_time = on_time && fired_at[i] >= base + offsets[i];
+  }
+  ASSERT_TRUE(all_fired && wheel.Size() == 0, "cascade: every timer fired");
+  ASSERT_TRUE(on_time, "cascade: no timer fired before its deadline");
+  ASSERT_TRUE(next_deadline_ok, "cascade: each timer fired on the first advance past its deadline");
+}
+
+void TestTimerThread() {
+  TimingWheel wheel;
+  wheel.Start();
+  ASSERT_TRUE(wheel.IsRunning(), "thread: timer thread started");
+  std::atomic<bool> fired{false};
+  Clock::time_point fired_at;
+  const Clock::time_point deadline = Clock::now() + milliseconds(30);
+  wheel.Schedule(deadline, [&] {
+    fired_at = Clock::now();
+    fired = true;
+  });
+  ASSERT_TRUE(WaitFor([&] { return fired.load(); }), "thread: timer fired without Advance()");
+  ASSERT_TRUE(fired_at >= deadline, "thread: not before the deadline");
+
+  // 回调中登记的更早定时器同样会唤醒定时线程
+  std::atomic<int> chained{0};
+  wheel.Schedule(Clock::now() + milliseconds(500), [&] { chained += 10; });
+  wheel.Schedule(Clock::now() + milliseconds(10), [&] {
+    wheel.Schedule(Clock::now() + milliseconds(10), [&] { ++chained; });
+  });
+  ASSERT_TRUE(WaitFor([&] { return chained.load() == 1; }, milliseconds(400)),
+              "thread: timer scheduled from a callback wakes the thread");
+  wheel.Stop();
+  ASSERT_TRUE(!wheel.IsRunning(), "thread: timer thread stopped");
+}
+
+void TestStaleDurationTimer() {
+  StateMachineOptions options;
+  options.execution = ExecutionMode::INLINE;
+  auto sm = StateMachineFactory::CreateStateMachine("StaleDurationTimer", options);
+  ASSERT_TRUE(sm->Init("../../test/inline_execution_test/config") && sm->Start(), "stale: start");
+  sm->HandleEvent(std::make_shared<Event>("start"));
+
+  // 条件值反复变化时旧的持续时间定时器被撤销，只保留最后一次变化的定时器
+  sm->SetConditionValue("temp", 95);
+  std::this_thread::sleep_for(milliseconds(30));
+  auto reset_time = Clock::now();
+  sm->SetConditionValue("temp", 10);
+  sm->SetConditionValue("temp", 95);
+  ASSERT_TRUE(sm->GetNextDeadline() >= reset_time + milliseconds(100),
+              "stale: next deadline belongs to the latest value change");
+  std::this_thread::sleep_until(reset_time + milliseconds(80));
+  sm->Poll(Clock::now());
+  ASSERT_TRUE(sm->GetCurrentState() == "heating", "stale: cancelled timer never fires");
+  sm->Stop();
+}
+
+void TestSharedWheelMachines() {
+  const int threads_before = CountThreads();
+  std::vector<std::shared_ptr<FiniteStateMachine>> machines;
+  StateMachineOptions options;
+  options.shared_timer_thread = true;
+  bool all_started = true;
+  for (int m = 0; m < kMachines; ++m) {
+    auto sm = StateMachineFactory::CreateStateMachine("shared_wheel_" + std::to_string(m),
+                                                      options);
+    all_started = all_started && sm->Init("../../test/inline_execution_test/config") &&
+                  sm->Start();
+    machines.push_back(sm);
+  }
+  ASSERT_TRUE(all_started, "fsm: machines on the shared wheel started");
+  ASSERT_TRUE(StateMachineFactory::GetSharedTimingWheel()->IsRunning(),
+              "fsm: shared wheel runs its timer thread");
+  const int threads_after = CountThreads();
+  ASSERT_TRUE(threads_before < 0 || threads_after - threads_before <= 2 * kMachines + 1,
+              "fsm: " + std::to_string(kMachines) + " machines share one timer thread (" +
+                  std::to_string(threads_after - threads_before) + " new threads)");
+
+  // 持续时间条件与状态超时由共享时间轮推进：heating -> ready -> cooldown
+  for (auto& sm : machines) {
+    sm->HandleEvent(std::make_shared<Event>("start"));
+  }
+  ASSERT_TRUE(WaitFor([&] { return AllIn(machines, 0, "heating"); }), "fsm: every machine heating");
+  for (auto& sm : machines) {
+    sm->SetConditionValue("temp", 95);
+  }
+  ASSERT_TRUE(WaitFor([&] { return AllIn(machines, 0, "cooldown"); }),
+              "fsm: shared wheel fires duration conditions and state timeouts");
+
+  // 停止一台状态机不影响其他状态机的定时器
+  machines.front()->Stop();
+  ASSERT_TRUE(StateMachineFactory::GetSharedTimingWheel()->IsRunning(),
+              "fsm: stopping one machine keeps the shared wheel running");
+  for (size_t m = 1; m < machines.size(); ++m) {
+    machines[m]->SetConditionValue("temp", 10);
+  }
+  ASSERT_TRUE(WaitFor([&] { return AllIn(machines, 1, "idle"); }), "fsm: remaining machines idle");
+  for (size_t m = 1; m < machines.size(); ++m) {
+    machines[m]->HandleEvent(std::make_shared<Event>("start"));
+  }
+  ASSERT_TRUE(WaitFor([&] { return AllIn(machines, 1, "heating"); }),
+              "fsm: remaining machines heating");
+  for (size_t m = 1; m < machines.size(); ++m) {
+    machines[m]->SetConditionValue("temp", 95);
+  }
+  ASSERT_TRUE(WaitFor([&] { return AllIn(machines, 1, "cooldown"); }),
+              "fsm: remaining machines keep firing timers");
+  for (auto& sm : machines) {
+    sm->Stop();
+  }
+}
+
+}  // namespace
+
+int main() {
+  SMF_LOGI("=== Timing Wheel Unit Test ===");
+
+  TestOrdering();
+  TestCancel();
+  TestCascade();
+  TestTimerThread();
+  TestStaleDurationTimer();
+  TestSharedWheelMachines();
+
+  SMF_LOGI("=== All timing wheel tests passed ===");
+  return 0;
+}
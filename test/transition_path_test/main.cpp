@@ -0,0 +1,147 @@
+/**
+ * @file main.cpp
+ * @brief Unit test for the cached exit/enter paths of state transitions.
+ * @details Verifies that:
+ *          1) GetTransitionPath returns the states to exit (innermost first) and to enter
+ *             (outermost first) below the lowest common ancestor of the two states.
+ *          2) The path of a (from, to) pair is computed once and the same cached object is
+ *             returned afterwards, and adding a state invalidates the cache.
+ *          3) The copying GetStateHierarchy overload still returns the same sequences.
+ *          4) A state machine hands the cached sequences to OnTransition/OnExitState/
+ *             OnEnterState, so repeating a transition passes the same vectors.
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @version 1.0.0
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "components/state_manager.h"
+#include "logger.h"
+#include "state_machine.h"
+#include "state_machine_factory.h"
+#include "symbol_table.h"
+#include "timing_wheel.h"
+
+using namespace smf;
+
+namespace {
+
+#define ASSERT_TRUE(cond, msg)                                                                 \
+  do {                                                                                         \
+    if (!(cond)) {                                                                             \
+      std::cerr << "[ASSERT FAILED] " << (msg) << " (" << __FILE__ << ":" << __LINE__ << ")"   \
+                << std::endl;                                                                  \
+      std::exit(1);                                                                            \
+    } else {                                                                                   \
+      SMF_LOGI(std::string("[ASSERT OK   ] ") + (msg));                                        \
+    }                                                                                          \
+  } while (0)
+
+using States = std::vector<State>;
+
+bool AddState(SymbolTable& symbols, StateManager& manager, const std::string& name,
+              const std::string& parent = "") {
+  StateInfo info;
+  info.name = name;
+  info.parent = parent;
+  info.id = symbols.InternState(name);
+  if (!parent.empty()) {
+    info.parent_id = symbols.FindState(parent);
+  }
+  return manager.AddStateInfo(info);
+}
+
+void TestStateManager() {
+  SymbolTable symbols;
+  TimingWheel timers;
+  StateManager manager(&symbols, &timers);
+  // ROOT ─┬─ A ── A1 ── A1a
+  //       └─ B ── B2
+  bool added = AddState(symbols, manager, "ROOT") && AddState(symbols, manager, "A", "ROOT") &&
+               AddState(symbols, manager, "A1", "A") && AddState(symbols, manager, "A1a", "A1") &&
+               AddState(symbols, manager, "B", "ROOT") && AddState(symbols, manager, "B2", "B");
+  ASSERT_TRUE(added, "manager: state tree built");
+  auto id = [&](const std::string& name) { return symbols.FindState(name); };
+
+  const TransitionPath& cross = manager.GetTransitionPath(id("A1a"), id("B2"));
+  ASSERT_TRUE(cross.exit_states == States({"A1a", "A1", "A"}) &&
+                  cross.enter_states == States({"B", "B2"}),
+              "path: exit innermost first, enter outermost first below the common ancestor");
+  const TransitionPath& down = manager.GetTransitionPath(id("A"), id("A1a"));
+  ASSERT_TRUE(down.exit_states.empty() && down.enter_states == States({"A1", "A1a"}),
+              "path: entering a descendant exits nothing");
+  const TransitionPath& up = manager.GetTransitionPath(id("A1a"), id("A"));
+  ASSERT_TRUE(up.exit_states == States({"A1a", "A1"}) && up.enter_states.empty(),
+              "path: returning to an ancestor enters nothing");
+  const TransitionPath& self = manager.GetTransitionPath(id("B2"), id("B2"));
+  ASSERT_TRUE(self.exit_states.empty() && self.enter_states.empty(),
+              "path: a self transition exits and enters nothing");
+
+  ASSERT_TRUE(&manager.GetTransitionPath(id("A1a"), id("B2")) == &cross,
+              "cache: the same path object is returned for a repeated pair");
+  States exit_states;
+  States enter_states;
+  manager.GetStateHierarchy(id("A1a"), id("B2"), exit_states, enter_states);
+  ASSERT_TRUE(exit_states == cross.exit_states && enter_states == cross.enter_states,
+              "cache: copying overload returns the same sequences");
+
+  ASSERT_TRUE(AddState(symbols, manager, "B3", "B"), "cache: state added while stopped");
+  const TransitionPath& after = manager.GetTransitionPath(id("A1a"), id("B3"));
+  ASSERT_TRUE(after.exit_states == States({"A1a", "A1", "A"}) &&
+                  after.enter_states == States({"B", "B3"}),
+              "cache: paths to a new state are computed after invalidation");
+}
+
+struct Recorder {
+  std::vector<const States*> exits;
+  std::vector<const States*> enters;
+  std::vector<States> entered;
+
+  void Attach(FiniteStateMachine& sm) {
+    sm.SetExitStateCallback([this](const States& states) { exits.push_back(&states); });
+    sm.SetEnterStateCallback([this](const States& states) {
+      enters.push_back(&states);
+      entered.push_back(states);
+    });
+  }
+};
+
+void TestStateMachine() {
+  StateMachineOptions options;
+  options.execution = ExecutionMode::INLINE;
+  auto sm = StateMachineFactory::CreateStateMachine("TransitionPath", options);
+  Recorder recorder;
+  recorder.Attach(*sm);
+  ASSERT_TRUE(sm->Init("../../test/compiled_transition_test/config") && sm->Start(),
+              "fsm: start");
+  sm->SetConditionValue("turbo", 0);
+
+  // idle -> running -> paused -> running -> paused
+  for (const char* event : {"start", "pause", "resume", "pause"}) {
+    sm->HandleEvent(std::make_shared<Event>(event));
+  }
+  ASSERT_TRUE(sm->GetCurrentState() == "paused" && recorder.entered.size() == 4,
+              "fsm: four transitions taken");
+  ASSERT_TRUE(recorder.entered[0] == States({"active", "running"}) &&
+                  recorder.entered[1] == States({"paused"}),
+              "fsm: enter sequences stop at the common ancestor");
+  ASSERT_TRUE(recorder.exits[1] == recorder.exits[3] && recorder.enters[1] == recorder.enters[3],
+              "fsm: a repeated transition receives the same cached sequences");
+  sm->Stop();
+}
+
+}  // namespace
+
+int main() {
+  SMF_LOGI("=== Transition Path Cache Unit Test ===");
+
+  TestStateManager();
+  TestStateMachine();
+
+  SMF_LOGI("=== All transition path cache tests passed ===");
+  return 0;
+}
@@ -0,0 +1,42 @@
+/**
+ * @file main.cpp
+ * @brief Offline decoder for binary log files.
+ * @details Renders log files written in LogMode::BINARY as text, in the same format as the text
+ *          mode without colour codes, or as JSON lines with --json.
+ *          Usage: smf_log_decode [--json] <file> [<file> ...]; rotated files
+ *          (<file>.1, <file>.2, ...) are complete logs of their own and can be decoded in any
+ *          order.
+ * @author xiaokui.hu
+ * @date 2026-10-16
+ * @version 1.0.0
+ */
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "binary_log.h"
+
+int main(int argc, char* argv[]) {
+  bool json = argc > 1 && std::strcmp(argv[1], "--json") == 0;
+  int first = json ? 2 : 1;
+  if (argc <= first) {
+    std::cerr << "Usage: " << argv[0] << " [--json] <binary log file> [<binary log file> ...]"
+              << std::endl;
+    return 2;
+  }
+  int result = 0;
+  for (int i = first; i < argc; ++i) {
+    std::ifstream in(argv[i], std::ios::binary);
+    if (!in) {
+      std::cerr << "Cannot open " << argv[i] << std::endl;
+      result = 1;
+      continue;
+    }
+    if (!smf::DecodeBinaryLog(in, std::cout, json)) {
+      std::cerr << "Invalid binary log data in " << argv[i] << std::endl;
+      result = 1;
+    }
+  }
+  return result;
+}